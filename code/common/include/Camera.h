@@ -0,0 +1,276 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2012 - 2015 Christian Berger
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
+
+#include "DerivedImage.h"
+#include "LatencyHistogram.h"
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class wraps a camera and captures its data into a shared memory segment.
+ */
+class Camera {
+   private:
+    /**
+     * "Forbidden" copy constructor. Goal: The compiler should warn
+     * already at compile time for unwanted bugs caused by any misuse
+     * of the copy constructor.
+     *
+     * @param obj Reference to an object of this class.
+     */
+    Camera(const Camera & /*obj*/);
+
+    /**
+     * "Forbidden" assignment operator. Goal: The compiler should warn
+     * already at compile time for unwanted bugs caused by any misuse
+     * of the assignment operator.
+     *
+     * @param obj Reference to an object of this class.
+     * @return Reference to this instance.
+     */
+    Camera &operator=(const Camera & /*obj*/);
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param name Name of the shared memory segment.
+     * @param id Camera identifier.
+     * @param width Expected image width.
+     * @param height Expected image height.
+     * @param bpp Bytes per pixel.
+     */
+    Camera(const std::string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp);
+
+    virtual ~Camera();
+
+    /**
+     * This method replaces the shared memory segment by a ring of segments
+     * named <name>.0 to <name>.<slots - 1> that are written in turn. Thus,
+     * a reader has slots - 1 frame periods to copy a frame before it is
+     * overwritten. One slot keeps the single segment <name>.
+     *
+     * @param slots Number of segments.
+     */
+    void setNumberOfSlots(const uint32_t &slots);
+
+    uint32_t getNumberOfSlots() const;
+
+    /**
+     * This method waits for the next frame and copies it into the next
+     * slot of the shared memory ring.
+     *
+     * @param sampleTimeStamp Time when the frame was received from the driver.
+     * @return true if a new frame was captured.
+     */
+    bool capture(odcore::data::TimeStamp &sampleTimeStamp);
+
+    /**
+     * @return Meta information about the image; its name is the slot's segment.
+     */
+    odcore::data::image::SharedImage getSharedImage() const;
+
+    /**
+     * @return Number of the latest frame, also stored in the slot's trailer.
+     */
+    uint64_t getFrameNumber() const;
+
+    /**
+     * This method selects what capture() produces. Without the raw output,
+     * nothing is copied to the shared memory and a camera that delivers
+     * compressed frames does not need to decode them at all.
+     *
+     * @param raw Copy raw frames into the shared memory.
+     * @param compressed Keep every frame as JPEG; the camera's own bitstream is used if it has one.
+     * @param quality JPEG quality (1 to 100) for frames that need to be encoded.
+     */
+    void setOutputs(const bool &raw, const bool &compressed, const uint32_t &quality);
+
+    /**
+     * This method adds an image that is derived from every captured frame
+     * in the shared memory segment <name>.<derivedName>.
+     *
+     * @param derivedName Name of the derived image, not a number as <name>.<number> is a slot.
+     * @param x Left column of the region of interest.
+     * @param y Top row of the region of interest.
+     * @param roiWidth Width of the region of interest.
+     * @param roiHeight Height of the region of interest.
+     * @param scale Downscaling factor.
+     * @param gray Convert to grayscale.
+     */
+    void addDerivedImage(const std::string &derivedName, const uint32_t &x, const uint32_t &y, const uint32_t &roiWidth, const uint32_t &roiHeight, const uint32_t &scale, const bool &gray);
+
+    /**
+     * @return Meta information about the derived images.
+     */
+    std::vector< odcore::data::image::SharedImage > getDerivedImages() const;
+
+    /**
+     * Points in the life of a frame whose age is measured from the time
+     * when the driver received it: grabbed from the driver, converted into
+     * the output formats, readable in the shared memory with its derived
+     * images, and sent to the conference.
+     */
+    enum LatencyStage {
+        GRABBED = 0,
+        CONVERTED,
+        COPIED,
+        SENT,
+        NUMBER_OF_LATENCY_STAGES
+    };
+
+    /**
+     * This method adds the age of a frame at a point; capture() measures
+     * all points but SENT.
+     *
+     * @param stage Point in the life of the frame.
+     * @param microseconds Age of the frame.
+     */
+    void addLatency(const LatencyStage &stage, const int64_t &microseconds);
+
+    /**
+     * This method summarizes the ages at a point since the last call.
+     *
+     * @param stage Point in the life of the frame.
+     * @return Number of frames, median, 99th percentile, and maximum in microseconds.
+     */
+    LatencyHistogram::Summary getLatency(const LatencyStage &stage);
+
+    bool hasRawOutput() const;
+    bool hasCompressedOutput() const;
+
+    /**
+     * @return false if the latest capture() has only a new compressed frame
+     *         and left the shared memory and the frame number as they are.
+     */
+    bool hasRawFrame() const;
+
+    /**
+     * This method copies the JPEG bitstream of the latest frame.
+     *
+     * @param jpeg Buffer for the bitstream; empty without the compressed output.
+     */
+    void getCompressedFrame(std::string &jpeg) const;
+
+    /**
+     * This method returns the file descriptor that becomes readable when
+     * the camera has a new frame, so that several cameras can be waited for
+     * together; capture() then does not block.
+     *
+     * @param fd File descriptor.
+     * @return true if the camera has one.
+     */
+    virtual bool getFileDescriptor(int32_t &fd) const;
+
+    const std::string getName() const;
+    uint32_t getID() const;
+    uint32_t getWidth() const;
+    uint32_t getHeight() const;
+    uint32_t getBPP() const;
+    uint32_t getSize() const;
+
+   protected:
+    /**
+     * This method is responsible to copy the image from the
+     * specific camera driver to the shared memory.
+     *
+     * @param dest Pointer where to copy the data.
+     * @param size Number of bytes to copy.
+     * @return true if the data was successfully copied; otherwise, dest is
+     *         to be left unchanged as readers keep the frame it holds.
+     */
+    virtual bool copyImageTo(char *dest, const uint32_t &size) = 0;
+
+    /**
+     * This method is responsible to copy the frame as delivered by the
+     * camera if that is JPEG; it is called before copyImageTo.
+     *
+     * @param jpeg Buffer for the JPEG bitstream.
+     * @return true if the camera's own bitstream was copied.
+     */
+    virtual bool copyCompressedImageTo(std::string &jpeg);
+
+    virtual bool captureFrame() = 0;
+
+    virtual bool isValid() const = 0;
+
+    /**
+     * This method is to be called by captureFrame if the driver reports
+     * when it received the frame; otherwise, the frame is as old as the
+     * time when captureFrame returned.
+     *
+     * @param driverTimeStamp Time of the steady (monotonic) clock.
+     */
+    void setDriverTimeStamp(const std::chrono::steady_clock::time_point &driverTimeStamp);
+
+    /**
+     * This method is to be called by captureFrame if only the camera's own
+     * bitstream is new, e.g. while no decoded frame is ready yet; capture()
+     * then passes on the compressed frame without writing a raw frame.
+     */
+    void setCompressedFrameOnly();
+
+   private:
+    odcore::data::image::SharedImage m_sharedImage;
+    std::vector< std::shared_ptr< odcore::wrapper::SharedMemory > > m_sharedMemory;
+    std::vector< std::unique_ptr< SeqLock > > m_seqLocks; // Readers never block capturing.
+    uint64_t m_frameNumber;
+    bool m_rawOutput;
+    bool m_compressedOutput;
+    std::vector< int32_t > m_encoderParameters;
+    std::vector< char > m_frame; // Raw frame if the shared memory is not written.
+    std::vector< unsigned char > m_encoded;
+    std::string m_compressedFrame;
+    std::vector< std::unique_ptr< DerivedImage > > m_derivedImages;
+    std::chrono::steady_clock::time_point m_driverTimeStamp;
+    bool m_hasDriverTimeStamp;
+    bool m_hasRawFrame;
+    LatencyHistogram m_latencies[NUMBER_OF_LATENCY_STAGES];
+
+   private:
+    bool encode(const char *frame);
+
+   protected:
+    std::string m_name;
+    uint32_t m_id;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_bpp;
+    uint32_t m_size;
+};
+}
+} // opendlv::core
+
+#endif /*CAMERA_H*/
@@ -0,0 +1,119 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CAPTURETHREAD_H
+#define CAPTURETHREAD_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+
+#include "Camera.h"
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class captures frames from a camera on its own thread, driven by
+ * frame arrival, so that capturing is independent of the module frequency.
+ *
+ * The module publishes the newest frame with its capture time stamp. A
+ * frame that is overwritten by a newer one before it is published counts as
+ * dropped; a module cycle without a new frame counts as duplicate, as the
+ * module would have published the previous frame again.
+ */
+class CaptureThread {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param camera Camera to capture from; must outlive this object.
+     */
+    CaptureThread(Camera &camera);
+    CaptureThread(CaptureThread const &) = delete;
+    CaptureThread &operator=(CaptureThread const &) = delete;
+    virtual ~CaptureThread();
+
+    void start();
+    void stop();
+
+    /**
+     * This method returns the newest frame if it was not returned before.
+     *
+     * @param si Meta information about the image.
+     * @param sampleTimeStamp Time when the frame was captured.
+     * @return true if there is a new frame.
+     */
+    bool getNewestFrame(odcore::data::image::SharedImage &si, odcore::data::TimeStamp &sampleTimeStamp);
+
+    /**
+     * This method returns the newest frame if it was not returned before.
+     *
+     * @param si Meta information about the image.
+     * @param compressedFrame Buffer swapped with the frame's JPEG bitstream if the camera has the compressed output.
+     * @param sampleTimeStamp Time when the frame was captured.
+     * @return true if there is a new frame.
+     */
+    bool getNewestFrame(odcore::data::image::SharedImage &si, std::string &compressedFrame, odcore::data::TimeStamp &sampleTimeStamp);
+
+    /**
+     * This method returns the newest frame if it was not returned before.
+     *
+     * @param si Meta information about the image.
+     * @param compressedFrame Buffer swapped with the frame's JPEG bitstream if the camera has the compressed output.
+     * @param rawFrame false if only the compressed frame is new and si refers to a previous frame.
+     * @param sampleTimeStamp Time when the frame was captured.
+     * @return true if there is a new frame.
+     */
+    bool getNewestFrame(odcore::data::image::SharedImage &si, std::string &compressedFrame, bool &rawFrame, odcore::data::TimeStamp &sampleTimeStamp);
+
+    uint64_t getCapturedFrames() const;
+    uint64_t getDroppedFrames() const;
+    uint64_t getDuplicateFrames() const;
+
+   private:
+    void run();
+
+   private:
+    Camera &m_camera;
+    std::thread m_thread;
+    std::atomic< bool > m_running;
+
+    std::mutex m_mutex;
+    odcore::data::image::SharedImage m_sharedImage;
+    odcore::data::TimeStamp m_sampleTimeStamp;
+    std::string m_compressedFrame;
+    bool m_rawFrame;
+    uint64_t m_sequence; // Number of the newest frame.
+    uint64_t m_published; // Number of the newest frame returned.
+
+    std::atomic< uint64_t > m_captured;
+    std::atomic< uint64_t > m_dropped;
+    std::atomic< uint64_t > m_duplicates;
+};
+}
+} // opendlv::core
+
+#endif /*CAPTURETHREAD_H*/
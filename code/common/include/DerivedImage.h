@@ -0,0 +1,101 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef DERIVEDIMAGE_H
+#define DERIVEDIMAGE_H
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
+
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class produces an image derived from every captured frame, i.e. a
+ * region of interest that is downscaled by an integer factor and optionally
+ * converted to grayscale, in a shared memory segment of its own. Thus,
+ * consumers that need less than the full frame do not repeat the same work.
+ *
+ * Downscaling averages scale x scale blocks of pixels (cv::INTER_AREA, which
+ * has a vectorized path for integer factors); the region is cropped to a
+ * multiple of the factor for that reason. Conversion to grayscale runs after
+ * downscaling on the fewer pixels.
+ */
+class DerivedImage {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param name Name of the shared memory segment.
+     * @param width Width of the captured frames.
+     * @param height Height of the captured frames.
+     * @param bpp Bytes per pixel of the captured frames: 1 (gray) or 3 (BGR).
+     * @param x Left column of the region of interest.
+     * @param y Top row of the region of interest.
+     * @param roiWidth Width of the region of interest.
+     * @param roiHeight Height of the region of interest.
+     * @param scale Downscaling factor.
+     * @param gray Convert to grayscale.
+     */
+    DerivedImage(const std::string &name, const uint32_t &width, const uint32_t &height, const uint32_t &bpp,
+                 const uint32_t &x, const uint32_t &y, const uint32_t &roiWidth, const uint32_t &roiHeight,
+                 const uint32_t &scale, const bool &gray);
+    DerivedImage(DerivedImage const &) = delete;
+    DerivedImage &operator=(DerivedImage const &) = delete;
+    virtual ~DerivedImage();
+
+    /**
+     * This method derives the image from a captured frame.
+     *
+     * @param frame Captured frame of width * height * bpp bytes.
+     * @param frameNumber Number of the frame, stored in the segment's trailer.
+     * @return true if the image was written to the shared memory.
+     */
+    bool update(const char *frame, const uint64_t &frameNumber);
+
+    /**
+     * @return Meta information about the derived image.
+     */
+    odcore::data::image::SharedImage getSharedImage() const;
+
+   private:
+    uint32_t m_width;
+    uint32_t m_height;
+    int32_t m_type;
+    cv::Rect m_roi;
+    bool m_gray;
+    cv::Size m_size; // Size of the derived image.
+    cv::Mat m_scaled; // Downscaled colour image before the conversion to grayscale.
+    odcore::data::image::SharedImage m_sharedImage;
+    std::shared_ptr< odcore::wrapper::SharedMemory > m_sharedMemory;
+    std::unique_ptr< SeqLock > m_seqLock;
+};
+}
+} // opendlv::core
+
+#endif /*DERIVEDIMAGE_H*/
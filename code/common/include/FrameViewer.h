@@ -0,0 +1,83 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMEVIEWER_H
+#define FRAMEVIEWER_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <opencv2/core/core.hpp>
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class shows frames in a window on its own thread, so that debug
+ * output does not add latency to capturing.
+ *
+ * Offering a frame copies it only if the last copy is at least one period
+ * old and the viewer is not picking up a frame at the same time; otherwise,
+ * the frame is skipped. The window is created by the viewer thread, so no
+ * display is needed unless a viewer exists.
+ */
+class FrameViewer {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param name Name of the window.
+     * @param frequency Maximum number of frames per second to show.
+     */
+    FrameViewer(const std::string &name, const uint32_t &frequency);
+    FrameViewer(FrameViewer const &) = delete;
+    FrameViewer &operator=(FrameViewer const &) = delete;
+    virtual ~FrameViewer();
+
+    /**
+     * This method offers a frame to show; it never waits for the viewer.
+     *
+     * @param image Frame to show.
+     */
+    void offer(const cv::Mat &image);
+
+   private:
+    void run();
+
+   private:
+    std::string m_name;
+    std::chrono::steady_clock::duration m_period;
+    std::chrono::steady_clock::time_point m_lastOffer;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running;
+    bool m_hasFrame;
+    cv::Mat m_frame; // Newest offered frame.
+    std::thread m_thread;
+};
+}
+} // opendlv::core
+
+#endif /*FRAMEVIEWER_H*/
@@ -0,0 +1,77 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <stdint.h>
+
+#include <atomic>
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class counts latencies in logarithmic buckets with eight linear
+ * steps per power of two, so that percentiles are accurate to 12.5 %.
+ *
+ * Adding a latency is wait-free and may happen on any thread, so the
+ * histogram can stay enabled in production. Reading the summary starts a
+ * new window; latencies added meanwhile may fall into either window.
+ */
+class LatencyHistogram {
+   public:
+    struct Summary {
+        uint64_t count;
+        int64_t p50; // Microseconds; upper bound of the bucket.
+        int64_t p99;
+        int64_t max;
+    };
+
+    LatencyHistogram();
+    LatencyHistogram(LatencyHistogram const &) = delete;
+    LatencyHistogram &operator=(LatencyHistogram const &) = delete;
+    virtual ~LatencyHistogram();
+
+    /**
+     * @param microseconds Latency; negative values count as 0.
+     */
+    void add(const int64_t &microseconds);
+
+    /**
+     * This method summarizes the current window and starts a new one.
+     *
+     * @return Number of latencies, median, 99th percentile, and maximum.
+     */
+    Summary getSummaryAndReset();
+
+    static uint32_t toBucket(const uint64_t &microseconds);
+    static int64_t toUpperBound(const uint32_t &bucket);
+
+   public:
+    static const uint32_t NUMBER_OF_BUCKETS = 16 + 8 * 36;
+
+   private:
+    std::atomic< uint64_t > m_buckets[NUMBER_OF_BUCKETS];
+    std::atomic< int64_t > m_max;
+};
+}
+} // opendlv::core
+
+#endif /*LATENCYHISTOGRAM_H*/
@@ -0,0 +1,173 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class implements a sequence lock (seqlock) for a shared memory
+ * segment with one writer, so that readers never block the writer. It is
+ * used for the SharedImage and SharedPointCloud segments of all modules.
+ *
+ * The payload (the pixels of a SharedImage or the points of a
+ * SharedPointCloud) starts at offset 0 of the segment as before, so readers
+ * that are not aware of the seqlock keep working. The segment is extended by
+ * a 64 byte trailer starting at the first 64 byte boundary at or after the
+ * payload size (SharedImage::getSize() or SharedPointCloud::getSize()):
+ *
+ *   offset  0: uint32 magic 0x4C514553 ("SEQL" in little endian)
+ *   offset  4: uint32 version, currently 1
+ *   offset  8: uint64 sequence, odd while the writer updates the payload
+ *   offset 16: uint64 frame number of the payload, 0 if not set by the writer
+ *   offset 24: 40 reserved bytes, zero
+ *
+ * All fields are in host byte order. The writer increments the sequence
+ * before and after updating the payload. A reader loads the sequence
+ * (acquire), skips odd values, copies the payload, and loads the sequence
+ * again after an acquire fence; the copy is consistent if both values are
+ * equal, otherwise the reader retries.
+ *
+ * Writers still hold the interprocess lock of the segment (odcore::base::Lock)
+ * from beginWrite() to endWrite(): readers aware of the seqlock never take
+ * it and are thus not blocked, while readers that only know the interprocess
+ * lock keep getting consistent payloads.
+ */
+class SeqLock {
+   public:
+    static const uint32_t TRAILER_SIZE = 64;
+    static const uint32_t TRAILER_ALIGNMENT = 64;
+
+    static const uint32_t MAGIC_OFFSET = 0;
+    static const uint32_t VERSION_OFFSET = 4;
+    static const uint32_t SEQUENCE_OFFSET = 8;
+    static const uint32_t FRAME_NUMBER_OFFSET = 16;
+
+    static const uint32_t MAGIC = 0x4C514553;
+    static const uint32_t VERSION = 1;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param payloadSize Size of the payload in bytes.
+     */
+    SeqLock(const uint32_t &payloadSize);
+    SeqLock(SeqLock const &) = delete;
+    SeqLock &operator=(SeqLock const &) = delete;
+    virtual ~SeqLock();
+
+    /**
+     * @return Size of a segment holding the payload and the trailer.
+     */
+    uint32_t getSegmentSize() const;
+
+    /**
+     * This method prepares a segment for writing and resets its trailer.
+     *
+     * @param segment Shared memory segment.
+     * @param segmentSize Size of the segment.
+     * @return true if the segment is large enough for the trailer.
+     */
+    bool initialize(char *segment, const uint32_t &segmentSize);
+
+    /**
+     * This method attaches to a segment for reading.
+     *
+     * @param segment Shared memory segment.
+     * @param segmentSize Size of the segment.
+     * @return true if the segment has a valid trailer.
+     */
+    bool attach(char *segment, const uint32_t &segmentSize);
+
+    /**
+     * @return true if this lock is initialized or attached to a segment.
+     */
+    bool isValid() const;
+
+    void beginWrite();
+    void endWrite();
+
+    /**
+     * This method ends a write that left the payload unchanged, e.g. as the
+     * new payload could not be produced; the previous sequence is restored
+     * so that readers keep the previous payload and its frame number.
+     */
+    void abortWrite();
+
+    /**
+     * This method sets the frame number of the payload; it is to be called
+     * between beginWrite() and endWrite().
+     *
+     * @param frameNumber Frame number.
+     */
+    void setFrameNumber(const uint64_t &frameNumber);
+
+    /**
+     * This method copies a consistent payload.
+     *
+     * @param destination Where to copy the payload.
+     * @param size Number of bytes to copy.
+     * @return true if a consistent copy was made.
+     */
+    bool read(char *destination, const uint32_t &size) const;
+
+    /**
+     * This method copies a consistent payload and its frame number.
+     *
+     * @param destination Where to copy the payload.
+     * @param size Number of bytes to copy.
+     * @param frameNumber Frame number of the copied payload.
+     * @return true if a consistent copy was made.
+     */
+    bool read(char *destination, const uint32_t &size, uint64_t &frameNumber) const;
+
+    /**
+     * This method starts reading the payload in place; it waits briefly
+     * while the writer updates the payload.
+     *
+     * @param sequence Sequence to pass to endRead().
+     * @return false if the writer did not finish in time.
+     */
+    bool beginRead(uint64_t &sequence) const;
+
+    /**
+     * This method checks that the payload read in place since beginRead()
+     * was not changed by the writer in the meantime.
+     *
+     * @param sequence Sequence returned by beginRead().
+     * @return true if the payload was consistent.
+     */
+    bool endRead(const uint64_t &sequence) const;
+
+   private:
+    uint32_t m_payloadSize;
+    uint32_t m_trailerOffset;
+    char *m_segment;
+    uint64_t *m_sequence;
+    uint64_t *m_frameNumber;
+};
+}
+} // opendlv::core
+
+#endif /*SEQLOCK_H*/
@@ -0,0 +1,115 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SHAREDIMAGEREADER_H
+#define SHAREDIMAGEREADER_H
+
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
+
+#include <opencv2/core/core.hpp>
+
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class reads the frames of a SharedImage for a module that receives
+ * its containers.
+ *
+ * The shared memory of each name is attached once and only attached again
+ * when the geometry of its image changes; cameras with a ring of segments
+ * thus keep one attachment per segment. A read-only cv::Mat header wraps
+ * the shared memory, so a frame can be processed in place between
+ * beginRead() and endRead(), or copied with copyTo(). Frames of writers
+ * with a sequence lock are checked for consistency without blocking the
+ * writer; otherwise, the shared memory is locked while reading.
+ */
+class SharedImageReader {
+   public:
+    SharedImageReader();
+    SharedImageReader(SharedImageReader const &) = delete;
+    SharedImageReader &operator=(SharedImageReader const &) = delete;
+    virtual ~SharedImageReader();
+
+    /**
+     * This method selects the shared memory of an image, attaching to it
+     * unless it is already attached.
+     *
+     * @param si Meta information about the image.
+     * @return true if the shared memory is valid.
+     */
+    bool attach(const odcore::data::image::SharedImage &si);
+
+    /**
+     * @return Header wrapping the shared memory, empty if not attached; its
+     *         content is only to be read between beginRead() and endRead().
+     */
+    cv::Mat getView() const;
+
+    /**
+     * This method starts reading the frame in place.
+     *
+     * @return false if the frame cannot be read now.
+     */
+    bool beginRead();
+
+    /**
+     * This method ends reading the frame in place.
+     *
+     * @return true if the frame was not changed while reading.
+     */
+    bool endRead();
+
+    /**
+     * This method copies a consistent frame.
+     *
+     * @param image Copy of the frame; it is only allocated if its size or type differ.
+     * @return true if a consistent frame was copied.
+     */
+    bool copyTo(cv::Mat &image);
+
+    uint32_t getNumberOfAttachments() const;
+
+   private:
+    struct Attachment {
+        Attachment();
+
+        uint32_t size;
+        std::shared_ptr< odcore::wrapper::SharedMemory > sharedMemory;
+        std::shared_ptr< SeqLock > seqLock; // Only set if the writer uses one.
+        cv::Mat view;
+    };
+
+    std::map< std::string, Attachment > m_attachments;
+    Attachment *m_current; // Selected by attach().
+    uint64_t m_sequence;
+    uint32_t m_numberOfAttachments;
+};
+}
+} // opendlv::core
+
+#endif /*SHAREDIMAGEREADER_H*/
@@ -0,0 +1,89 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef UNDISTORTIONMAPS_H
+#define UNDISTORTIONMAPS_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+namespace opendlv {
+namespace core {
+
+/**
+ * This class computes the maps for cv::remap that undistort the frames of
+ * a calibrated camera. camera-calibration saves them so that
+ * proxy-camera-axis can load them instead of computing them at startup.
+ *
+ * The file holds a header with the size and types of the maps followed by
+ * their rows in host byte order.
+ */
+class UndistortionMaps {
+   public:
+    /**
+     * This method computes the fixed-point maps used by proxy-camera-axis.
+     *
+     * @param cameraMatrix Camera matrix.
+     * @param distortionCoefficients Distortion coefficients.
+     * @param imageSize Size of the frames.
+     * @param map1 Map of CV_16SC2 coordinates.
+     * @param map2 Map of CV_16UC1 interpolation weights.
+     */
+    static void compute(const cv::Mat &cameraMatrix, const cv::Mat &distortionCoefficients, const cv::Size &imageSize, cv::Mat &map1, cv::Mat &map2);
+
+    /**
+     * This method saves a pair of maps.
+     *
+     * @param filename File such as <camera>-undistortion.maps.
+     * @param map1 First map of cv::remap.
+     * @param map2 Second map of cv::remap.
+     */
+    static void write(const std::string &filename, const cv::Mat &map1, const cv::Mat &map2);
+
+    /**
+     * This method loads a pair of maps saved by write().
+     *
+     * @param filename File such as <camera>-undistortion.maps.
+     * @param map1 First map of cv::remap.
+     * @param map2 Second map of cv::remap.
+     */
+    static void read(const std::string &filename, cv::Mat &map1, cv::Mat &map2);
+
+    /**
+     * This method fits maps to frames that are downscaled after capturing,
+     * e.g. while decoding: maps of the frames' size are used as they are,
+     * maps of the camera's full frames are downscaled.
+     *
+     * @param map1 First map of cv::remap as read().
+     * @param map2 Second map of cv::remap as read().
+     * @param frameSize Size of the downscaled frames.
+     * @param scale Downscaling factor of the frames.
+     * @param fitted1 Map of CV_16SC2 coordinates for the downscaled frames.
+     * @param fitted2 Map of CV_16UC1 interpolation weights for the downscaled frames.
+     * @throws std::invalid_argument if the maps fit neither size.
+     */
+    static void fit(const cv::Mat &map1, const cv::Mat &map2, const cv::Size &frameSize, const uint32_t &scale, cv::Mat &fitted1, cv::Mat &fitted2);
+};
+}
+} // opendlv::core
+
+#endif /*UNDISTORTIONMAPS_H*/
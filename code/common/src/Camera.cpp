@@ -0,0 +1,304 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2012 - 2015 Christian Berger
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <opendavinci/odcore/base/Lock.h>
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
+#include "Camera.h"
+
+namespace opendlv {
+namespace core {
+
+using namespace std;
+
+Camera::Camera(const string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp)
+    : m_sharedImage()
+    , m_sharedMemory()
+    , m_seqLocks()
+    , m_frameNumber(0)
+    , m_rawOutput(true)
+    , m_compressedOutput(false)
+    , m_encoderParameters()
+    , m_frame()
+    , m_encoded()
+    , m_compressedFrame()
+    , m_derivedImages()
+    , m_driverTimeStamp()
+    , m_hasDriverTimeStamp(false)
+    , m_hasRawFrame(false)
+    , m_latencies()
+    , m_name(name)
+    , m_id(id)
+    , m_width(width)
+    , m_height(height)
+    , m_bpp(bpp)
+    , m_size(0) {
+    m_size = width * height * bpp;
+
+    setNumberOfSlots(1);
+
+    m_sharedImage.setSize(m_size);
+    m_sharedImage.setWidth(width);
+    m_sharedImage.setHeight(height);
+    m_sharedImage.setBytesPerPixel(bpp);
+}
+
+Camera::~Camera() {}
+
+void Camera::setNumberOfSlots(const uint32_t &slots) {
+    if (0 == slots) {
+        throw invalid_argument("At least one slot is required for the shared memory");
+    }
+    m_sharedMemory.clear();
+    m_seqLocks.clear();
+    for (uint32_t i = 0; i < slots; i++) {
+        stringstream name;
+        name << m_name;
+        if (slots > 1) {
+            name << "." << i;
+        }
+        // The segment is extended by the trailer of the sequence lock.
+        unique_ptr< SeqLock > seqLock(new SeqLock(m_size));
+        shared_ptr< odcore::wrapper::SharedMemory > sharedMemory = odcore::wrapper::SharedMemoryFactory::createSharedMemory(name.str(), seqLock->getSegmentSize());
+        if (sharedMemory.get() && sharedMemory->isValid()) {
+            seqLock->initialize(static_cast< char * >(sharedMemory->getSharedMemory()), sharedMemory->getSize());
+        }
+        m_sharedMemory.push_back(sharedMemory);
+        m_seqLocks.push_back(std::move(seqLock));
+        if (0 == i) {
+            m_sharedImage.setName(name.str());
+        }
+    }
+}
+
+const string Camera::getName() const {
+    return m_name;
+}
+
+uint32_t Camera::getID() const {
+    return m_id;
+}
+
+uint32_t Camera::getWidth() const {
+    return m_width;
+}
+
+uint32_t Camera::getHeight() const {
+    return m_height;
+}
+
+uint32_t Camera::getBPP() const {
+    return m_bpp;
+}
+
+uint32_t Camera::getNumberOfSlots() const {
+    return static_cast< uint32_t >(m_sharedMemory.size());
+}
+
+uint32_t Camera::getSize() const {
+    return m_size;
+}
+
+bool Camera::capture(odcore::data::TimeStamp &sampleTimeStamp) {
+    bool retVal = false;
+    if (isValid()) {
+        m_hasDriverTimeStamp = false;
+        m_hasRawFrame = true;
+        if (captureFrame()) {
+            const chrono::steady_clock::time_point grabbed = chrono::steady_clock::now();
+            if (!m_hasDriverTimeStamp) {
+                m_driverTimeStamp = grabbed;
+            }
+            // The sample time is when the driver received the frame.
+            const int64_t age = chrono::duration_cast< chrono::microseconds >(grabbed - m_driverTimeStamp).count();
+            const int64_t now = odcore::data::TimeStamp().toMicroseconds() - age;
+            sampleTimeStamp = odcore::data::TimeStamp(static_cast< int32_t >(now / 1000000L), static_cast< int32_t >(now % 1000000L));
+            m_latencies[GRABBED].add(age);
+
+            // Take the camera's own bitstream before copyImageTo may release the frame.
+            bool compressed = m_compressedOutput && copyCompressedImageTo(m_compressedFrame);
+            const char *frame = NULL;
+            retVal = true;
+            if (m_rawOutput && m_hasRawFrame) {
+                retVal = false;
+                const uint32_t slot = static_cast< uint32_t >(m_frameNumber % m_sharedMemory.size());
+                std::shared_ptr< odcore::wrapper::SharedMemory > &sharedMemory = m_sharedMemory[slot];
+                if (sharedMemory.get() && sharedMemory->isValid()) {
+                    SeqLock &seqLock = *m_seqLocks[slot];
+                    odcore::base::Lock l(sharedMemory);
+                    seqLock.beginWrite();
+                    retVal = copyImageTo(static_cast<char*>(sharedMemory->getSharedMemory()), m_size);
+                    if (retVal) {
+                        m_frameNumber++;
+                        seqLock.setFrameNumber(m_frameNumber);
+                        seqLock.endWrite();
+                        m_sharedImage.setName(sharedMemory->getName());
+                        frame = static_cast< const char * >(sharedMemory->getSharedMemory());
+                    } else {
+                        // The slot keeps its frame and is written again next time.
+                        seqLock.abortWrite();
+                    }
+                }
+            } else if (!m_rawOutput) {
+                m_frameNumber++;
+            }
+            if ((frame == NULL) && !m_rawOutput && (!compressed || !m_derivedImages.empty())) {
+                // The frame is needed but not written to the shared memory.
+                m_frame.resize(m_size);
+                if (copyImageTo(m_frame.data(), m_size)) {
+                    frame = m_frame.data();
+                }
+            }
+            if (m_compressedOutput && !compressed) {
+                compressed = encode(frame);
+            }
+            m_latencies[CONVERTED].add(chrono::duration_cast< chrono::microseconds >(chrono::steady_clock::now() - m_driverTimeStamp).count());
+            if (frame != NULL) {
+                for (uint32_t i = 0; i < m_derivedImages.size(); i++) {
+                    m_derivedImages[i]->update(frame, m_frameNumber);
+                }
+            }
+            m_latencies[COPIED].add(chrono::duration_cast< chrono::microseconds >(chrono::steady_clock::now() - m_driverTimeStamp).count());
+            retVal = retVal && (compressed || !m_compressedOutput);
+        }
+    }
+    return retVal;
+}
+
+void Camera::setDriverTimeStamp(const chrono::steady_clock::time_point &driverTimeStamp) {
+    m_driverTimeStamp = driverTimeStamp;
+    m_hasDriverTimeStamp = true;
+}
+
+void Camera::addLatency(const LatencyStage &stage, const int64_t &microseconds) {
+    if (stage < NUMBER_OF_LATENCY_STAGES) {
+        m_latencies[stage].add(microseconds);
+    }
+}
+
+LatencyHistogram::Summary Camera::getLatency(const LatencyStage &stage) {
+    return m_latencies[(stage < NUMBER_OF_LATENCY_STAGES) ? stage : SENT].getSummaryAndReset();
+}
+
+bool Camera::copyCompressedImageTo(string &jpeg) {
+    jpeg.clear();
+    return false;
+}
+
+void Camera::setCompressedFrameOnly() {
+    m_hasRawFrame = false;
+}
+
+bool Camera::getFileDescriptor(int32_t &fd) const {
+    fd = -1;
+    return false;
+}
+
+bool Camera::encode(const char *frame) {
+    if (frame == NULL) {
+        return false;
+    }
+
+    const int32_t width = static_cast< int32_t >(m_width);
+    const int32_t height = static_cast< int32_t >(m_height);
+    cv::Mat image;
+    switch (m_sharedImage.getBytesPerPixel()) {
+        case 1:
+            image = cv::Mat(height, width, CV_8UC1, const_cast< char * >(frame));
+            break;
+        case 2:
+            // YUYV as delivered by V4L2 cameras.
+            cv::cvtColor(cv::Mat(height, width, CV_8UC2, const_cast< char * >(frame)), image, CV_YUV2BGR_YUYV);
+            break;
+        case 3:
+            image = cv::Mat(height, width, CV_8UC3, const_cast< char * >(frame));
+            break;
+        default:
+            return false;
+    }
+    if (!cv::imencode(".jpg", image, m_encoded, m_encoderParameters)) {
+        return false;
+    }
+    m_compressedFrame.assign(m_encoded.begin(), m_encoded.end());
+    return true;
+}
+
+void Camera::addDerivedImage(const string &derivedName, const uint32_t &x, const uint32_t &y, const uint32_t &roiWidth, const uint32_t &roiHeight, const uint32_t &scale, const bool &gray) {
+    // <name>.<digits> is a slot of the ring of segments.
+    if (derivedName.empty() || (derivedName.find_first_not_of("0123456789") == string::npos)) {
+        throw invalid_argument("Invalid derived image name '" + derivedName + "'! Use a name that is not a number");
+    }
+    unique_ptr< DerivedImage > derivedImage(new DerivedImage(m_name + "." + derivedName, m_width, m_height, m_sharedImage.getBytesPerPixel(), x, y, roiWidth, roiHeight, scale, gray));
+    m_derivedImages.push_back(std::move(derivedImage));
+}
+
+vector< odcore::data::image::SharedImage > Camera::getDerivedImages() const {
+    vector< odcore::data::image::SharedImage > derivedImages;
+    for (uint32_t i = 0; i < m_derivedImages.size(); i++) {
+        derivedImages.push_back(m_derivedImages[i]->getSharedImage());
+    }
+    return derivedImages;
+}
+
+void Camera::setOutputs(const bool &raw, const bool &compressed, const uint32_t &quality) {
+    if (!raw && !compressed) {
+        throw invalid_argument("At least one of the raw and the compressed output is required");
+    }
+    if ((quality < 1) || (quality > 100)) {
+        throw invalid_argument("Invalid JPEG quality! Use 1 to 100");
+    }
+    m_rawOutput = raw;
+    m_compressedOutput = compressed;
+    m_encoderParameters.clear();
+    m_encoderParameters.push_back(CV_IMWRITE_JPEG_QUALITY);
+    m_encoderParameters.push_back(static_cast< int32_t >(quality));
+}
+
+bool Camera::hasRawOutput() const {
+    return m_rawOutput;
+}
+
+bool Camera::hasCompressedOutput() const {
+    return m_compressedOutput;
+}
+
+void Camera::getCompressedFrame(string &jpeg) const {
+    jpeg.assign(m_compressedFrame);
+}
+
+odcore::data::image::SharedImage Camera::getSharedImage() const {
+    return m_sharedImage;
+}
+
+uint64_t Camera::getFrameNumber() const {
+    return m_frameNumber;
+}
+
+bool Camera::hasRawFrame() const {
+    return m_hasRawFrame;
+}
+}
+} // opendlv::core
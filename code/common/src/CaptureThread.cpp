@@ -0,0 +1,119 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <chrono>
+
+#include "CaptureThread.h"
+
+namespace opendlv {
+namespace core {
+
+using namespace std;
+
+CaptureThread::CaptureThread(Camera &camera)
+    : m_camera(camera)
+    , m_thread()
+    , m_running(false)
+    , m_mutex()
+    , m_sharedImage()
+    , m_sampleTimeStamp()
+    , m_compressedFrame()
+    , m_rawFrame(false)
+    , m_sequence(0)
+    , m_published(0)
+    , m_captured(0)
+    , m_dropped(0)
+    , m_duplicates(0) {}
+
+CaptureThread::~CaptureThread() {
+    stop();
+}
+
+void CaptureThread::start() {
+    if (!m_running.exchange(true)) {
+        m_thread = thread(&CaptureThread::run, this);
+    }
+}
+
+void CaptureThread::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void CaptureThread::run() {
+    while (m_running.load()) {
+        odcore::data::TimeStamp sampleTimeStamp;
+        if (m_camera.capture(sampleTimeStamp)) {
+            m_captured.fetch_add(1, memory_order_relaxed);
+            lock_guard< mutex > l(m_mutex);
+            m_sharedImage = m_camera.getSharedImage();
+            m_sampleTimeStamp = sampleTimeStamp;
+            m_rawFrame = m_camera.hasRawFrame();
+            if (m_camera.hasCompressedOutput()) {
+                m_camera.getCompressedFrame(m_compressedFrame);
+            }
+            m_sequence++;
+        } else {
+            // Do not spin on a disconnected camera.
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+}
+
+bool CaptureThread::getNewestFrame(odcore::data::image::SharedImage &si, odcore::data::TimeStamp &sampleTimeStamp) {
+    string compressedFrame;
+    return getNewestFrame(si, compressedFrame, sampleTimeStamp);
+}
+
+bool CaptureThread::getNewestFrame(odcore::data::image::SharedImage &si, string &compressedFrame, odcore::data::TimeStamp &sampleTimeStamp) {
+    bool rawFrame = false;
+    return getNewestFrame(si, compressedFrame, rawFrame, sampleTimeStamp);
+}
+
+bool CaptureThread::getNewestFrame(odcore::data::image::SharedImage &si, string &compressedFrame, bool &rawFrame, odcore::data::TimeStamp &sampleTimeStamp) {
+    lock_guard< mutex > l(m_mutex);
+    if (m_sequence == m_published) {
+        m_duplicates.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    m_dropped.fetch_add(m_sequence - m_published - 1, memory_order_relaxed);
+    m_published = m_sequence;
+    si = m_sharedImage;
+    rawFrame = m_rawFrame;
+    sampleTimeStamp = m_sampleTimeStamp;
+    // The capture thread reuses the caller's buffer for the next frame.
+    compressedFrame.swap(m_compressedFrame);
+    return true;
+}
+
+uint64_t CaptureThread::getCapturedFrames() const {
+    return m_captured.load(memory_order_relaxed);
+}
+
+uint64_t CaptureThread::getDroppedFrames() const {
+    return m_dropped.load(memory_order_relaxed);
+}
+
+uint64_t CaptureThread::getDuplicateFrames() const {
+    return m_duplicates.load(memory_order_relaxed);
+}
+}
+} // opendlv::core
@@ -0,0 +1,107 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdexcept>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <opendavinci/odcore/base/Lock.h>
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
+#include "DerivedImage.h"
+
+namespace opendlv {
+namespace core {
+
+using namespace std;
+
+DerivedImage::DerivedImage(const string &name, const uint32_t &width, const uint32_t &height, const uint32_t &bpp,
+                           const uint32_t &x, const uint32_t &y, const uint32_t &roiWidth, const uint32_t &roiHeight,
+                           const uint32_t &scale, const bool &gray)
+    : m_width(width)
+    , m_height(height)
+    , m_type((3 == bpp) ? CV_8UC3 : CV_8UC1)
+    , m_roi()
+    , m_gray(gray && (3 == bpp))
+    , m_size()
+    , m_scaled()
+    , m_sharedImage()
+    , m_sharedMemory()
+    , m_seqLock() {
+    if ((1 != bpp) && (3 != bpp)) {
+        throw invalid_argument("Derived images need frames with 1 or 3 bytes per pixel");
+    }
+    if ((0 == scale) || (0 == roiWidth / scale) || (0 == roiHeight / scale)) {
+        throw invalid_argument("Invalid scale for derived image " + name);
+    }
+    if ((x + roiWidth > width) || (y + roiHeight > height)) {
+        throw invalid_argument("Region of interest of derived image " + name + " exceeds the frame");
+    }
+    m_size = cv::Size(static_cast< int32_t >(roiWidth / scale), static_cast< int32_t >(roiHeight / scale));
+    m_roi = cv::Rect(static_cast< int32_t >(x), static_cast< int32_t >(y), m_size.width * static_cast< int32_t >(scale), m_size.height * static_cast< int32_t >(scale));
+
+    const uint32_t derivedBPP = ((3 == bpp) && !gray) ? 3 : 1;
+    const uint32_t size = static_cast< uint32_t >(m_size.area()) * derivedBPP;
+    m_seqLock.reset(new SeqLock(size));
+    m_sharedMemory = odcore::wrapper::SharedMemoryFactory::createSharedMemory(name, m_seqLock->getSegmentSize());
+    if (m_sharedMemory.get() && m_sharedMemory->isValid()) {
+        m_seqLock->initialize(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+    }
+
+    m_sharedImage.setName(name);
+    m_sharedImage.setSize(size);
+    m_sharedImage.setWidth(static_cast< uint32_t >(m_size.width));
+    m_sharedImage.setHeight(static_cast< uint32_t >(m_size.height));
+    m_sharedImage.setBytesPerPixel(derivedBPP);
+}
+
+DerivedImage::~DerivedImage() {}
+
+bool DerivedImage::update(const char *frame, const uint64_t &frameNumber) {
+    if ((frame == NULL) || !m_sharedMemory.get() || !m_sharedMemory->isValid()) {
+        return false;
+    }
+    const cv::Mat source(static_cast< int32_t >(m_height), static_cast< int32_t >(m_width), m_type, const_cast< char * >(frame));
+    const cv::Mat roi = source(m_roi);
+    cv::Mat destination(m_size, m_gray ? CV_8UC1 : m_type, m_sharedMemory->getSharedMemory());
+
+    odcore::base::Lock l(m_sharedMemory);
+    m_seqLock->beginWrite();
+    m_seqLock->setFrameNumber(frameNumber);
+    if (m_gray) {
+        if (m_size == m_roi.size()) {
+            cv::cvtColor(roi, destination, CV_BGR2GRAY);
+        } else {
+            cv::resize(roi, m_scaled, m_size, 0, 0, cv::INTER_AREA);
+            cv::cvtColor(m_scaled, destination, CV_BGR2GRAY);
+        }
+    } else if (m_size == m_roi.size()) {
+        roi.copyTo(destination);
+    } else {
+        cv::resize(roi, destination, m_size, 0, 0, cv::INTER_AREA);
+    }
+    m_seqLock->endWrite();
+    return true;
+}
+
+odcore::data::image::SharedImage DerivedImage::getSharedImage() const {
+    return m_sharedImage;
+}
+}
+} // opendlv::core
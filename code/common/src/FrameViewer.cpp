@@ -0,0 +1,95 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include "FrameViewer.h"
+
+namespace opendlv {
+namespace core {
+
+using namespace std;
+
+FrameViewer::FrameViewer(const string &name, const uint32_t &frequency)
+    : m_name(name)
+    , m_period(chrono::duration_cast< chrono::steady_clock::duration >(chrono::microseconds(1000000 / ((frequency > 0) ? frequency : 1))))
+    , m_lastOffer()
+    , m_mutex()
+    , m_condition()
+    , m_running(true)
+    , m_hasFrame(false)
+    , m_frame()
+    , m_thread() {
+    m_thread = thread(&FrameViewer::run, this);
+}
+
+FrameViewer::~FrameViewer() {
+    {
+        lock_guard< mutex > l(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    m_thread.join();
+}
+
+void FrameViewer::offer(const cv::Mat &image) {
+    const chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    if (now - m_lastOffer < m_period) {
+        return;
+    }
+    {
+        unique_lock< mutex > l(m_mutex, try_to_lock);
+        if (!l.owns_lock()) {
+            return;
+        }
+        image.copyTo(m_frame);
+        m_hasFrame = true;
+    }
+    m_lastOffer = now;
+    m_condition.notify_one();
+}
+
+void FrameViewer::run() {
+    cv::namedWindow(m_name, cv::WINDOW_AUTOSIZE);
+    cv::Mat shown;
+    while (true) {
+        bool hasFrame = false;
+        {
+            unique_lock< mutex > l(m_mutex);
+            // Wake up regularly to handle the events of the window.
+            m_condition.wait_for(l, m_period, [this] { return !m_running || m_hasFrame; });
+            if (!m_running) {
+                break;
+            }
+            if (m_hasFrame) {
+                // The buffer of the shown frame is reused for the next offer.
+                cv::swap(m_frame, shown);
+                m_hasFrame = false;
+                hasFrame = true;
+            }
+        }
+        if (hasFrame) {
+            cv::imshow(m_name, shown);
+        }
+        cv::waitKey(1);
+    }
+    cv::destroyWindow(m_name);
+}
+}
+} // opendlv::core
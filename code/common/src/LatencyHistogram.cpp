@@ -0,0 +1,99 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "LatencyHistogram.h"
+
+namespace opendlv {
+namespace core {
+
+using namespace std;
+
+const uint32_t LatencyHistogram::NUMBER_OF_BUCKETS;
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets()
+    , m_max(0) {
+    for (uint32_t i = 0; i < NUMBER_OF_BUCKETS; i++) {
+        m_buckets[i].store(0, memory_order_relaxed);
+    }
+}
+
+LatencyHistogram::~LatencyHistogram() {}
+
+uint32_t LatencyHistogram::toBucket(const uint64_t &microseconds) {
+    // 0 to 15 us have a bucket each; above, 2^e to 2^(e + 1) is split into eight buckets.
+    if (microseconds < 16) {
+        return static_cast< uint32_t >(microseconds);
+    }
+    const uint32_t exponent = 63 - static_cast< uint32_t >(__builtin_clzll(microseconds));
+    const uint32_t bucket = 16 + (exponent - 4) * 8 + static_cast< uint32_t >((microseconds >> (exponent - 3)) & 7);
+    return (bucket < NUMBER_OF_BUCKETS) ? bucket : (NUMBER_OF_BUCKETS - 1);
+}
+
+int64_t LatencyHistogram::toUpperBound(const uint32_t &bucket) {
+    if (bucket < 16) {
+        return bucket;
+    }
+    const uint32_t exponent = (bucket - 16) / 8 + 4;
+    const int64_t step = static_cast< int64_t >(1) << (exponent - 3);
+    return (static_cast< int64_t >(1) << exponent) + static_cast< int64_t >((bucket - 16) % 8 + 1) * step - 1;
+}
+
+void LatencyHistogram::add(const int64_t &microseconds) {
+    const int64_t value = (microseconds > 0) ? microseconds : 0;
+    m_buckets[toBucket(static_cast< uint64_t >(value))].fetch_add(1, memory_order_relaxed);
+    int64_t max = m_max.load(memory_order_relaxed);
+    while ((value > max) && !m_max.compare_exchange_weak(max, value, memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Summary LatencyHistogram::getSummaryAndReset() {
+    uint64_t counts[NUMBER_OF_BUCKETS];
+    Summary summary;
+    summary.count = 0;
+    for (uint32_t i = 0; i < NUMBER_OF_BUCKETS; i++) {
+        counts[i] = m_buckets[i].exchange(0, memory_order_relaxed);
+        summary.count += counts[i];
+    }
+    summary.max = m_max.exchange(0, memory_order_relaxed);
+    summary.p50 = 0;
+    summary.p99 = 0;
+
+    // Smallest buckets that hold at least 50 % and 99 % of the latencies.
+    const uint64_t rank50 = (summary.count * 50 + 99) / 100;
+    const uint64_t rank99 = (summary.count * 99 + 99) / 100;
+    uint64_t cumulative = 0;
+    bool hasP50 = false;
+    for (uint32_t i = 0; (i < NUMBER_OF_BUCKETS) && (cumulative < rank99); i++) {
+        cumulative += counts[i];
+        if (!hasP50 && (cumulative >= rank50) && (counts[i] > 0)) {
+            summary.p50 = toUpperBound(i);
+            hasP50 = true;
+        }
+        if (cumulative >= rank99) {
+            summary.p99 = toUpperBound(i);
+        }
+    }
+    // The maximum is exact; a percentile's bucket bound may exceed it.
+    summary.p50 = (summary.p50 < summary.max) ? summary.p50 : summary.max;
+    summary.p99 = (summary.p99 < summary.max) ? summary.p99 : summary.max;
+    return summary;
+}
+}
+} // opendlv::core
@@ -0,0 +1,177 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+#include <thread>
+
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+
+namespace {
+const uint32_t MAX_ATTEMPTS = 100;
+}
+
+const uint32_t SeqLock::TRAILER_SIZE;
+const uint32_t SeqLock::TRAILER_ALIGNMENT;
+const uint32_t SeqLock::MAGIC_OFFSET;
+const uint32_t SeqLock::VERSION_OFFSET;
+const uint32_t SeqLock::SEQUENCE_OFFSET;
+const uint32_t SeqLock::FRAME_NUMBER_OFFSET;
+const uint32_t SeqLock::MAGIC;
+const uint32_t SeqLock::VERSION;
+
+SeqLock::SeqLock(const uint32_t &payloadSize)
+    : m_payloadSize(payloadSize)
+    , m_trailerOffset((payloadSize + TRAILER_ALIGNMENT - 1) / TRAILER_ALIGNMENT * TRAILER_ALIGNMENT)
+    , m_segment(NULL)
+    , m_sequence(NULL)
+    , m_frameNumber(NULL) {}
+
+SeqLock::~SeqLock() {}
+
+uint32_t SeqLock::getSegmentSize() const {
+    return m_trailerOffset + TRAILER_SIZE;
+}
+
+bool SeqLock::initialize(char *segment, const uint32_t &segmentSize) {
+    m_segment = NULL;
+    m_sequence = NULL;
+    m_frameNumber = NULL;
+    if ((segment == NULL) || (segmentSize < getSegmentSize())) {
+        return false;
+    }
+    char *trailer = segment + m_trailerOffset;
+    memset(trailer, 0, TRAILER_SIZE);
+    memcpy(trailer + MAGIC_OFFSET, &MAGIC, sizeof(MAGIC));
+    memcpy(trailer + VERSION_OFFSET, &VERSION, sizeof(VERSION));
+    m_segment = segment;
+    m_sequence = static_cast< uint64_t * >(static_cast< void * >(trailer + SEQUENCE_OFFSET));
+    m_frameNumber = static_cast< uint64_t * >(static_cast< void * >(trailer + FRAME_NUMBER_OFFSET));
+    __atomic_store_n(m_sequence, 0, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool SeqLock::attach(char *segment, const uint32_t &segmentSize) {
+    m_segment = NULL;
+    m_sequence = NULL;
+    m_frameNumber = NULL;
+    if ((segment == NULL) || (segmentSize < getSegmentSize())) {
+        return false;
+    }
+    const char *trailer = segment + m_trailerOffset;
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    memcpy(&magic, trailer + MAGIC_OFFSET, sizeof(magic));
+    memcpy(&version, trailer + VERSION_OFFSET, sizeof(version));
+    if ((MAGIC != magic) || (VERSION != version)) {
+        return false;
+    }
+    m_segment = segment;
+    m_sequence = static_cast< uint64_t * >(static_cast< void * >(segment + m_trailerOffset + SEQUENCE_OFFSET));
+    m_frameNumber = static_cast< uint64_t * >(static_cast< void * >(segment + m_trailerOffset + FRAME_NUMBER_OFFSET));
+    return true;
+}
+
+bool SeqLock::isValid() const {
+    return (m_sequence != NULL);
+}
+
+void SeqLock::beginWrite() {
+    if (m_sequence != NULL) {
+        const uint64_t sequence = __atomic_load_n(m_sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(m_sequence, sequence + 1, __ATOMIC_RELAXED);
+        // The odd sequence must be visible before any byte of the payload.
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+}
+
+void SeqLock::endWrite() {
+    if (m_sequence != NULL) {
+        const uint64_t sequence = __atomic_load_n(m_sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(m_sequence, sequence + 1, __ATOMIC_RELEASE);
+    }
+}
+
+void SeqLock::abortWrite() {
+    if (m_sequence != NULL) {
+        const uint64_t sequence = __atomic_load_n(m_sequence, __ATOMIC_RELAXED);
+        __atomic_store_n(m_sequence, sequence - 1, __ATOMIC_RELEASE);
+    }
+}
+
+void SeqLock::setFrameNumber(const uint64_t &frameNumber) {
+    if (m_frameNumber != NULL) {
+        __atomic_store_n(m_frameNumber, frameNumber, __ATOMIC_RELAXED);
+    }
+}
+
+bool SeqLock::read(char *destination, const uint32_t &size) const {
+    uint64_t frameNumber = 0;
+    return read(destination, size, frameNumber);
+}
+
+bool SeqLock::read(char *destination, const uint32_t &size, uint64_t &frameNumber) const {
+    if ((m_sequence == NULL) || (destination == NULL)) {
+        return false;
+    }
+    const uint32_t length = (size < m_payloadSize) ? size : m_payloadSize;
+    for (uint32_t attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        const uint64_t before = __atomic_load_n(m_sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        memcpy(destination, m_segment, length);
+        frameNumber = __atomic_load_n(m_frameNumber, __ATOMIC_RELAXED);
+        // The payload must be read before the sequence is checked again.
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const uint64_t after = __atomic_load_n(m_sequence, __ATOMIC_RELAXED);
+        if (before == after) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SeqLock::beginRead(uint64_t &sequence) const {
+    if (m_sequence == NULL) {
+        return false;
+    }
+    for (uint32_t attempt = 0; attempt < MAX_ATTEMPTS; attempt++) {
+        sequence = __atomic_load_n(m_sequence, __ATOMIC_ACQUIRE);
+        if (!(sequence & 1)) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+    return false;
+}
+
+bool SeqLock::endRead(const uint64_t &sequence) const {
+    if (m_sequence == NULL) {
+        return false;
+    }
+    // The payload must be read before the sequence is checked again.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return (sequence == __atomic_load_n(m_sequence, __ATOMIC_RELAXED));
+}
+}
+} // opendlv::core
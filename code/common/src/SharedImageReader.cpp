@@ -0,0 +1,119 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
+#include "SharedImageReader.h"
+
+namespace opendlv {
+namespace core {
+
+SharedImageReader::Attachment::Attachment()
+    : size(0)
+    , sharedMemory()
+    , seqLock()
+    , view() {}
+
+SharedImageReader::SharedImageReader()
+    : m_attachments()
+    , m_current(NULL)
+    , m_sequence(0)
+    , m_numberOfAttachments(0) {}
+
+SharedImageReader::~SharedImageReader() {}
+
+bool SharedImageReader::attach(const odcore::data::image::SharedImage &si) {
+    Attachment &attachment = m_attachments[si.getName()];
+    m_current = &attachment;
+    // A failed attachment has an empty view and is tried again.
+    if (   !attachment.view.empty()
+        && (attachment.view.cols == static_cast< int32_t >(si.getWidth()))
+        && (attachment.view.rows == static_cast< int32_t >(si.getHeight()))
+        && (attachment.view.channels() == static_cast< int32_t >(si.getBytesPerPixel())) ) {
+        return true;
+    }
+
+    attachment = Attachment();
+    attachment.size = si.getWidth() * si.getHeight() * si.getBytesPerPixel();
+    attachment.sharedMemory = odcore::wrapper::SharedMemoryFactory::attachToSharedMemory(si.getName());
+    m_numberOfAttachments++;
+    if (   (attachment.sharedMemory.get() == NULL)
+        || !attachment.sharedMemory->isValid()
+        || (attachment.size == 0)
+        || (attachment.sharedMemory->getSize() < attachment.size) ) {
+        return false;
+    }
+
+    std::shared_ptr< SeqLock > seqLock(new SeqLock(attachment.size));
+    if (seqLock->attach(static_cast< char * >(attachment.sharedMemory->getSharedMemory()), attachment.sharedMemory->getSize())) {
+        attachment.seqLock = seqLock;
+    }
+    attachment.view = cv::Mat(si.getHeight(), si.getWidth(), CV_8UC(si.getBytesPerPixel()), attachment.sharedMemory->getSharedMemory());
+    return true;
+}
+
+cv::Mat SharedImageReader::getView() const {
+    return (m_current != NULL) ? m_current->view : cv::Mat();
+}
+
+bool SharedImageReader::beginRead() {
+    if ((m_current == NULL) || m_current->view.empty()) {
+        return false;
+    }
+    if (m_current->seqLock.get() != NULL) {
+        return m_current->seqLock->beginRead(m_sequence);
+    }
+    m_current->sharedMemory->lock();
+    return true;
+}
+
+bool SharedImageReader::endRead() {
+    if ((m_current == NULL) || m_current->view.empty()) {
+        return false;
+    }
+    if (m_current->seqLock.get() != NULL) {
+        return m_current->seqLock->endRead(m_sequence);
+    }
+    m_current->sharedMemory->unlock();
+    return true;
+}
+
+bool SharedImageReader::copyTo(cv::Mat &image) {
+    if ((m_current == NULL) || m_current->view.empty()) {
+        return false;
+    }
+    const cv::Mat &view = m_current->view;
+    image.create(view.rows, view.cols, view.type());
+    if (m_current->seqLock.get() != NULL) {
+        // Copy a consistent frame without blocking the writer.
+        return m_current->seqLock->read(reinterpret_cast< char * >(image.data), m_current->size);
+    }
+    m_current->sharedMemory->lock();
+    memcpy(image.data, m_current->sharedMemory->getSharedMemory(), m_current->size);
+    m_current->sharedMemory->unlock();
+    return true;
+}
+
+uint32_t SharedImageReader::getNumberOfAttachments() const {
+    return m_numberOfAttachments;
+}
+}
+} // opendlv::core
@@ -0,0 +1,139 @@
+/**
+ * OpenDLV - Software for driverless vehicles realized with OpenDaVINCI
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "UndistortionMaps.h"
+
+namespace opendlv {
+namespace core {
+
+namespace {
+const char MAGIC[8] = {'U', 'N', 'D', 'I', 'S', 'T', '0', '1'};
+
+struct Header {
+    char magic[8];
+    int32_t width;
+    int32_t height;
+    int32_t type1;
+    int32_t type2;
+};
+
+bool isSupported(const int32_t &type1, const int32_t &type2) {
+    return ((type1 == CV_16SC2) && (type2 == CV_16UC1)) || ((type1 == CV_32FC1) && (type2 == CV_32FC1));
+}
+}
+
+void UndistortionMaps::compute(const cv::Mat &cameraMatrix, const cv::Mat &distortionCoefficients, const cv::Size &imageSize, cv::Mat &map1, cv::Mat &map2) {
+    cv::initUndistortRectifyMap(cameraMatrix, distortionCoefficients, cv::Mat(), cameraMatrix, imageSize, CV_16SC2, map1, map2);
+}
+
+void UndistortionMaps::write(const std::string &filename, const cv::Mat &map1, const cv::Mat &map2) {
+    if (map1.empty() || (map1.size() != map2.size()) || !isSupported(map1.type(), map2.type())) {
+        throw std::invalid_argument("Invalid maps! Use CV_16SC2 and CV_16UC1, or two CV_32FC1 of the same size");
+    }
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open '" + filename + "'");
+    }
+    Header header;
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.width = map1.cols;
+    header.height = map1.rows;
+    header.type1 = map1.type();
+    header.type2 = map2.type();
+    file.write(reinterpret_cast< const char * >(&header), sizeof(header));
+    // Rows are written one by one as the maps may be views with padding.
+    const cv::Mat *maps[2] = {&map1, &map2};
+    for (const cv::Mat *map : maps) {
+        const std::streamsize rowSize = static_cast< std::streamsize >(map->cols * map->elemSize());
+        for (int32_t r = 0; r < map->rows; r++) {
+            file.write(reinterpret_cast< const char * >(map->ptr(r)), rowSize);
+        }
+    }
+    if (!file.good()) {
+        throw std::invalid_argument("Could not write '" + filename + "'");
+    }
+}
+
+void UndistortionMaps::read(const std::string &filename, cv::Mat &map1, cv::Mat &map2) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::invalid_argument("Could not open '" + filename + "'");
+    }
+    Header header;
+    if (!file.read(reinterpret_cast< char * >(&header), sizeof(header)) || (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) || (header.width <= 0) || (header.height <= 0) || !isSupported(header.type1, header.type2)) {
+        throw std::invalid_argument("'" + filename + "' holds no undistortion maps");
+    }
+    map1.create(header.height, header.width, header.type1);
+    map2.create(header.height, header.width, header.type2);
+    cv::Mat *maps[2] = {&map1, &map2};
+    for (cv::Mat *map : maps) {
+        const std::streamsize size = static_cast< std::streamsize >(map->total() * map->elemSize());
+        if (!file.read(reinterpret_cast< char * >(map->ptr()), size)) {
+            throw std::invalid_argument("'" + filename + "' is truncated");
+        }
+    }
+}
+
+void UndistortionMaps::fit(const cv::Mat &map1, const cv::Mat &map2, const cv::Size &frameSize, const uint32_t &scale, cv::Mat &fitted1, cv::Mat &fitted2) {
+    const int32_t factor = static_cast< int32_t >(scale);
+    if ((factor < 1) || map1.empty() || (map1.size() != map2.size()) || !isSupported(map1.type(), map2.type())) {
+        throw std::invalid_argument("Invalid undistortion maps or scale");
+    }
+    if ((map1.size() == frameSize) && (CV_16SC2 == map1.type())) {
+        fitted1 = map1;
+        fitted2 = map2;
+        return;
+    }
+    cv::Mat x;
+    cv::Mat y;
+    if (CV_32FC1 == map1.type()) {
+        x = map1;
+        y = map2;
+    } else {
+        cv::convertMaps(map1, map2, x, y, CV_32FC1);
+    }
+    if ((map1.size() != frameSize) && (1 < factor) && (map1.size() == cv::Size(frameSize.width * factor, frameSize.height * factor))) {
+        // Maps of the full frames: sample them at the centres of the
+        // downscaled pixels and convert the coordinates into the
+        // downscaled frame.
+        cv::Mat downscaledX;
+        cv::Mat downscaledY;
+        cv::resize(x, downscaledX, frameSize, 0, 0, cv::INTER_LINEAR);
+        cv::resize(y, downscaledY, frameSize, 0, 0, cv::INTER_LINEAR);
+        const double toDownscaled = 1.0 / static_cast< double >(factor);
+        const double offset = 0.5 * toDownscaled - 0.5;
+        downscaledX.convertTo(x, CV_32FC1, toDownscaled, offset);
+        downscaledY.convertTo(y, CV_32FC1, toDownscaled, offset);
+    } else if (map1.size() != frameSize) {
+        std::stringstream message;
+        message << "Undistortion maps of " << map1.cols << "x" << map1.rows << " fit neither the frames of " << frameSize.width << "x" << frameSize.height
+                << " nor the camera's frames of " << frameSize.width * factor << "x" << frameSize.height * factor;
+        throw std::invalid_argument(message.str());
+    }
+    cv::convertMaps(x, y, fitted1, fitted2, CV_16SC2);
+}
+}
+} // opendlv::core
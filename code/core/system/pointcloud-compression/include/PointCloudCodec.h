@@ -0,0 +1,144 @@
+/**
+ * pointcloud-compression - Codec for shared point cloud frames.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTCLOUDCODEC_H
+#define POINTCLOUDCODEC_H
+
+#include <stdint.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+/**
+ * This class encodes and decodes the float payload of a shared point cloud
+ * (SPC) frame as written by the Velodyne proxies.
+ *
+ * Every component is quantized with its own step (a step of 0 keeps the
+ * exact float bit pattern and is thus lossless), predicted from its
+ * neighbour in the range image, and zigzag coded. The bit length of each
+ * residual is entropy coded with an order-0 rANS coder per component while
+ * the remaining bits of the residual are stored raw in a bit stream. A
+ * component whose quantized values do not fit into 32 bits is coded
+ * lossless in that frame; its step is written as 0.
+ *
+ * For polar frames (distance, azimuth, vertical angle, intensity), the
+ * vertical angle identifies the beam (row of the range image): distance and
+ * intensity are predicted from the previous column of the same beam and the
+ * vertical angle from the beam firing order. For cartesian frames, every
+ * component is predicted from the previous point.
+ *
+ * Stream layout (all integers little endian):
+ *   char[4]  magic "SPCZ"
+ *   uint8    version
+ *   uint8    layout (0: cartesian, 1: polar)
+ *   uint8    number of components per point
+ *   uint8    reserved
+ *   uint32   number of points
+ *   float[n] quantization step per component
+ *   per component:
+ *     uint32   number of bit lengths (one per point); if 0, the bit stream follows
+ *     uint8    number of symbols - 1
+ *     (uint8 symbol, uint16 frequency)[], frequencies summing up to 4096
+ *     per rANS lane (4 lanes of consecutive bit lengths, the last may be shorter):
+ *       uint32 lane bytes
+ *       lane bytes: uint32 final state, uint16 renormalization words, uint16 0
+ *     uint32   bit stream bytes
+ *     bit stream (remaining bits of the residuals, LSB first, 8 zero bytes appended)
+ */
+class PointCloudCodec {
+   public:
+    enum Layout {
+        CARTESIAN = 0,
+        POLAR     = 1,
+    };
+
+    static const uint8_t MAX_NUMBER_OF_COMPONENTS = 4;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param layout Layout of the points to encode.
+     * @param quantization Quantization step per component; 0 for lossless.
+     */
+    PointCloudCodec(const Layout &layout, const std::array< float, MAX_NUMBER_OF_COMPONENTS > &quantization);
+    PointCloudCodec(const PointCloudCodec &) = delete;
+    PointCloudCodec &operator=(const PointCloudCodec &) = delete;
+    virtual ~PointCloudCodec();
+
+    /**
+     * This method encodes a frame.
+     *
+     * @param points Interleaved components of all points.
+     * @param numberOfPoints Number of points to encode.
+     * @param numberOfComponentsPerPoint Components per point (1-4).
+     * @param out Encoded frame (reusing its capacity).
+     * @return Number of bytes in the encoded frame.
+     */
+    uint32_t encode(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, std::string &out);
+
+    /**
+     * This method decodes a frame.
+     *
+     * @param in Encoded frame.
+     * @param points Destination for the interleaved components.
+     * @param capacity Number of floats available at points.
+     * @return Number of decoded points.
+     * @throws std::invalid_argument for malformed or too large frames.
+     */
+    uint32_t decode(const std::string &in, float *points, const uint32_t &capacity);
+
+    /**
+     * @param in Encoded frame.
+     * @return Number of points contained in the encoded frame or 0 if the
+     *         header is invalid.
+     */
+    static uint32_t getNumberOfPoints(const std::string &in);
+
+    /**
+     * @param in Encoded frame.
+     * @return Number of components per point in the encoded frame.
+     */
+    static uint8_t getNumberOfComponentsPerPoint(const std::string &in);
+
+   private:
+    // Falls back to lossless coding for a component whose quantized values
+    // do not fit into 32 bits.
+    void chooseSteps(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, std::array< float, MAX_NUMBER_OF_COMPONENTS > &steps) const;
+    void predictAndQuantize(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, const std::array< float, MAX_NUMBER_OF_COMPONENTS > &steps);
+
+   private:
+    Layout m_layout;
+    std::array< float, MAX_NUMBER_OF_COMPONENTS > m_quantization;
+    std::array< std::vector< uint32_t >, MAX_NUMBER_OF_COMPONENTS > m_residuals;
+    std::vector< uint8_t > m_tokens;
+    std::string m_bits;
+    std::vector< uint8_t > m_entropyBuffer;
+    std::vector< uint32_t > m_decodingTables;
+};
+}
+}
+} // opendlv::core::system
+
+#endif /*POINTCLOUDCODEC_H*/
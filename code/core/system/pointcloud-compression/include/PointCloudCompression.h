@@ -0,0 +1,75 @@
+/**
+ * pointcloud-compression - Codec for shared point cloud frames.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTCLOUDCOMPRESSION_H
+#define POINTCLOUDCOMPRESSION_H
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/base/module/DataTriggeredConferenceClientModule.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
+
+#include "PointCloudCodec.h"
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+
+/**
+ * This component compresses shared point cloud (SPC) frames into
+ * PointCloudReadingCompressed messages, which can be recorded and sent over
+ * the network, or decompresses such messages back into an SPC.
+ */
+class PointCloudCompression : public odcore::base::module::DataTriggeredConferenceClientModule {
+   public:
+    PointCloudCompression(int32_t const &, char **);
+    PointCloudCompression(PointCloudCompression const &) = delete;
+    PointCloudCompression &operator=(PointCloudCompression const &) = delete;
+    virtual ~PointCloudCompression();
+    virtual void nextContainer(odcore::data::Container &c);
+
+   private:
+    void setUp();
+    void tearDown();
+
+    void encode(odcore::data::Container &c);
+    void decode(odcore::data::Container &c);
+
+   private:
+    bool m_encode;
+    std::string m_name;
+    uint32_t m_size;
+    std::array< float, PointCloudCodec::MAX_NUMBER_OF_COMPONENTS > m_quantization;
+    std::unique_ptr< PointCloudCodec > m_cartesianCodec;
+    std::unique_ptr< PointCloudCodec > m_polarCodec;
+    std::shared_ptr< odcore::wrapper::SharedMemory > m_sharedMemory;
+    std::string m_buffer;
+    std::vector< float > m_frame; // Consistent copy of the SPC to encode.
+};
+}
+}
+} // opendlv::core::system
+
+#endif /*POINTCLOUDCOMPRESSION_H*/
@@ -0,0 +1,592 @@
+/**
+ * pointcloud-compression - Codec for shared point cloud frames.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "PointCloudCodec.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+
+namespace {
+
+const char MAGIC[4] = {'S', 'P', 'C', 'Z'};
+const uint8_t VERSION = 1;
+const uint32_t HEADER_SIZE = 12;
+
+// rANS parameters: 12 bit probabilities, 32 bit state, renormalization by
+// 16 bit words (at most one word per symbol), four independent lanes.
+const uint32_t PROB_BITS = 12;
+const uint32_t PROB_SCALE = 1u << PROB_BITS;
+const uint32_t RANS_L = 1u << 16;
+const uint32_t RANS_STATES = 4;
+
+// Zero bytes appended to the bit streams to allow for 8 byte loads.
+const uint32_t BIT_STREAM_PADDING = 8;
+
+// Direct-mapped table to identify the beam (row of the range image) of a
+// point from its quantized vertical angle.
+const uint32_t BEAM_TABLE_SIZE = 256;
+
+struct Beam {
+    uint32_t key;
+    uint32_t distance;
+    uint32_t intensity;
+    uint32_t next;
+    bool used;
+};
+
+uint32_t beamSlot(const uint32_t &key) {
+    return (key * 2654435761u) >> 24;
+}
+
+// Maps a float onto an unsigned integer that preserves the ordering of the
+// floats, so that the difference of two close values is small.
+uint32_t toOrderedBits(const float &v) {
+    uint32_t bits = 0;
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+float fromOrderedBits(const uint32_t &ordered) {
+    const uint32_t bits = (ordered & 0x80000000u) ? (ordered & 0x7FFFFFFFu) : ~ordered;
+    float v = 0.0f;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+uint32_t zigzag(const uint32_t &delta) {
+    const int32_t d = static_cast< int32_t >(delta);
+    return (static_cast< uint32_t >(d) << 1) ^ static_cast< uint32_t >(d >> 31);
+}
+
+uint32_t unzigzag(const uint32_t &z) {
+    return (z >> 1) ^ (0u - (z & 1u));
+}
+
+void putUint32(string &out, const uint32_t &v) {
+    out.push_back(static_cast< char >(v & 0xFF));
+    out.push_back(static_cast< char >((v >> 8) & 0xFF));
+    out.push_back(static_cast< char >((v >> 16) & 0xFF));
+    out.push_back(static_cast< char >((v >> 24) & 0xFF));
+}
+
+uint32_t getUint32(const uint8_t *p) {
+    return static_cast< uint32_t >(p[0]) | (static_cast< uint32_t >(p[1]) << 8) | (static_cast< uint32_t >(p[2]) << 16) | (static_cast< uint32_t >(p[3]) << 24);
+}
+
+uint64_t getUint64(const uint8_t *p) {
+    return static_cast< uint64_t >(getUint32(p)) | (static_cast< uint64_t >(getUint32(p + 4)) << 32);
+}
+
+[[noreturn]] void malformed(const char *reason) {
+    throw invalid_argument(string("PointCloudCodec: ") + reason);
+}
+
+
+// A residual is coded as its bit length (token, entropy coded) followed by
+// the bits below its most significant bit (stored raw, LSB first).
+void splitResiduals(const vector< uint32_t > &residuals, vector< uint8_t > &tokens, string &bits) {
+    tokens.resize(residuals.size());
+    bits.clear();
+    uint64_t buffer = 0;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < residuals.size(); i++) {
+        const uint32_t z = zigzag(residuals[i]);
+        uint32_t length = 0;
+        while ((length < 32) && ((z >> length) != 0)) {
+            length++;
+        }
+        tokens[i] = static_cast< uint8_t >(length);
+        if (length > 1) {
+            buffer |= static_cast< uint64_t >(z & ((1u << (length - 1)) - 1)) << count;
+            count += length - 1;
+            while (count >= 8) {
+                bits.push_back(static_cast< char >(buffer & 0xFF));
+                buffer >>= 8;
+                count -= 8;
+            }
+        }
+    }
+    if (count > 0) {
+        bits.push_back(static_cast< char >(buffer & 0xFF));
+    }
+    bits.append(BIT_STREAM_PADDING, '\0');
+}
+
+// Inverse of splitResiduals; returns the position after the bit stream.
+const uint8_t *joinResiduals(const vector< uint8_t > &tokens, const uint8_t *p, const uint8_t *end, vector< uint32_t > &residuals) {
+    if (end - p < 4) {
+        malformed("truncated bit stream");
+    }
+    const uint32_t size = getUint32(p);
+    p += 4;
+    if ((size < BIT_STREAM_PADDING) || (static_cast< uint32_t >(end - p) < size)) {
+        malformed("truncated bit stream");
+    }
+    // Every residual is read with a single unaligned 8 byte load at its bit
+    // position, which holds at least 7 + 31 valid bits.
+    const uint64_t lastPosition = static_cast< uint64_t >(size - BIT_STREAM_PADDING) * 8;
+    uint64_t position = 0;
+    residuals.resize(tokens.size());
+    uint32_t *dest = residuals.data();
+    for (uint32_t i = 0; i < tokens.size(); i++) {
+        const uint32_t token = tokens[i];
+        if ((token > 32) || (position > lastPosition)) {
+            malformed("invalid bit stream");
+        }
+        // Most significant bit (0 for token 0) and the mask below it, without branching.
+        const uint64_t top = (1ull << token) >> 1;
+        const uint64_t mask = (top - 1) & (0 - static_cast< uint64_t >(top != 0));
+        const uint64_t window = getUint64(p + (position >> 3)) >> (position & 7);
+        position += token - ((0 != token) ? 1 : 0);
+        dest[i] = unzigzag(static_cast< uint32_t >(top | (window & mask)));
+    }
+    return p + size;
+}
+
+void normalizeFrequencies(const array< uint32_t, 256 > &counts, const uint32_t &total, array< uint32_t, 256 > &freqs) {
+    uint32_t sum = 0;
+    uint32_t largest = 0;
+    for (uint32_t s = 0; s < 256; s++) {
+        freqs[s] = 0;
+        if (counts[s] > 0) {
+            const uint64_t scaled = (static_cast< uint64_t >(counts[s]) * PROB_SCALE) / total;
+            freqs[s] = (scaled > 0) ? static_cast< uint32_t >(scaled) : 1;
+            sum += freqs[s];
+            if (freqs[s] > freqs[largest]) {
+                largest = s;
+            }
+        }
+    }
+    // Hand the rounding error to the most frequent symbols.
+    while (sum > PROB_SCALE) {
+        for (uint32_t s = 0; s < 256; s++) {
+            if (freqs[s] > freqs[largest]) {
+                largest = s;
+            }
+        }
+        freqs[largest]--;
+        sum--;
+    }
+    freqs[largest] += PROB_SCALE - sum;
+}
+
+// The symbols of a stream are split into RANS_STATES consecutive lanes, each
+// coded with its own state into its own bytes, so that the lanes can be
+// decoded side by side without depending on each other.
+void getLane(const uint32_t &size, const uint32_t &lane, uint32_t &begin, uint32_t &end) {
+    const uint32_t laneSize = (size + RANS_STATES - 1) / RANS_STATES;
+    begin = min(size, lane * laneSize);
+    end = min(size, begin + laneSize);
+}
+
+// Order-0 rANS encoder; appends the frequency table and the coded lanes.
+void ransEncode(const vector< uint8_t > &in, vector< uint8_t > &buffer, string &out) {
+    const uint32_t size = static_cast< uint32_t >(in.size());
+    putUint32(out, size);
+    if (0 == size) {
+        return;
+    }
+
+    array< uint32_t, 256 > counts;
+    counts.fill(0);
+    for (uint32_t i = 0; i < size; i++) {
+        counts[in[i]]++;
+    }
+    array< uint32_t, 256 > freqs;
+    normalizeFrequencies(counts, size, freqs);
+    array< uint32_t, 256 > starts;
+    uint32_t numberOfSymbols = 0;
+    uint32_t cumulative = 0;
+    for (uint32_t s = 0; s < 256; s++) {
+        starts[s] = cumulative;
+        cumulative += freqs[s];
+        numberOfSymbols += (freqs[s] > 0) ? 1 : 0;
+    }
+    out.push_back(static_cast< char >(numberOfSymbols - 1));
+    for (uint32_t s = 0; s < 256; s++) {
+        if (freqs[s] > 0) {
+            out.push_back(static_cast< char >(s));
+            out.push_back(static_cast< char >(freqs[s] & 0xFF));
+            out.push_back(static_cast< char >((freqs[s] >> 8) & 0xFF));
+        }
+    }
+
+    // Each symbol costs at most PROB_BITS bits; the coded bytes are followed
+    // by two zero bytes so that the decoder can always load a whole word.
+    buffer.resize(size * 2 + 8);
+    for (uint32_t lane = 0; lane < RANS_STATES; lane++) {
+        uint32_t begin = 0;
+        uint32_t last = 0;
+        getLane(size, lane, begin, last);
+
+        uint8_t *end = buffer.data() + buffer.size();
+        uint8_t *ptr = end - 2;
+        end[-1] = end[-2] = 0;
+        uint32_t state = RANS_L;
+        for (uint32_t i = last; i > begin; i--) {
+            const uint8_t s = in[i - 1];
+            const uint32_t freq = freqs[s];
+            // The bound reaches 2^32 for a lane with a single symbol.
+            if (state >= ((static_cast< uint64_t >(RANS_L >> PROB_BITS) << 16) * freq)) {
+                ptr -= 2;
+                ptr[0] = static_cast< uint8_t >(state & 0xFF);
+                ptr[1] = static_cast< uint8_t >((state >> 8) & 0xFF);
+                state >>= 16;
+            }
+            state = ((state / freq) << PROB_BITS) + (state % freq) + starts[s];
+        }
+        ptr -= 4;
+        ptr[0] = static_cast< uint8_t >(state & 0xFF);
+        ptr[1] = static_cast< uint8_t >((state >> 8) & 0xFF);
+        ptr[2] = static_cast< uint8_t >((state >> 16) & 0xFF);
+        ptr[3] = static_cast< uint8_t >((state >> 24) & 0xFF);
+
+        putUint32(out, static_cast< uint32_t >(end - ptr));
+        out.append(reinterpret_cast< const char * >(ptr), static_cast< uint32_t >(end - ptr));
+    }
+}
+
+struct RansLane {
+    uint32_t state;
+    const uint8_t *ptr;
+    const uint8_t *last;
+};
+
+uint8_t ransDecodeSymbol(RansLane &lane, const uint32_t *table) {
+    const uint32_t slot = lane.state & (PROB_SCALE - 1);
+    const uint32_t entry = table[slot];
+    uint32_t state = (((entry >> 8) & 0xFFF) + 1) * (lane.state >> PROB_BITS) + slot - (entry >> 20);
+    // At most one word is needed; read it without branching.
+    const uint32_t renormalize = (state < RANS_L) ? 1 : 0;
+    const uint32_t word = static_cast< uint32_t >(lane.ptr[0]) | (static_cast< uint32_t >(lane.ptr[1]) << 8);
+    lane.state = renormalize ? ((state << 16) | word) : state;
+    lane.ptr += 2 * renormalize;
+    if (lane.ptr > lane.last) {
+        malformed("truncated coded stream");
+    }
+    return static_cast< uint8_t >(entry & 0xFF);
+}
+
+// Order-0 rANS decoder matching ransEncode; returns the position after the
+// consumed bytes. Each slot of the table holds the symbol (8 bits),
+// its frequency - 1 (12 bits), and its start (12 bits).
+const uint8_t *ransDecode(const uint8_t *p, const uint8_t *end, uint32_t *table, vector< uint8_t > &out) {
+    if (end - p < 4) {
+        malformed("truncated stream header");
+    }
+    const uint32_t size = getUint32(p);
+    p += 4;
+    out.resize(size);
+    if (0 == size) {
+        return p;
+    }
+    if (end - p < 1) {
+        malformed("truncated stream header");
+    }
+    const uint32_t numberOfSymbols = static_cast< uint32_t >(*p++) + 1;
+    if (static_cast< uint32_t >(end - p) < numberOfSymbols * 3) {
+        malformed("truncated frequency table");
+    }
+
+    uint32_t cumulative = 0;
+    for (uint32_t i = 0; i < numberOfSymbols; i++) {
+        const uint32_t s = p[0];
+        const uint32_t freq = static_cast< uint32_t >(p[1]) | (static_cast< uint32_t >(p[2]) << 8);
+        p += 3;
+        if ((0 == freq) || (cumulative + freq > PROB_SCALE)) {
+            malformed("invalid frequency table");
+        }
+        const uint32_t entry = s | ((freq - 1) << 8) | (cumulative << 20);
+        for (uint32_t slot = cumulative; slot < cumulative + freq; slot++) {
+            table[slot] = entry;
+        }
+        cumulative += freq;
+    }
+    if (cumulative != PROB_SCALE) {
+        malformed("invalid frequency table");
+    }
+
+    array< RansLane, RANS_STATES > lanes;
+    for (uint32_t j = 0; j < RANS_STATES; j++) {
+        if (end - p < 4) {
+            malformed("truncated coded stream");
+        }
+        const uint32_t codedSize = getUint32(p);
+        p += 4;
+        if ((codedSize < 6) || (static_cast< uint32_t >(end - p) < codedSize)) {
+            malformed("truncated coded stream");
+        }
+        lanes[j].state = getUint32(p);
+        lanes[j].ptr = p + 4;
+        lanes[j].last = p + codedSize - 2;
+        p += codedSize;
+    }
+
+    // All lanes but the last one have the same length.
+    uint32_t begin = 0;
+    uint32_t last = 0;
+    getLane(size, RANS_STATES - 1, begin, last);
+    const uint32_t laneSize = (size + RANS_STATES - 1) / RANS_STATES;
+    const uint32_t common = last - begin;
+    uint8_t *dest = out.data();
+    for (uint32_t i = 0; i < common; i++) {
+        dest[i] = ransDecodeSymbol(lanes[0], table);
+        dest[laneSize + i] = ransDecodeSymbol(lanes[1], table);
+        dest[2 * laneSize + i] = ransDecodeSymbol(lanes[2], table);
+        dest[3 * laneSize + i] = ransDecodeSymbol(lanes[3], table);
+    }
+    for (uint32_t j = 0; j < RANS_STATES; j++) {
+        getLane(size, j, begin, last);
+        for (uint32_t i = begin + common; i < last; i++) {
+            dest[i] = ransDecodeSymbol(lanes[j], table);
+        }
+    }
+    return p;
+}
+}
+
+PointCloudCodec::PointCloudCodec(const Layout &layout, const array< float, MAX_NUMBER_OF_COMPONENTS > &quantization)
+    : m_layout(layout)
+    , m_quantization(quantization)
+    , m_residuals()
+    , m_tokens()
+    , m_bits()
+    , m_entropyBuffer()
+    , m_decodingTables() {
+    for (uint8_t i = 0; i < MAX_NUMBER_OF_COMPONENTS; i++) {
+        if (m_quantization[i] < 0.0f) {
+            throw invalid_argument("PointCloudCodec: quantization steps must not be negative");
+        }
+    }
+}
+
+PointCloudCodec::~PointCloudCodec() {}
+
+void PointCloudCodec::chooseSteps(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, array< float, MAX_NUMBER_OF_COMPONENTS > &steps) const {
+    steps = m_quantization;
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        if (steps[c] > 0.0f) {
+            const float inverse = 1.0f / steps[c];
+            for (uint32_t i = 0; i < numberOfPoints; i++) {
+                // Also true for NaN.
+                if (!(fabs(points[i * numberOfComponentsPerPoint + c] * inverse) < 2147483648.0f)) {
+                    steps[c] = 0.0f;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void PointCloudCodec::predictAndQuantize(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, const array< float, MAX_NUMBER_OF_COMPONENTS > &steps) {
+    array< float, MAX_NUMBER_OF_COMPONENTS > inverse;
+    for (uint8_t c = 0; c < MAX_NUMBER_OF_COMPONENTS; c++) {
+        inverse[c] = (steps[c] > 0.0f) ? (1.0f / steps[c]) : 0.0f;
+        m_residuals[c].resize(numberOfPoints);
+    }
+
+    const bool polar = (POLAR == m_layout) && (4 == numberOfComponentsPerPoint);
+    vector< Beam > beams(BEAM_TABLE_SIZE, Beam());
+    array< uint32_t, MAX_NUMBER_OF_COMPONENTS > previous;
+    previous.fill(0);
+    array< uint32_t, MAX_NUMBER_OF_COMPONENTS > q;
+
+    for (uint32_t i = 0; i < numberOfPoints; i++) {
+        const float *point = points + i * numberOfComponentsPerPoint;
+        for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+            q[c] = (steps[c] > 0.0f) ? static_cast< uint32_t >(static_cast< int32_t >(lrintf(point[c] * inverse[c]))) : toOrderedBits(point[c]);
+        }
+
+        if (polar) {
+            Beam &previousBeam = beams[beamSlot(previous[2])];
+            const bool previousKnown = previousBeam.used && (previousBeam.key == previous[2]);
+            m_residuals[2][i] = q[2] - (previousKnown ? previousBeam.next : previous[2]);
+            if (previousKnown) {
+                previousBeam.next = q[2];
+            }
+
+            Beam &beam = beams[beamSlot(q[2])];
+            const bool known = beam.used && (beam.key == q[2]);
+            m_residuals[0][i] = q[0] - (known ? beam.distance : previous[0]);
+            m_residuals[1][i] = q[1] - previous[1];
+            m_residuals[3][i] = q[3] - (known ? beam.intensity : previous[3]);
+            if (!known) {
+                beam.key = q[2];
+                beam.next = q[2];
+                beam.used = true;
+            }
+            beam.distance = q[0];
+            beam.intensity = q[3];
+        } else {
+            for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+                m_residuals[c][i] = q[c] - previous[c];
+            }
+        }
+        previous = q;
+    }
+}
+
+uint32_t PointCloudCodec::encode(const float *points, const uint32_t &numberOfPoints, const uint8_t &numberOfComponentsPerPoint, string &out) {
+    if ((0 == numberOfComponentsPerPoint) || (numberOfComponentsPerPoint > MAX_NUMBER_OF_COMPONENTS)) {
+        throw invalid_argument("PointCloudCodec: unsupported number of components per point");
+    }
+    array< float, MAX_NUMBER_OF_COMPONENTS > steps;
+    chooseSteps(points, numberOfPoints, numberOfComponentsPerPoint, steps);
+    predictAndQuantize(points, numberOfPoints, numberOfComponentsPerPoint, steps);
+
+    out.clear();
+    out.append(MAGIC, sizeof(MAGIC));
+    out.push_back(static_cast< char >(VERSION));
+    out.push_back(static_cast< char >(m_layout));
+    out.push_back(static_cast< char >(numberOfComponentsPerPoint));
+    out.push_back(0);
+    putUint32(out, numberOfPoints);
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        uint32_t bits = 0;
+        memcpy(&bits, &steps[c], sizeof(bits));
+        putUint32(out, bits);
+    }
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        splitResiduals(m_residuals[c], m_tokens, m_bits);
+        ransEncode(m_tokens, m_entropyBuffer, out);
+        putUint32(out, static_cast< uint32_t >(m_bits.size()));
+        out.append(m_bits);
+    }
+    return static_cast< uint32_t >(out.size());
+}
+
+uint32_t PointCloudCodec::getNumberOfPoints(const string &in) {
+    if ((in.size() < HEADER_SIZE) || (0 != memcmp(in.data(), MAGIC, sizeof(MAGIC))) || (VERSION != static_cast< uint8_t >(in[4]))) {
+        return 0;
+    }
+    return getUint32(reinterpret_cast< const uint8_t * >(in.data()) + 8);
+}
+
+uint8_t PointCloudCodec::getNumberOfComponentsPerPoint(const string &in) {
+    return (in.size() < HEADER_SIZE) ? 0 : static_cast< uint8_t >(in[6]);
+}
+
+uint32_t PointCloudCodec::decode(const string &in, float *points, const uint32_t &capacity) {
+    if ((in.size() < HEADER_SIZE) || (0 != memcmp(in.data(), MAGIC, sizeof(MAGIC))) || (VERSION != static_cast< uint8_t >(in[4]))) {
+        throw invalid_argument("PointCloudCodec: not an encoded point cloud frame");
+    }
+    const uint8_t *p = reinterpret_cast< const uint8_t * >(in.data());
+    const uint8_t *end = p + in.size();
+    const bool polarLayout = (POLAR == static_cast< Layout >(p[5]));
+    const uint8_t numberOfComponentsPerPoint = p[6];
+    const uint32_t numberOfPoints = getUint32(p + 8);
+    if ((0 == numberOfComponentsPerPoint) || (numberOfComponentsPerPoint > MAX_NUMBER_OF_COMPONENTS)) {
+        throw invalid_argument("PointCloudCodec: unsupported number of components per point");
+    }
+    if (static_cast< uint64_t >(numberOfPoints) * numberOfComponentsPerPoint > capacity) {
+        throw invalid_argument("PointCloudCodec: decoded frame exceeds the destination");
+    }
+    p += HEADER_SIZE;
+    if (static_cast< uint32_t >(end - p) < 4u * numberOfComponentsPerPoint) {
+        throw invalid_argument("PointCloudCodec: truncated header");
+    }
+    array< float, MAX_NUMBER_OF_COMPONENTS > step;
+    step.fill(0.0f);
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        const uint32_t bits = getUint32(p);
+        memcpy(&step[c], &bits, sizeof(bits));
+        p += 4;
+    }
+    m_decodingTables.resize(PROB_SCALE);
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        p = ransDecode(p, end, m_decodingTables.data(), m_tokens);
+        if (m_tokens.size() != numberOfPoints) {
+            throw invalid_argument("PointCloudCodec: inconsistent component stream");
+        }
+        p = joinResiduals(m_tokens, p, end, m_residuals[c]);
+    }
+
+    // Undo the prediction.
+    const bool polar = polarLayout && (4 == numberOfComponentsPerPoint);
+    if (polar) {
+        const uint32_t *distance = m_residuals[0].data();
+        const uint32_t *azimuth = m_residuals[1].data();
+        const uint32_t *vertical = m_residuals[2].data();
+        const uint32_t *intensity = m_residuals[3].data();
+        vector< Beam > beams(BEAM_TABLE_SIZE, Beam());
+        array< uint32_t, MAX_NUMBER_OF_COMPONENTS > previous;
+        previous.fill(0);
+        array< uint32_t, MAX_NUMBER_OF_COMPONENTS > q;
+        for (uint32_t i = 0; i < numberOfPoints; i++) {
+            Beam &previousBeam = beams[beamSlot(previous[2])];
+            const bool previousKnown = previousBeam.used && (previousBeam.key == previous[2]);
+            q[2] = vertical[i] + (previousKnown ? previousBeam.next : previous[2]);
+            if (previousKnown) {
+                previousBeam.next = q[2];
+            }
+
+            Beam &beam = beams[beamSlot(q[2])];
+            const bool known = beam.used && (beam.key == q[2]);
+            q[0] = distance[i] + (known ? beam.distance : previous[0]);
+            q[1] = azimuth[i] + previous[1];
+            q[3] = intensity[i] + (known ? beam.intensity : previous[3]);
+            if (!known) {
+                beam.key = q[2];
+                beam.next = q[2];
+                beam.used = true;
+            }
+            beam.distance = q[0];
+            beam.intensity = q[3];
+            previous = q;
+
+            m_residuals[0][i] = q[0];
+            m_residuals[1][i] = q[1];
+            m_residuals[2][i] = q[2];
+            m_residuals[3][i] = q[3];
+        }
+    } else {
+        for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+            uint32_t *values = m_residuals[c].data();
+            for (uint32_t i = 1; i < numberOfPoints; i++) {
+                values[i] += values[i - 1];
+            }
+        }
+    }
+
+    // Dequantize and interleave the components.
+    for (uint8_t c = 0; c < numberOfComponentsPerPoint; c++) {
+        const uint32_t *values = m_residuals[c].data();
+        float *point = points + c;
+        if (step[c] > 0.0f) {
+            for (uint32_t i = 0; i < numberOfPoints; i++) {
+                point[i * numberOfComponentsPerPoint] = static_cast< float >(static_cast< int32_t >(values[i])) * step[c];
+            }
+        } else {
+            for (uint32_t i = 0; i < numberOfPoints; i++) {
+                point[i * numberOfComponentsPerPoint] = fromOrderedBits(values[i]);
+            }
+        }
+    }
+    return numberOfPoints;
+}
+}
+}
+} // opendlv::core::system
@@ -0,0 +1,186 @@
+/**
+ * pointcloud-compression - Codec for shared point cloud frames.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opendavinci/generated/odcore/data/SharedPointCloud.h>
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/base/Lock.h>
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
+#include "odvdvehicle/generated/opendlv/proxy/PointCloudReadingCompressed.h"
+
+#include "PointCloudCompression.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+using namespace odcore::base;
+using namespace odcore::data;
+using namespace odcore::wrapper;
+
+PointCloudCompression::PointCloudCompression(const int &argc, char **argv)
+    : DataTriggeredConferenceClientModule(argc, argv, "pointcloud-compression")
+    , m_encode(true)
+    , m_name()
+    , m_size(0)
+    , m_quantization()
+    , m_cartesianCodec()
+    , m_polarCodec()
+    , m_sharedMemory()
+    , m_buffer()
+    , m_frame() {
+    m_quantization.fill(0.0f);
+}
+
+PointCloudCompression::~PointCloudCompression() {}
+
+void PointCloudCompression::setUp() {
+    const string mode = getKeyValueConfiguration().getValue< string >("pointcloud-compression.mode");
+    if ("encode" == mode) {
+        m_encode = true;
+    } else if ("decode" == mode) {
+        m_encode = false;
+    } else {
+        throw invalid_argument("Invalid mode! encode: SPC to compressed messages; decode: compressed messages to SPC");
+    }
+    m_name = getKeyValueConfiguration().getValue< string >("pointcloud-compression.name");
+
+    if (m_encode) {
+        // Quantization steps per component; 0 keeps the component lossless.
+        const string quantization = getKeyValueConfiguration().getValue< string >("pointcloud-compression.quantization");
+        vector< string > steps = odcore::strings::StringToolbox::split(quantization, ',');
+        if (steps.size() > PointCloudCodec::MAX_NUMBER_OF_COMPONENTS) {
+            throw invalid_argument("Too many quantization steps!");
+        }
+        for (uint32_t i = 0; i < steps.size(); i++) {
+            m_quantization[i] = stof(steps.at(i));
+        }
+        m_cartesianCodec = unique_ptr< PointCloudCodec >(new PointCloudCodec(PointCloudCodec::CARTESIAN, m_quantization));
+        m_polarCodec = unique_ptr< PointCloudCodec >(new PointCloudCodec(PointCloudCodec::POLAR, m_quantization));
+        cout << "[" << getName() << "] Compressing SPC '" << m_name << "' with steps " << quantization << endl;
+    } else {
+        m_size = getKeyValueConfiguration().getValue< uint32_t >("pointcloud-compression.size");
+        SeqLock seqLock(m_size);
+        m_sharedMemory = SharedMemoryFactory::createSharedMemory(m_name, seqLock.getSegmentSize());
+        if ((m_sharedMemory.get() != NULL) && m_sharedMemory->isValid()) {
+            seqLock.initialize(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+        }
+        m_cartesianCodec = unique_ptr< PointCloudCodec >(new PointCloudCodec(PointCloudCodec::CARTESIAN, m_quantization));
+        cout << "[" << getName() << "] Decompressing into SPC '" << m_name << "' of " << m_size << " bytes" << endl;
+    }
+}
+
+void PointCloudCompression::tearDown() {}
+
+void PointCloudCompression::nextContainer(Container &c) {
+    if (m_encode && (c.getDataType() == SharedPointCloud::ID())) {
+        encode(c);
+    }
+    if (!m_encode && (c.getDataType() == opendlv::proxy::PointCloudReadingCompressed::ID())) {
+        decode(c);
+    }
+}
+
+void PointCloudCompression::encode(Container &c) {
+    SharedPointCloud spc = c.getData< SharedPointCloud >();
+    if ((spc.getName() != m_name) || (SharedPointCloud::FLOAT_T != spc.getComponentDataType())) {
+        return;
+    }
+    // Attach once and keep the segment for the following frames.
+    if ((m_sharedMemory.get() == NULL) || !m_sharedMemory->isValid()) {
+        m_sharedMemory = SharedMemoryFactory::attachToSharedMemory(spc.getName());
+    }
+    if ((m_sharedMemory.get() == NULL) || !m_sharedMemory->isValid()) {
+        return;
+    }
+
+    const uint32_t numberOfComponentsPerPoint = spc.getNumberOfComponentsPerPoint();
+    const uint32_t numberOfPoints = spc.getWidth() * spc.getHeight();
+    if (static_cast< uint64_t >(numberOfPoints) * numberOfComponentsPerPoint * sizeof(float) > m_sharedMemory->getSize()) {
+        cerr << "[" << getName() << "] SPC '" << m_name << "' is larger than its shared memory" << endl;
+        return;
+    }
+    PointCloudCodec &codec = (SharedPointCloud::POLAR_INTENSITY == spc.getUserInfo()) ? *m_polarCodec : *m_cartesianCodec;
+    SeqLock seqLock(spc.getSize());
+    if (seqLock.attach(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize())) {
+        // Copy a consistent frame without blocking the writer.
+        m_frame.resize(numberOfPoints * numberOfComponentsPerPoint);
+        if (!seqLock.read(static_cast< char * >(static_cast< void * >(m_frame.data())), numberOfPoints * numberOfComponentsPerPoint * sizeof(float))) {
+            return;
+        }
+        codec.encode(m_frame.data(), numberOfPoints, static_cast< uint8_t >(numberOfComponentsPerPoint), m_buffer);
+    } else {
+        Lock l(m_sharedMemory);
+        codec.encode(static_cast< const float * >(m_sharedMemory->getSharedMemory()), numberOfPoints, static_cast< uint8_t >(numberOfComponentsPerPoint), m_buffer);
+    }
+
+    opendlv::proxy::PointCloudReadingCompressed pcrc;
+    pcrc.setName(spc.getName());
+    pcrc.setWidth(numberOfPoints);
+    pcrc.setNumberOfComponentsPerPoint(numberOfComponentsPerPoint);
+    pcrc.setUserInfo(spc.getUserInfo());
+    pcrc.setData(m_buffer);
+    Container out(pcrc);
+    out.setSampleTimeStamp(c.getSampleTimeStamp());
+    getConference().send(out);
+}
+
+void PointCloudCompression::decode(Container &c) {
+    opendlv::proxy::PointCloudReadingCompressed pcrc = c.getData< opendlv::proxy::PointCloudReadingCompressed >();
+    if ((pcrc.getName() != m_name) || (m_sharedMemory.get() == NULL) || !m_sharedMemory->isValid()) {
+        return;
+    }
+
+    uint32_t numberOfPoints = 0;
+    SeqLock seqLock(m_size);
+    seqLock.attach(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+    try {
+        Lock l(m_sharedMemory);
+        seqLock.beginWrite();
+        numberOfPoints = m_cartesianCodec->decode(pcrc.getData(), static_cast< float * >(m_sharedMemory->getSharedMemory()), m_size / sizeof(float));
+        seqLock.endWrite();
+    } catch (const invalid_argument &e) {
+        seqLock.endWrite();
+        cerr << "[" << getName() << "] Dropping frame: " << e.what() << endl;
+        return;
+    }
+
+    SharedPointCloud spc;
+    spc.setName(m_sharedMemory->getName());
+    spc.setSize(m_size);
+    spc.setWidth(numberOfPoints);
+    spc.setHeight(1);
+    spc.setNumberOfComponentsPerPoint(pcrc.getNumberOfComponentsPerPoint());
+    spc.setComponentDataType(SharedPointCloud::FLOAT_T);
+    spc.setUserInfo(static_cast< decltype(spc.getUserInfo()) >(pcrc.getUserInfo()));
+    Container out(spc);
+    out.setSampleTimeStamp(c.getSampleTimeStamp());
+    getConference().send(out);
+}
+}
+}
+} // opendlv::core::system
@@ -0,0 +1,207 @@
+/**
+ * pointcloud-compression - Codec for shared point cloud frames.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTCLOUDCOMPRESSION_TESTSUITE_H
+#define POINTCLOUDCOMPRESSION_TESTSUITE_H
+
+#include "cxxtest/TestSuite.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Include local header files.
+#include "../include/PointCloudCodec.h"
+
+using namespace std;
+using namespace opendlv::core::system;
+
+class PointCloudCompressionTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    // Polar frame (distance, azimuth, vertical angle, intensity) of a VLP-16
+    // in a 10m x 20m room as decoded by the Velodyne proxy.
+    vector< float > createPolarFrame() {
+        const float verticalAngles[16] = {-15, 1, -13, 3, -11, 5, -9, 7, -7, 9, -5, 11, -3, 13, -1, 15};
+        const float toRadian = static_cast< float >(M_PI) / 180.0f;
+        vector< float > frame;
+        uint32_t noise = 1;
+        for (uint32_t column = 0; column < 1800; column++) {
+            const float azimuth = static_cast< float >(column) * 0.2f;
+            for (uint32_t beam = 0; beam < 16; beam++) {
+                const float verticalAngle = verticalAngles[beam];
+                float distance = 1.8f / sin(-verticalAngle * toRadian);
+                if (verticalAngle > 0.0f) {
+                    const float toWallX = 10.0f / (fabs(cos(azimuth * toRadian)) + 1e-6f);
+                    const float toWallY = 20.0f / (fabs(sin(azimuth * toRadian)) + 1e-6f);
+                    distance = min(toWallX, toWallY) / cos(verticalAngle * toRadian);
+                }
+                noise = noise * 1103515245u + 12345u;
+                distance = min(distance, 100.0f) + static_cast< float >((noise >> 16) % 20) * 0.002f;
+                // Velodyne distances come in 2mm steps.
+                distance = round(distance * 500.0f) / 500.0f;
+                frame.push_back(distance);
+                frame.push_back(azimuth);
+                frame.push_back(verticalAngle);
+                frame.push_back(static_cast< float >(20 + beam * 3 + ((noise >> 8) % 8)));
+            }
+        }
+        return frame;
+    }
+
+    void testLosslessRoundTrip() {
+        vector< float > frame = createPolarFrame();
+        const uint32_t numberOfPoints = frame.size() / 4;
+        PointCloudCodec codec(PointCloudCodec::POLAR, {{0.0f, 0.0f, 0.0f, 0.0f}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+        TS_ASSERT(PointCloudCodec::getNumberOfPoints(encoded) == numberOfPoints);
+        TS_ASSERT(PointCloudCodec::getNumberOfComponentsPerPoint(encoded) == 4);
+
+        vector< float > decoded(frame.size(), -1.0f);
+        TS_ASSERT(codec.decode(encoded, decoded.data(), decoded.size()) == numberOfPoints);
+        TS_ASSERT(0 == memcmp(frame.data(), decoded.data(), frame.size() * sizeof(float)));
+    }
+
+    void testNearLosslessRoundTrip() {
+        vector< float > frame = createPolarFrame();
+        const uint32_t numberOfPoints = frame.size() / 4;
+        const float steps[4] = {0.002f, 0.01f, 0.01f, 1.0f};
+        PointCloudCodec codec(PointCloudCodec::POLAR, {{steps[0], steps[1], steps[2], steps[3]}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+
+        const float ratio = static_cast< float >(frame.size() * sizeof(float)) / static_cast< float >(encoded.size());
+        cout << "Polar frame of " << numberOfPoints << " points compressed with ratio " << ratio << endl;
+        TS_ASSERT(ratio >= 5.0f);
+
+        vector< float > decoded(frame.size());
+        TS_ASSERT(codec.decode(encoded, decoded.data(), decoded.size()) == numberOfPoints);
+        for (uint32_t i = 0; i < frame.size(); i++) {
+            TS_ASSERT(fabs(frame[i] - decoded[i]) <= steps[i % 4] * 0.5f + 1e-4f);
+        }
+    }
+
+    void testCartesianRoundTrip() {
+        vector< float > frame = createPolarFrame();
+        const float toRadian = static_cast< float >(M_PI) / 180.0f;
+        for (uint32_t i = 0; i < frame.size(); i += 4) {
+            const float distance = frame[i];
+            const float azimuth = frame[i + 1] * toRadian;
+            const float verticalAngle = frame[i + 2] * toRadian;
+            frame[i] = distance * cos(verticalAngle) * sin(azimuth);
+            frame[i + 1] = distance * cos(verticalAngle) * cos(azimuth);
+            frame[i + 2] = distance * sin(verticalAngle);
+        }
+        const uint32_t numberOfPoints = frame.size() / 4;
+        PointCloudCodec codec(PointCloudCodec::CARTESIAN, {{0.001f, 0.001f, 0.001f, 0.0f}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+
+        vector< float > decoded(frame.size());
+        TS_ASSERT(codec.decode(encoded, decoded.data(), decoded.size()) == numberOfPoints);
+        for (uint32_t i = 0; i < frame.size(); i++) {
+            TS_ASSERT(fabs(frame[i] - decoded[i]) <= ((i % 4 == 3) ? 0.0f : 0.0006f));
+        }
+    }
+
+    void testEmptyFrame() {
+        PointCloudCodec codec(PointCloudCodec::POLAR, {{0.0f, 0.0f, 0.0f, 0.0f}});
+        string encoded;
+        codec.encode(NULL, 0, 4, encoded);
+        TS_ASSERT(PointCloudCodec::getNumberOfPoints(encoded) == 0);
+        TS_ASSERT(codec.decode(encoded, NULL, 0) == 0);
+    }
+
+    void testConstantFrame() {
+        // A single symbol per lane must not cost a renormalization per symbol.
+        const uint32_t numberOfPoints = 10000;
+        vector< float > frame(numberOfPoints * 4, 0.0f);
+        PointCloudCodec codec(PointCloudCodec::CARTESIAN, {{0.001f, 0.001f, 0.001f, 0.001f}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 1, encoded);
+        TS_ASSERT(encoded.size() < 100);
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+        TS_ASSERT(encoded.size() < 400);
+
+        vector< float > decoded(frame.size(), 1.0f);
+        TS_ASSERT(codec.decode(encoded, decoded.data(), decoded.size()) == numberOfPoints);
+        TS_ASSERT(0 == memcmp(frame.data(), decoded.data(), frame.size() * sizeof(float)));
+    }
+
+    void testLargeCoordinates() {
+        // 1e7 / 0.001 does not fit into 32 bits; x falls back to lossless coding.
+        const float points[8] = {1e7f, 1.0f, -3e9f, 2.0f, 0.5f, 1.5f, 1e7f, 2.5f};
+        PointCloudCodec codec(PointCloudCodec::CARTESIAN, {{0.001f, 0.001f, 0.001f, 0.001f}});
+        string encoded;
+        codec.encode(points, 4, 2, encoded);
+
+        vector< float > decoded(8);
+        TS_ASSERT(codec.decode(encoded, decoded.data(), decoded.size()) == 4);
+        for (uint32_t i = 0; i < 8; i += 2) {
+            TS_ASSERT(0 == memcmp(&points[i], &decoded[i], sizeof(float)));
+            TS_ASSERT(fabs(points[i + 1] - decoded[i + 1]) <= 0.0005f);
+        }
+    }
+
+    void testMalformedFrames() {
+        vector< float > frame = createPolarFrame();
+        const uint32_t numberOfPoints = frame.size() / 4;
+        PointCloudCodec codec(PointCloudCodec::POLAR, {{0.002f, 0.01f, 0.01f, 1.0f}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+        vector< float > decoded(frame.size());
+
+        // Destination too small.
+        TS_ASSERT_THROWS(codec.decode(encoded, decoded.data(), 4), invalid_argument);
+        // Not a compressed frame.
+        TS_ASSERT_THROWS(codec.decode("Hello World", decoded.data(), decoded.size()), invalid_argument);
+        // Truncated frames.
+        for (uint32_t length = 0; length < encoded.size(); length += 97) {
+            TS_ASSERT_THROWS(codec.decode(encoded.substr(0, length), decoded.data(), decoded.size()), invalid_argument);
+        }
+    }
+
+    void testDecodingThroughput() {
+        vector< float > frame = createPolarFrame();
+        const uint32_t numberOfPoints = frame.size() / 4;
+        PointCloudCodec codec(PointCloudCodec::POLAR, {{0.002f, 0.01f, 0.01f, 1.0f}});
+        string encoded;
+        codec.encode(frame.data(), numberOfPoints, 4, encoded);
+
+        vector< float > decoded(frame.size());
+        const uint32_t ROUNDS = 100;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (uint32_t i = 0; i < ROUNDS; i++) {
+            codec.decode(encoded, decoded.data(), decoded.size());
+        }
+        const double seconds = chrono::duration< double >(chrono::steady_clock::now() - start).count();
+        cout << "Decoding throughput: " << (static_cast< double >(frame.size() * sizeof(float)) * ROUNDS / seconds / 1e9) << " GB/s" << endl;
+        TS_ASSERT(seconds > 0.0);
+    }
+};
+
+#endif /*POINTCLOUDCOMPRESSION_TESTSUITE_H*/
@@ -0,0 +1,78 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MERGEWINDOW_H
+#define MERGEWINDOW_H
+
+#include <stdint.h>
+
+#include <vector>
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+/**
+ * This class selects the frames of the inputs to merge. Input 0 is the
+ * reference: each of its frames is published with the latest not yet
+ * merged frame of every other input that was sampled at most the window
+ * away from it. A frame of another input is thus merged at most once, and
+ * a frame that arrives after its reference frame is merged into the next
+ * one if that is still within the window.
+ */
+class MergeWindow {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param numberOfInputs Number of inputs including the reference.
+     * @param window Largest difference of sample times in microseconds.
+     */
+    MergeWindow(const uint32_t &numberOfInputs, const int64_t &window);
+    virtual ~MergeWindow();
+
+    /**
+     * This method adds a frame; a frame of another input replaces its
+     * previous frame.
+     *
+     * @param input Index of the input.
+     * @param timeStamp Sample time in microseconds.
+     * @return true if the frame is a reference frame and is to be published.
+     */
+    bool add(const uint32_t &input, const int64_t &timeStamp);
+
+    /**
+     * This method selects the frames to merge into a reference frame and
+     * marks them as merged.
+     *
+     * @param timeStamp Sample time of the reference frame in microseconds.
+     * @param inputs Indices of the inputs whose frames are to be merged.
+     */
+    void select(const int64_t &timeStamp, std::vector< uint32_t > &inputs);
+
+   private:
+    std::vector< int64_t > m_timeStamps;
+    std::vector< bool > m_pending; // Frames not merged yet.
+    int64_t m_window;
+};
+}
+}
+} // opendlv::core::system
+
+#endif /*MERGEWINDOW_H*/
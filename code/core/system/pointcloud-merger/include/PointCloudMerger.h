@@ -0,0 +1,89 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTCLOUDMERGER_H
+#define POINTCLOUDMERGER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <opendavinci/generated/odcore/data/SharedPointCloud.h>
+#include <opendavinci/odcore/base/module/DataTriggeredConferenceClientModule.h>
+#include <opendavinci/odcore/data/TimeStamp.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
+
+#include "MergeWindow.h"
+#include "PointTransform.h"
+#include "SeqLock.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+
+/**
+ * This component merges the shared point clouds (SPC) of several lidars into
+ * one SPC in the vehicle frame (x, y, z, intensity).
+ *
+ * Every frame of an input is transformed with the input's mount extrinsics
+ * when it arrives. A frame of the first (reference) input triggers the
+ * merge: it is transformed directly into the output segment, followed by
+ * the frames of the other inputs that the MergeWindow selects. Thus, sensors
+ * that are out of phase are merged into the next reference frame.
+ */
+class PointCloudMerger : public odcore::base::module::DataTriggeredConferenceClientModule {
+   public:
+    PointCloudMerger(int32_t const &, char **);
+    PointCloudMerger(PointCloudMerger const &) = delete;
+    PointCloudMerger &operator=(PointCloudMerger const &) = delete;
+    virtual ~PointCloudMerger();
+    virtual void nextContainer(odcore::data::Container &c);
+
+   private:
+    void setUp();
+    void tearDown();
+
+   private:
+    struct Input {
+        std::string name;
+        PointTransform transform;
+        std::shared_ptr< odcore::wrapper::SharedMemory > sharedMemory;
+        std::vector< float > points;
+        uint32_t numberOfPoints;
+    };
+
+    bool readFrame(Input &input, const odcore::data::SharedPointCloud &spc, float *destination, const uint32_t &capacity);
+    void transform(const Input &input, const odcore::data::SharedPointCloud &spc, const float *points, float *destination, const uint32_t &numberOfPoints) const;
+    void publish(const odcore::data::SharedPointCloud &reference, const odcore::data::TimeStamp &sampleTimeStamp);
+
+   private:
+    std::vector< Input > m_inputs;
+    MergeWindow m_mergeWindow;
+    std::vector< uint32_t > m_selected; // Inputs merged into the reference frame.
+    std::shared_ptr< odcore::wrapper::SharedMemory > m_sharedMemory;
+    std::vector< float > m_frame; // Consistent copy of an input frame.
+    odcore::data::SharedPointCloud m_spc;
+};
+}
+}
+} // opendlv::core::system
+
+#endif /*POINTCLOUDMERGER_H*/
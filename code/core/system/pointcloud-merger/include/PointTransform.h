@@ -0,0 +1,96 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTTRANSFORM_H
+#define POINTTRANSFORM_H
+
+#include <stdint.h>
+
+#include <array>
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+/**
+ * This class transforms points from a sensor's frame into the vehicle frame
+ * using the sensor's mount position and orientation, precomputed as a 3x4
+ * matrix [R | t] with R = Rz(yaw) * Ry(pitch) * Rx(roll).
+ *
+ * Points are stored as four floats each: x, y, z, and intensity, which is
+ * passed through unchanged.
+ */
+class PointTransform {
+   public:
+    /**
+     * Constructor for the identity transform.
+     */
+    PointTransform();
+
+    /**
+     * Constructor.
+     *
+     * @param x Mount position in m.
+     * @param y Mount position in m.
+     * @param z Mount position in m.
+     * @param roll Mount orientation in rad.
+     * @param pitch Mount orientation in rad.
+     * @param yaw Mount orientation in rad.
+     */
+    PointTransform(const float &x, const float &y, const float &z, const float &roll, const float &pitch, const float &yaw);
+
+    virtual ~PointTransform();
+
+    /**
+     * This method transforms cartesian points (SSE when available).
+     *
+     * @param in Points (x, y, z, intensity) in the sensor frame.
+     * @param out Points in the vehicle frame; may be the same as in.
+     * @param numberOfPoints Number of points to transform.
+     */
+    void apply(const float *in, float *out, const uint32_t &numberOfPoints) const;
+
+    /**
+     * This method converts polar points as written by the Velodyne proxies
+     * (distance, azimuth in deg, vertical angle in deg, intensity) into
+     * cartesian ones and transforms them.
+     *
+     * @param in Polar points in the sensor frame.
+     * @param out Cartesian points in the vehicle frame; may be the same as in.
+     * @param numberOfPoints Number of points to transform.
+     */
+    void applyPolar(const float *in, float *out, const uint32_t &numberOfPoints) const;
+
+    /**
+     * This method transforms cartesian points without SIMD instructions.
+     *
+     * @param in Points (x, y, z, intensity) in the sensor frame.
+     * @param out Points in the vehicle frame; may be the same as in.
+     * @param numberOfPoints Number of points to transform.
+     */
+    void applyScalar(const float *in, float *out, const uint32_t &numberOfPoints) const;
+
+   private:
+    std::array< float, 12 > m_matrix; // Row-major 3x4 matrix.
+};
+}
+}
+} // opendlv::core::system
+
+#endif /*POINTTRANSFORM_H*/
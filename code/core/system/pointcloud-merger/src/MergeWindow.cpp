@@ -0,0 +1,59 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstdlib>
+
+#include "MergeWindow.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+
+MergeWindow::MergeWindow(const uint32_t &numberOfInputs, const int64_t &window)
+    : m_timeStamps(numberOfInputs, 0)
+    , m_pending(numberOfInputs, false)
+    , m_window(window) {}
+
+MergeWindow::~MergeWindow() {}
+
+bool MergeWindow::add(const uint32_t &input, const int64_t &timeStamp) {
+    if (0 == input) {
+        return true;
+    }
+    if (input < m_pending.size()) {
+        m_timeStamps[input] = timeStamp;
+        m_pending[input] = true;
+    }
+    return false;
+}
+
+void MergeWindow::select(const int64_t &timeStamp, vector< uint32_t > &inputs) {
+    inputs.clear();
+    for (uint32_t i = 1; i < m_pending.size(); i++) {
+        if (m_pending[i] && (llabs(timeStamp - m_timeStamps[i]) <= m_window)) {
+            inputs.push_back(i);
+            m_pending[i] = false;
+        }
+    }
+}
+}
+}
+} // opendlv::core::system
@@ -0,0 +1,195 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/base/KeyValueConfiguration.h>
+#include <opendavinci/odcore/base/Lock.h>
+#include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/strings/StringToolbox.h>
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
+#include "PointCloudMerger.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+using namespace odcore::base;
+using namespace odcore::data;
+using namespace odcore::wrapper;
+
+PointCloudMerger::PointCloudMerger(const int &argc, char **argv)
+    : DataTriggeredConferenceClientModule(argc, argv, "pointcloud-merger")
+    , m_inputs()
+    , m_mergeWindow(0, 0)
+    , m_selected()
+    , m_sharedMemory()
+    , m_frame()
+    , m_spc() {}
+
+PointCloudMerger::~PointCloudMerger() {}
+
+void PointCloudMerger::setUp() {
+    const float toRadian = static_cast< float >(M_PI) / 180.0f;
+    vector< string > names = odcore::strings::StringToolbox::split(getKeyValueConfiguration().getValue< string >("pointcloud-merger.inputs"), ',');
+    if (names.empty()) {
+        throw invalid_argument("No inputs! pointcloud-merger.inputs lists the shared point clouds to merge");
+    }
+    for (uint32_t i = 0; i < names.size(); i++) {
+        // Mount of input i (counting from 1): x,y,z in m and roll,pitch,yaw in deg.
+        stringstream key;
+        key << "pointcloud-merger.mount" << (i + 1);
+        vector< string > mount = odcore::strings::StringToolbox::split(getKeyValueConfiguration().getValue< string >(key.str()), ',');
+        if (6 != mount.size()) {
+            throw invalid_argument("Invalid " + key.str() + "! Expected x,y,z,roll,pitch,yaw");
+        }
+        Input input;
+        input.name = names.at(i);
+        odcore::strings::StringToolbox::trim(input.name);
+        input.transform = PointTransform(stof(mount.at(0)), stof(mount.at(1)), stof(mount.at(2)), stof(mount.at(3)) * toRadian, stof(mount.at(4)) * toRadian, stof(mount.at(5)) * toRadian);
+        input.numberOfPoints = 0;
+        m_inputs.push_back(input);
+        cout << "[" << getName() << "] Merging '" << input.name << "' mounted at " << key.str() << endl;
+    }
+    const int64_t window = static_cast< int64_t >(getKeyValueConfiguration().getValue< uint32_t >("pointcloud-merger.window")) * 1000;
+    m_mergeWindow = MergeWindow(static_cast< uint32_t >(m_inputs.size()), window);
+
+    const string name = getKeyValueConfiguration().getValue< string >("pointcloud-merger.name");
+    const uint32_t size = getKeyValueConfiguration().getValue< uint32_t >("pointcloud-merger.size");
+    SeqLock seqLock(size);
+    m_sharedMemory = SharedMemoryFactory::createSharedMemory(name, seqLock.getSegmentSize());
+    if ((m_sharedMemory.get() != NULL) && m_sharedMemory->isValid()) {
+        seqLock.initialize(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+    }
+
+    m_spc.setName(name);
+    m_spc.setSize(size);
+    m_spc.setHeight(1);
+    m_spc.setNumberOfComponentsPerPoint(4);
+    m_spc.setComponentDataType(SharedPointCloud::FLOAT_T);
+    m_spc.setUserInfo(SharedPointCloud::XYZ_INTENSITY);
+}
+
+void PointCloudMerger::tearDown() {}
+
+void PointCloudMerger::nextContainer(Container &c) {
+    if (c.getDataType() != SharedPointCloud::ID()) {
+        return;
+    }
+    SharedPointCloud spc = c.getData< SharedPointCloud >();
+    for (uint32_t i = 0; i < m_inputs.size(); i++) {
+        Input &input = m_inputs[i];
+        if (input.name != spc.getName()) {
+            continue;
+        }
+        if (0 != i) {
+            input.points.resize(spc.getWidth() * spc.getHeight() * 4);
+            if (!readFrame(input, spc, input.points.data(), spc.getWidth() * spc.getHeight())) {
+                break;
+            }
+        }
+        if (m_mergeWindow.add(i, c.getSampleTimeStamp().toMicroseconds())) {
+            publish(spc, c.getSampleTimeStamp());
+        }
+        break;
+    }
+}
+
+bool PointCloudMerger::readFrame(Input &input, const SharedPointCloud &spc, float *destination, const uint32_t &capacity) {
+    if ((SharedPointCloud::FLOAT_T != spc.getComponentDataType()) || (4 != spc.getNumberOfComponentsPerPoint())) {
+        return false;
+    }
+    // Attach once and keep the segment for the following frames.
+    if ((input.sharedMemory.get() == NULL) || !input.sharedMemory->isValid()) {
+        input.sharedMemory = SharedMemoryFactory::attachToSharedMemory(input.name);
+    }
+    if ((input.sharedMemory.get() == NULL) || !input.sharedMemory->isValid()) {
+        return false;
+    }
+
+    uint32_t numberOfPoints = spc.getWidth() * spc.getHeight();
+    numberOfPoints = min(numberOfPoints, static_cast< uint32_t >(input.sharedMemory->getSize() / (4 * sizeof(float))));
+    numberOfPoints = min(numberOfPoints, capacity);
+
+    SeqLock seqLock(spc.getSize());
+    if (seqLock.attach(static_cast< char * >(input.sharedMemory->getSharedMemory()), input.sharedMemory->getSize())) {
+        // Copy a consistent frame without blocking the writer.
+        m_frame.resize(4 * numberOfPoints);
+        if (!seqLock.read(static_cast< char * >(static_cast< void * >(m_frame.data())), 4 * numberOfPoints * sizeof(float))) {
+            return false;
+        }
+        transform(input, spc, m_frame.data(), destination, numberOfPoints);
+    } else {
+        Lock l(input.sharedMemory);
+        transform(input, spc, static_cast< const float * >(input.sharedMemory->getSharedMemory()), destination, numberOfPoints);
+    }
+    input.numberOfPoints = numberOfPoints;
+    return true;
+}
+
+void PointCloudMerger::transform(const Input &input, const SharedPointCloud &spc, const float *points, float *destination, const uint32_t &numberOfPoints) const {
+    if (SharedPointCloud::POLAR_INTENSITY == spc.getUserInfo()) {
+        input.transform.applyPolar(points, destination, numberOfPoints);
+    } else {
+        input.transform.apply(points, destination, numberOfPoints);
+    }
+}
+
+void PointCloudMerger::publish(const SharedPointCloud &reference, const TimeStamp &sampleTimeStamp) {
+    if ((m_sharedMemory.get() == NULL) || !m_sharedMemory->isValid()) {
+        return;
+    }
+    const uint32_t capacity = m_spc.getSize() / (4 * sizeof(float));
+    uint32_t numberOfPoints = 0;
+    SeqLock seqLock(m_spc.getSize());
+    seqLock.attach(static_cast< char * >(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+    {
+        Lock l(m_sharedMemory);
+        seqLock.beginWrite();
+        float *points = static_cast< float * >(m_sharedMemory->getSharedMemory());
+        // The reference frame goes directly into the output segment.
+        if (readFrame(m_inputs[0], reference, points, capacity)) {
+            numberOfPoints = m_inputs[0].numberOfPoints;
+        }
+        m_mergeWindow.select(sampleTimeStamp.toMicroseconds(), m_selected);
+        for (uint32_t i = 0; i < m_selected.size(); i++) {
+            const Input &input = m_inputs[m_selected[i]];
+            const uint32_t n = min(input.numberOfPoints, capacity - numberOfPoints);
+            memcpy(points + 4 * numberOfPoints, input.points.data(), n * 4 * sizeof(float));
+            numberOfPoints += n;
+        }
+        seqLock.endWrite();
+    }
+
+    m_spc.setWidth(numberOfPoints);
+    Container c(m_spc);
+    c.setSampleTimeStamp(sampleTimeStamp);
+    getConference().send(c);
+}
+}
+}
+} // opendlv::core::system
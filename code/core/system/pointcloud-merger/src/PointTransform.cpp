@@ -0,0 +1,110 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cmath>
+
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include "PointTransform.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+
+using namespace std;
+
+PointTransform::PointTransform()
+    : m_matrix() {
+    m_matrix = {{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f}};
+}
+
+PointTransform::PointTransform(const float &x, const float &y, const float &z, const float &roll, const float &pitch, const float &yaw)
+    : m_matrix() {
+    const float cr = cos(roll);
+    const float sr = sin(roll);
+    const float cp = cos(pitch);
+    const float sp = sin(pitch);
+    const float cy = cos(yaw);
+    const float sy = sin(yaw);
+
+    // R = Rz(yaw) * Ry(pitch) * Rx(roll), t = (x, y, z).
+    m_matrix = {{cy * cp, cy * sp * sr - sy * cr, cy * sp * cr + sy * sr, x,
+                 sy * cp, sy * sp * sr + cy * cr, sy * sp * cr - cy * sr, y,
+                 -sp, cp * sr, cp * cr, z}};
+}
+
+PointTransform::~PointTransform() {}
+
+void PointTransform::applyScalar(const float *in, float *out, const uint32_t &numberOfPoints) const {
+    const float *m = m_matrix.data();
+    for (uint32_t i = 0; i < numberOfPoints; i++) {
+        const float x = in[4 * i];
+        const float y = in[4 * i + 1];
+        const float z = in[4 * i + 2];
+        out[4 * i] = m[0] * x + m[1] * y + m[2] * z + m[3];
+        out[4 * i + 1] = m[4] * x + m[5] * y + m[6] * z + m[7];
+        out[4 * i + 2] = m[8] * x + m[9] * y + m[10] * z + m[11];
+        out[4 * i + 3] = in[4 * i + 3];
+    }
+}
+
+void PointTransform::apply(const float *in, float *out, const uint32_t &numberOfPoints) const {
+#if defined(__SSE__)
+    // One point fills one register: out = x * c0 + y * c1 + z * c2 + i * e3 + t,
+    // where c0-c2 are the matrix columns and e3 passes the intensity through.
+    const float *m = m_matrix.data();
+    const __m128 c0 = _mm_setr_ps(m[0], m[4], m[8], 0.0f);
+    const __m128 c1 = _mm_setr_ps(m[1], m[5], m[9], 0.0f);
+    const __m128 c2 = _mm_setr_ps(m[2], m[6], m[10], 0.0f);
+    const __m128 e3 = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    const __m128 t = _mm_setr_ps(m[3], m[7], m[11], 0.0f);
+    for (uint32_t i = 0; i < numberOfPoints; i++) {
+        const __m128 p = _mm_loadu_ps(in + 4 * i);
+        __m128 r = _mm_add_ps(t, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)), c0));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1)), c1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2)), c2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)), e3));
+        _mm_storeu_ps(out + 4 * i, r);
+    }
+#else
+    applyScalar(in, out, numberOfPoints);
+#endif
+}
+
+void PointTransform::applyPolar(const float *in, float *out, const uint32_t &numberOfPoints) const {
+    const float toRadian = static_cast< float >(M_PI) / 180.0f;
+    for (uint32_t i = 0; i < numberOfPoints; i++) {
+        const float distance = in[4 * i];
+        const float azimuth = in[4 * i + 1] * toRadian;
+        const float verticalAngle = in[4 * i + 2] * toRadian;
+        const float intensity = in[4 * i + 3];
+        // Same convention as the Velodyne decoders.
+        const float xyDistance = distance * cos(verticalAngle);
+        out[4 * i] = xyDistance * sin(azimuth);
+        out[4 * i + 1] = xyDistance * cos(azimuth);
+        out[4 * i + 2] = distance * sin(verticalAngle);
+        out[4 * i + 3] = intensity;
+    }
+    apply(out, out, numberOfPoints);
+}
+}
+}
+} // opendlv::core::system
@@ -0,0 +1,147 @@
+/**
+ * pointcloud-merger - Merges point clouds into the vehicle frame.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef POINTCLOUDMERGER_TESTSUITE_H
+#define POINTCLOUDMERGER_TESTSUITE_H
+
+#include "cxxtest/TestSuite.h"
+
+#include <cmath>
+#include <vector>
+
+// Include local header files.
+#include "../include/MergeWindow.h"
+#include "../include/PointTransform.h"
+
+using namespace std;
+using namespace opendlv::core::system;
+
+class PointCloudMergerTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    void testIdentity() {
+        PointTransform t;
+        const float in[8] = {1.0f, 2.0f, 3.0f, 4.0f, -5.0f, 6.0f, -7.0f, 8.0f};
+        float out[8];
+        t.apply(in, out, 2);
+        for (uint32_t i = 0; i < 8; i++) {
+            TS_ASSERT_DELTA(out[i], in[i], 1e-6f);
+        }
+    }
+
+    void testMount() {
+        // Sensor 1m ahead and 2m up, turned left by 90deg: its x axis
+        // points along the vehicle's y axis.
+        PointTransform t(1.0f, 0.0f, 2.0f, 0.0f, 0.0f, static_cast< float >(M_PI) / 2.0f);
+        const float in[4] = {10.0f, 0.0f, 0.5f, 42.0f};
+        float out[4];
+        t.apply(in, out, 1);
+        TS_ASSERT_DELTA(out[0], 1.0f, 1e-5f);
+        TS_ASSERT_DELTA(out[1], 10.0f, 1e-5f);
+        TS_ASSERT_DELTA(out[2], 2.5f, 1e-5f);
+        TS_ASSERT_DELTA(out[3], 42.0f, 1e-6f);
+    }
+
+    void testSimdMatchesScalar() {
+        PointTransform t(0.5f, -1.2f, 1.9f, 0.02f, -0.03f, 2.8f);
+        vector< float > in;
+        for (uint32_t i = 0; i < 1000; i++) {
+            in.push_back(static_cast< float >(i % 37) - 18.0f);
+            in.push_back(static_cast< float >(i % 53) * 0.5f);
+            in.push_back(static_cast< float >(i % 7) - 3.0f);
+            in.push_back(static_cast< float >(i % 256));
+        }
+        vector< float > simd(in.size());
+        vector< float > scalar(in.size());
+        t.apply(in.data(), simd.data(), 1000);
+        t.applyScalar(in.data(), scalar.data(), 1000);
+        for (uint32_t i = 0; i < in.size(); i++) {
+            TS_ASSERT_DELTA(simd[i], scalar[i], 1e-4f);
+        }
+
+        // In-place transformation.
+        t.apply(in.data(), in.data(), 1000);
+        for (uint32_t i = 0; i < in.size(); i++) {
+            TS_ASSERT_DELTA(in[i], scalar[i], 1e-4f);
+        }
+    }
+
+    void testPolar() {
+        PointTransform t(0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+        // 10m at azimuth 90deg (x axis) and 0deg (y axis), 30deg upwards.
+        const float in[8] = {10.0f, 90.0f, 0.0f, 7.0f, 10.0f, 0.0f, 30.0f, 9.0f};
+        float out[8];
+        t.applyPolar(in, out, 2);
+        TS_ASSERT_DELTA(out[0], 10.0f, 1e-4f);
+        TS_ASSERT_DELTA(out[1], 0.0f, 1e-4f);
+        TS_ASSERT_DELTA(out[2], 1.0f, 1e-4f);
+        TS_ASSERT_DELTA(out[3], 7.0f, 1e-6f);
+        TS_ASSERT_DELTA(out[4], 0.0f, 1e-4f);
+        TS_ASSERT_DELTA(out[5], 10.0f * cos(static_cast< float >(M_PI) / 6.0f), 1e-4f);
+        TS_ASSERT_DELTA(out[6], 1.0f + 5.0f, 1e-4f);
+        TS_ASSERT_DELTA(out[7], 9.0f, 1e-6f);
+    }
+
+    void testMergeWindow() {
+        // Input 0 is the reference; the window is 10 ms.
+        MergeWindow window(3, 10000);
+        vector< uint32_t > inputs;
+
+        // Only a reference frame is published.
+        TS_ASSERT(!window.add(1, 95000));
+        TS_ASSERT(!window.add(2, 80000));
+        TS_ASSERT(window.add(0, 100000));
+        window.select(100000, inputs);
+        TS_ASSERT(inputs.size() == 1);
+        TS_ASSERT(inputs[0] == 1);
+
+        // A merged frame is not merged again; the frame out of the window stays.
+        TS_ASSERT(window.add(0, 105000));
+        window.select(105000, inputs);
+        TS_ASSERT(inputs.empty());
+
+        // A frame that arrives after its reference frame is merged into the next one.
+        TS_ASSERT(window.add(0, 200000));
+        window.select(200000, inputs);
+        TS_ASSERT(inputs.empty());
+        TS_ASSERT(!window.add(1, 199000));
+        TS_ASSERT(!window.add(2, 201000));
+        TS_ASSERT(window.add(0, 208000));
+        window.select(208000, inputs);
+        TS_ASSERT(inputs.size() == 2);
+        window.select(208000, inputs);
+        TS_ASSERT(inputs.empty());
+
+        // A late frame that is out of the window is not merged.
+        TS_ASSERT(!window.add(1, 250000));
+        window.select(300000, inputs);
+        TS_ASSERT(inputs.empty());
+
+        // A newer frame replaces the pending one.
+        TS_ASSERT(!window.add(1, 310000));
+        window.select(320000, inputs);
+        TS_ASSERT(inputs.size() == 1);
+        TS_ASSERT(inputs[0] == 1);
+    }
+};
+
+#endif /*POINTCLOUDMERGER_TESTSUITE_H*/
@@ -21,7 +21,10 @@
 #ifndef PROXY_APPLANIXSTRINGDECODER_H
 #define PROXY_APPLANIXSTRINGDECODER_H
 
-#include <sstream>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
 
 #include <opendavinci/odcore/io/StringListener.h>
 #include <opendavinci/odcore/io/conference/ContainerConference.h>
@@ -33,15 +36,42 @@ namespace core {
 namespace system {
 namespace proxy {
 
+/**
+ * This class reads the fields of a group in place from the receive buffer.
+ * Reading beyond the end of the group leaves the destination unchanged and
+ * makes good() return false.
+ */
+class GrpPayload {
+   public:
+    GrpPayload(const char *data, const uint32_t &size);
+
+    bool good() const;
+    void read(char *destination, const uint32_t &size);
+
+   private:
+    const char *m_data;
+    uint32_t m_size;
+    uint32_t m_position;
+    bool m_good;
+};
+
 /**
  * This class decodes data from the Applanix unit.
+ *
+ * The received bytes are appended to a buffer of fixed capacity. Groups
+ * are found by searching for "$GRP" and decoded in place once complete; a
+ * group needs a known group number, a byte count that matches the layout of
+ * that group, and the group end "$#" where its byte count says. Thus, a
+ * false group start is skipped without waiting for its byte count. The
+ * unconsumed tail of the buffer, at most one incomplete group, is only
+ * moved to the front when the buffer is full.
  */
 class ApplanixStringDecoder : public odcore::io::StringListener {
    private:
         enum GRP_SIZES {
             GRP_HEADER_SIZE             = 8,
-            GRP_FOOTER_SIZE             = 4,
-            TIME_DISTANCE_FIELD_SIZE    = 26,
+            GRP_MAX_PADDING             = 3,
+            BUFFER_CAPACITY             = 131072, // Holds two groups of the largest byte count.
         };
 
         enum ApplanixMessages {
@@ -66,27 +96,42 @@ class ApplanixStringDecoder : public odcore::io::StringListener {
 
     virtual void nextString(const std::string &s);
 
+    /**
+     * @return Number of received bytes that did not belong to a decoded group.
+     */
+    uint64_t getSkippedBytes() const;
+
    private:
-    void prepareReadingBuffer(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::TimeDistance getTimeDistance(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp1Data getGRP1(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp2Data getGRP2(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp3Data getGRP3(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::GNSSReceiverChannelStatus getGNSSReceiverChannelStatus(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp4Data getGRP4(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp10001Data getGRP10001(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp10002Data getGRP10002(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp10003Data getGRP10003(std::stringstream &buffer);
-    opendlv::core::sensors::applanix::Grp10009Data getGRP10009(std::stringstream &buffer);
+    void decodeGroups();
+    /**
+     * This method determines the byte count that the layout of a group
+     * requires, including checksum and group end but without padding.
+     *
+     * @param message Group to check.
+     * @param payload Received bytes after the group header.
+     * @param available Number of received bytes after the group header.
+     * @param byteCount Required byte count.
+     * @return false if the length field of a variable group is not received yet.
+     */
+    bool getLayoutByteCount(const ApplanixMessages &message, const char *payload, const uint32_t &available, uint32_t &byteCount) const;
+    void decodeGroup(const ApplanixMessages &message, GrpPayload &buffer);
+    opendlv::core::sensors::applanix::TimeDistance getTimeDistance(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp1Data getGRP1(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp2Data getGRP2(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp3Data getGRP3(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::GNSSReceiverChannelStatus getGNSSReceiverChannelStatus(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp4Data getGRP4(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp10001Data getGRP10001(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp10002Data getGRP10002(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp10003Data getGRP10003(GrpPayload &buffer);
+    opendlv::core::sensors::applanix::Grp10009Data getGRP10009(GrpPayload &buffer);
 
    private:
     odcore::io::conference::ContainerConference &m_conference;
-    std::stringstream m_buffer;
-    bool m_foundHeader;
-    bool m_buffering;
-    uint32_t m_payloadSize;
-    uint32_t m_toRemove;
-    ApplanixMessages m_nextApplanixMessage;
+    std::vector< char > m_buffer;
+    uint32_t m_begin; // First unconsumed byte.
+    uint32_t m_end; // End of the received bytes.
+    uint64_t m_skippedBytes;
 
 };
 }
@@ -18,8 +18,11 @@
  * USA.
  */
 
+#include <endian.h>
+
+#include <algorithm>
+#include <cstring>
 #include <iostream>
-#include <sstream>
 #include <string>
 
 #include <opendavinci/odcore/data/Container.h>
@@ -36,33 +39,39 @@ namespace proxy {
 using namespace std;
 using namespace odcore::data;
 
+GrpPayload::GrpPayload(const char *data, const uint32_t &size)
+    : m_data(data)
+    , m_size(size)
+    , m_position(0)
+    , m_good(true) {}
+
+bool GrpPayload::good() const {
+    return m_good;
+}
+
+void GrpPayload::read(char *destination, const uint32_t &size) {
+    if (!m_good || (size > m_size - m_position)) {
+        m_good = false;
+        return;
+    }
+    memcpy(destination, m_data + m_position, size);
+    m_position += size;
+}
+
 ApplanixStringDecoder::ApplanixStringDecoder(odcore::io::conference::ContainerConference &conference)
     : m_conference(conference)
-    , m_buffer()
-    , m_foundHeader(false)
-    , m_buffering(false)
-    , m_payloadSize(0)
-    , m_toRemove(0)
-    , m_nextApplanixMessage(ApplanixStringDecoder::UNKNOWN) {}
+    , m_buffer(ApplanixStringDecoder::BUFFER_CAPACITY)
+    , m_begin(0)
+    , m_end(0)
+    , m_skippedBytes(0) {}
 
 ApplanixStringDecoder::~ApplanixStringDecoder() {}
 
-void ApplanixStringDecoder::prepareReadingBuffer(std::stringstream &_buffer) {
-    if (_buffer.good()) {
-        uint16_t buffer = 0;
-        _buffer.read((char *)(&(buffer)), sizeof(buffer));
-        buffer = le32toh(buffer);
-        m_payloadSize = buffer;
-
-        m_foundHeader = true;
-        m_buffering = true;
-
-        // Skip GRP header.
-        m_toRemove += ApplanixStringDecoder::GRP_HEADER_SIZE;
-    }
+uint64_t ApplanixStringDecoder::getSkippedBytes() const {
+    return m_skippedBytes;
 }
 
-opendlv::core::sensors::applanix::TimeDistance ApplanixStringDecoder::getTimeDistance(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::TimeDistance ApplanixStringDecoder::getTimeDistance(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::TimeDistance timedist;
 
     if (buffer.good()) {
@@ -89,7 +98,7 @@ opendlv::core::sensors::applanix::TimeDistance ApplanixStringDecoder::getTimeDis
     return timedist;
 }
 
-opendlv::core::sensors::applanix::Grp1Data ApplanixStringDecoder::getGRP1(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp1Data ApplanixStringDecoder::getGRP1(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp1Data g1Data;
 
     if (buffer.good()) {
@@ -164,7 +173,7 @@ opendlv::core::sensors::applanix::Grp1Data ApplanixStringDecoder::getGRP1(std::s
     return g1Data;
 }
 
-opendlv::core::sensors::applanix::Grp2Data ApplanixStringDecoder::getGRP2(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp2Data ApplanixStringDecoder::getGRP2(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp2Data g2Data;
 
     if (buffer.good()) {
@@ -218,7 +227,7 @@ opendlv::core::sensors::applanix::Grp2Data ApplanixStringDecoder::getGRP2(std::s
     return g2Data;
 }
 
-opendlv::core::sensors::applanix::GNSSReceiverChannelStatus ApplanixStringDecoder::getGNSSReceiverChannelStatus(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::GNSSReceiverChannelStatus ApplanixStringDecoder::getGNSSReceiverChannelStatus(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::GNSSReceiverChannelStatus gnss;
 
     if (buffer.good()) {
@@ -251,7 +260,7 @@ opendlv::core::sensors::applanix::GNSSReceiverChannelStatus ApplanixStringDecode
     return gnss;
 }
 
-opendlv::core::sensors::applanix::Grp3Data ApplanixStringDecoder::getGRP3(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp3Data ApplanixStringDecoder::getGRP3(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp3Data g3Data;
 
     if (buffer.good()) {
@@ -323,7 +332,7 @@ opendlv::core::sensors::applanix::Grp3Data ApplanixStringDecoder::getGRP3(std::s
     return g3Data;
 }
 
-opendlv::core::sensors::applanix::Grp4Data ApplanixStringDecoder::getGRP4(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp4Data ApplanixStringDecoder::getGRP4(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp4Data g4Data;
 
     if (buffer.good()) {
@@ -358,7 +367,7 @@ opendlv::core::sensors::applanix::Grp4Data ApplanixStringDecoder::getGRP4(std::s
     return g4Data;
 }
 
-opendlv::core::sensors::applanix::Grp10001Data ApplanixStringDecoder::getGRP10001(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp10001Data ApplanixStringDecoder::getGRP10001(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp10001Data g10001Data;
 
     if (buffer.good()) {
@@ -368,8 +377,7 @@ opendlv::core::sensors::applanix::Grp10001Data ApplanixStringDecoder::getGRP1000
         uint16_t GNSS_receiver_type = 0;
         uint32_t reserved           = 0;
         uint16_t byte_count         = 0;
-        vector<char> GNSS_receiver_raw_data;
-        uint8_t pad                 = 0;
+        string GNSS_receiver_raw_data;
 
         buffer.read((char *)(&(GNSS_receiver_type)), sizeof(GNSS_receiver_type));
         GNSS_receiver_type = le16toh(GNSS_receiver_type);
@@ -377,17 +385,13 @@ opendlv::core::sensors::applanix::Grp10001Data ApplanixStringDecoder::getGRP1000
         buffer.read((char *)(&(byte_count)), sizeof(byte_count));
         byte_count = le16toh(byte_count);
 
-        // Reserve storage.
-        GNSS_receiver_raw_data.reserve(byte_count);
+        GNSS_receiver_raw_data.resize(byte_count);
         buffer.read(&GNSS_receiver_raw_data[0], byte_count);
 
-        // Read padding.
-        for(uint8_t paddingToRead = 0; paddingToRead < ((m_payloadSize - TIME_DISTANCE_FIELD_SIZE - sizeof(GNSS_receiver_type) - sizeof(reserved) - sizeof(byte_count) - byte_count - ApplanixStringDecoder::GRP_FOOTER_SIZE)); paddingToRead++) {
-            buffer.read((char *)(&(pad)), sizeof(pad));
-        }
+        // The padding is skipped with the group.
 
         g10001Data.setGNSS_receiver_type(GNSS_receiver_type);
-        g10001Data.setGNSS_receiver_raw_data(string(&GNSS_receiver_raw_data[0], byte_count));
+        g10001Data.setGNSS_receiver_raw_data(GNSS_receiver_raw_data);
 
         g10001Data.setTimeDistance(timedist);
     }
@@ -395,7 +399,7 @@ opendlv::core::sensors::applanix::Grp10001Data ApplanixStringDecoder::getGRP1000
     return g10001Data;
 }
 
-opendlv::core::sensors::applanix::Grp10002Data ApplanixStringDecoder::getGRP10002(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp10002Data ApplanixStringDecoder::getGRP10002(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp10002Data g10002Data;
 
     if (buffer.good()) {
@@ -405,28 +409,23 @@ opendlv::core::sensors::applanix::Grp10002Data ApplanixStringDecoder::getGRP1000
         const uint16_t LENGTH_IMUHEADER = 6;
         char imuheader[LENGTH_IMUHEADER];
         uint16_t byte_count = 0;
-        vector<char> imu_raw_data;
+        string imu_raw_data;
         int16_t data_checksum = 0;
-        uint8_t pad         = 0;
 
         buffer.read(imuheader, sizeof(imuheader));
         buffer.read((char *)(&(byte_count)), sizeof(byte_count));
         byte_count = le16toh(byte_count);
 
-        // Reserve storage.
-        imu_raw_data.reserve(byte_count);
+        imu_raw_data.resize(byte_count);
         buffer.read(&imu_raw_data[0], byte_count);
 
         buffer.read((char *)(&(data_checksum)), sizeof(data_checksum));
         data_checksum = le16toh(data_checksum);
 
-        // Read padding.
-        for(uint8_t paddingToRead = 0; paddingToRead < ((m_payloadSize - TIME_DISTANCE_FIELD_SIZE - LENGTH_IMUHEADER - sizeof(byte_count) - byte_count - sizeof(data_checksum) - ApplanixStringDecoder::GRP_FOOTER_SIZE)); paddingToRead++) {
-            buffer.read((char *)(&(pad)), sizeof(pad));
-        }
+        // The padding is skipped with the group.
 
         g10002Data.setImuheader(string(imuheader, LENGTH_IMUHEADER));
-        g10002Data.setImu_raw_data(string(&imu_raw_data[0], byte_count));
+        g10002Data.setImu_raw_data(imu_raw_data);
         g10002Data.setDatachecksum(data_checksum);
 
         g10002Data.setTimeDistance(timedist);
@@ -435,7 +434,7 @@ opendlv::core::sensors::applanix::Grp10002Data ApplanixStringDecoder::getGRP1000
     return g10002Data;
 }
 
-opendlv::core::sensors::applanix::Grp10003Data ApplanixStringDecoder::getGRP10003(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp10003Data ApplanixStringDecoder::getGRP10003(GrpPayload &buffer) {
     opendlv::core::sensors::applanix::Grp10003Data g10003Data;
 
     if (buffer.good()) {
@@ -457,7 +456,7 @@ opendlv::core::sensors::applanix::Grp10003Data ApplanixStringDecoder::getGRP1000
     return g10003Data;
 }
 
-opendlv::core::sensors::applanix::Grp10009Data ApplanixStringDecoder::getGRP10009(std::stringstream &buffer) {
+opendlv::core::sensors::applanix::Grp10009Data ApplanixStringDecoder::getGRP10009(GrpPayload &buffer) {
     // Grp10009 message is identical to Grp10001. Thus, re-use the decoder and simply copy the data.
     opendlv::core::sensors::applanix::Grp10001Data g10001Data = getGRP10001(buffer);
 
@@ -469,201 +468,212 @@ opendlv::core::sensors::applanix::Grp10009Data ApplanixStringDecoder::getGRP1000
     return g10009Data;
 }
 
+void ApplanixStringDecoder::decodeGroup(const ApplanixMessages &message, GrpPayload &buffer) {
+    if (ApplanixStringDecoder::GRP1 == message) {
+        // Decode Applanix GRP1.
+        opendlv::core::sensors::applanix::Grp1Data g1Data = getGRP1(buffer);
+        Container c(g1Data);
+        m_conference.send(c);
+
+        // Create generic message.
+        opendlv::data::environment::WGS84Coordinate wgs84(g1Data.getLat(), g1Data.getLon());
+        Container c2(wgs84);
+        m_conference.send(c2);
+    }
+    else if (ApplanixStringDecoder::GRP2 == message) {
+        // Decode Applanix GRP2.
+        opendlv::core::sensors::applanix::Grp2Data g2Data = getGRP2(buffer);
+
+        Container c(g2Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP3 == message) {
+        // Decode Applanix GRP3.
+        opendlv::core::sensors::applanix::Grp3Data g3Data = getGRP3(buffer);
+
+        Container c(g3Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP4 == message) {
+        // Decode Applanix GRP4.
+        opendlv::core::sensors::applanix::Grp4Data g4Data = getGRP4(buffer);
+
+        Container c(g4Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP10001 == message) {
+        // Decode Applanix GRP10001.
+        opendlv::core::sensors::applanix::Grp10001Data g10001Data = getGRP10001(buffer);
+
+        Container c(g10001Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP10002 == message) {
+        // Decode Applanix GRP10002.
+        opendlv::core::sensors::applanix::Grp10002Data g10002Data = getGRP10002(buffer);
+
+        Container c(g10002Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP10003 == message) {
+        // Decode Applanix GRP10003.
+        opendlv::core::sensors::applanix::Grp10003Data g10003Data = getGRP10003(buffer);
+
+        Container c(g10003Data);
+        m_conference.send(c);
+    }
+    else if (ApplanixStringDecoder::GRP10009 == message) {
+        // Decode Applanix GRP10009.
+        opendlv::core::sensors::applanix::Grp10009Data g10009Data = getGRP10009(buffer);
+
+        Container c(g10009Data);
+        m_conference.send(c);
+    }
+    else {
+        // Unknown message.
+    }
+}
+
 void ApplanixStringDecoder::nextString(std::string const &data) {
-    // Add data to the end...
-    m_buffer.seekp(0, std::ios_base::end);
-    m_buffer.write(data.c_str(), data.size());
-
-    // ...but always read from the beginning.
-    m_buffer.seekg(m_toRemove, std::ios_base::beg);
-
-    while ((static_cast<uint32_t>(m_buffer.tellg()) + m_toRemove + ApplanixStringDecoder::GRP_HEADER_SIZE) < m_buffer.tellp()) {
-        // Wait for more data if put pointer is smaller than expected buffer fill level.
-        if (     m_buffering
-            && (   (static_cast<uint32_t>(m_buffer.tellp())
-                 - (static_cast<uint32_t>(m_buffer.tellg()) + m_toRemove))
-                    < m_payloadSize
-               )
-           ) {
+    const char *input = data.data();
+    uint32_t remaining = static_cast<uint32_t>(data.size());
+    while (remaining > 0) {
+        // Only the unconsumed tail is moved, which is less than one group.
+        if ((m_end == m_buffer.size()) && (m_begin > 0)) {
+            memmove(&m_buffer[0], &m_buffer[m_begin], m_end - m_begin);
+            m_end -= m_begin;
+            m_begin = 0;
+        }
+        const uint32_t length = std::min(remaining, static_cast<uint32_t>(m_buffer.size()) - m_end);
+        memcpy(&m_buffer[m_end], input, length);
+        m_end += length;
+        input += length;
+        remaining -= length;
+
+        decodeGroups();
+    }
+}
+
+bool ApplanixStringDecoder::getLayoutByteCount(const ApplanixMessages &message, const char *payload, const uint32_t &available, uint32_t &byteCount) const {
+    // Byte count of the fixed part and offset of the length field of the
+    // variable part in the payload.
+    uint32_t fixedByteCount = 0;
+    uint32_t lengthOffset = 0;
+    switch (message) {
+        case ApplanixStringDecoder::GRP1:
+            fixedByteCount = 132;
+            break;
+        case ApplanixStringDecoder::GRP2:
+            fixedByteCount = 80;
+            break;
+        case ApplanixStringDecoder::GRP3:
+            // Followed by the channel status of all tracked satellites.
+            fixedByteCount = 76;
+            lengthOffset = 28;
+            break;
+        case ApplanixStringDecoder::GRP4:
+            fixedByteCount = 60;
+            break;
+        case ApplanixStringDecoder::GRP10001:
+        case ApplanixStringDecoder::GRP10009:
+            // Followed by the raw data of the GNSS receiver.
+            fixedByteCount = 38;
+            lengthOffset = 32;
+            break;
+        case ApplanixStringDecoder::GRP10002:
+            // Followed by the raw data of the IMU.
+            fixedByteCount = 40;
+            lengthOffset = 32;
             break;
+        case ApplanixStringDecoder::GRP10003:
+            fixedByteCount = 36;
+            break;
+        default:
+            break;
+    }
+
+    byteCount = fixedByteCount;
+    if (lengthOffset > 0) {
+        uint16_t variableByteCount = 0;
+        if (available < lengthOffset + sizeof(variableByteCount)) {
+            return false;
         }
+        memcpy(&variableByteCount, payload + lengthOffset, sizeof(variableByteCount));
+        byteCount += le16toh(variableByteCount);
+    }
+    return true;
+}
 
-        // Enough data available to decode the requested GRP.
-        if (     m_buffering
-            && (   (static_cast<uint32_t>(m_buffer.tellp())
-                 - (static_cast<uint32_t>(m_buffer.tellg()) + m_toRemove))
-                    >= m_payloadSize
-               )
-           ) {
-            // Go to where we need to read from.
-            m_buffer.seekg(m_toRemove, std::ios_base::beg);
-
-            if (ApplanixStringDecoder::GRP1 == m_nextApplanixMessage) {
-                // Decode Applanix GRP1.
-                opendlv::core::sensors::applanix::Grp1Data g1Data = getGRP1(m_buffer);
-                Container c(g1Data);
-                m_conference.send(c);
-
-                // Create generic message.
-                opendlv::data::environment::WGS84Coordinate wgs84(g1Data.getLat(), g1Data.getLon());
-                Container c2(wgs84);
-                m_conference.send(c2);
-            }
-            else if (ApplanixStringDecoder::GRP2 == m_nextApplanixMessage) {
-                // Decode Applanix GRP2.
-                opendlv::core::sensors::applanix::Grp2Data g2Data = getGRP2(m_buffer);
-
-                Container c(g2Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP3 == m_nextApplanixMessage) {
-                // Decode Applanix GRP3.
-                opendlv::core::sensors::applanix::Grp3Data g3Data = getGRP3(m_buffer);
-
-                Container c(g3Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP4 == m_nextApplanixMessage) {
-                // Decode Applanix GRP4.
-                opendlv::core::sensors::applanix::Grp4Data g4Data = getGRP4(m_buffer);
-
-                Container c(g4Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP10001 == m_nextApplanixMessage) {
-                // Decode Applanix GRP10001.
-                opendlv::core::sensors::applanix::Grp10001Data g10001Data = getGRP10001(m_buffer);
-
-                Container c(g10001Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP10002 == m_nextApplanixMessage) {
-                // Decode Applanix GRP10002.
-                opendlv::core::sensors::applanix::Grp10002Data g10002Data = getGRP10002(m_buffer);
-
-                Container c(g10002Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP10003 == m_nextApplanixMessage) {
-                // Decode Applanix GRP10003.
-                opendlv::core::sensors::applanix::Grp10003Data g10003Data = getGRP10003(m_buffer);
-
-                Container c(g10003Data);
-                m_conference.send(c);
-            }
-            else if (ApplanixStringDecoder::GRP10009 == m_nextApplanixMessage) {
-                // Decode Applanix GRP10009.
-                opendlv::core::sensors::applanix::Grp10009Data g10009Data = getGRP10009(m_buffer);
-
-                Container c(g10009Data);
-                m_conference.send(c);
-            }
-            else {
-                // Unknown message.
-            }
-
-            // Maintain internal buffer status.
-            m_buffering = false;
-            m_foundHeader = false;
-            m_toRemove += m_payloadSize + ApplanixStringDecoder::GRP_FOOTER_SIZE;
-            m_payloadSize = 0;
-            m_nextApplanixMessage = ApplanixStringDecoder::UNKNOWN;
+void ApplanixStringDecoder::decodeGroups() {
+    const char GRP_START[] = "$GRP";
+    const char GRP_END[] = "$#";
+    while (m_end - m_begin >= ApplanixStringDecoder::GRP_HEADER_SIZE) {
+        const char *start = &m_buffer[m_begin];
+        const uint32_t available = m_end - m_begin;
+
+        if (0 != memcmp(start, GRP_START, 4)) {
+            const char *next = static_cast<const char *>(memmem(start + 1, available - 1, GRP_START, 4));
+            // Keep a group start that might be cut off at the end.
+            const uint32_t skip = (NULL != next) ? static_cast<uint32_t>(next - start) : available - 3;
+            m_skippedBytes += skip;
+            m_begin += skip;
+            continue;
         }
 
-        // Try decoding GRP? header.
-        if (     !m_foundHeader
-            && (   (static_cast<uint32_t>(m_buffer.tellp())
-                 - (static_cast<uint32_t>(m_buffer.tellg()) + m_toRemove))
-                    >= ApplanixStringDecoder::GRP_HEADER_SIZE
-               )
-           ) {
-            // Go to where we need to read from.
-            m_buffer.seekg(m_toRemove, ios::beg);
-
-            // Decode GRP header.
-            opendlv::core::sensors::applanix::internal::GrpHdrMsg hdr;
-
-            char grpstart[4];
-            m_buffer.read(grpstart, sizeof(grpstart));
-            hdr.setGrpstart(string(grpstart, 4));
-
-            uint16_t buffer = 0;
-            m_buffer.read((char *)(&(buffer)), sizeof(buffer));
-            buffer = le16toh(buffer);
-            hdr.setGroupnum(buffer);
-
-            if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 1) ) {
-                // Decode "$GRP1" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP1;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 2) ) {
-                // Decode "$GRP2" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP2;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 3) ) {
-                // Decode "$GRP3" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP3;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 4) ) {
-                // Decode "$GRP4" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP4;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 10001) ) {
-                // Decode "$GRP10001" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP10001;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 10002) ) {
-                // Decode "$GRP10002" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP10002;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 10003) ) {
-                // Decode "$GRP10003" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP10003;
-            }
-            else if ( (hdr.getGrpstart() == "$GRP") && (hdr.getGroupnum() == 10009) ) {
-                // Decode "$GRP10009" messages.
-                prepareReadingBuffer(m_buffer);
-
-                // Define the next message to decode.
-                m_nextApplanixMessage = ApplanixStringDecoder::GRP10009;
-            }
-            else {
-                // Nothing known found; skip this byte and try again.
-                m_toRemove++;
-            }
+        uint16_t groupNumber = 0;
+        memcpy(&groupNumber, start + 4, sizeof(groupNumber));
+        groupNumber = le16toh(groupNumber);
+        uint16_t byteCount = 0;
+        memcpy(&byteCount, start + 6, sizeof(byteCount));
+        byteCount = le16toh(byteCount);
+        const uint32_t groupSize = static_cast<uint32_t>(ApplanixStringDecoder::GRP_HEADER_SIZE) + byteCount;
+
+        ApplanixMessages message = ApplanixStringDecoder::UNKNOWN;
+        switch (groupNumber) {
+            case ApplanixStringDecoder::GRP1:
+            case ApplanixStringDecoder::GRP2:
+            case ApplanixStringDecoder::GRP3:
+            case ApplanixStringDecoder::GRP4:
+            case ApplanixStringDecoder::GRP10001:
+            case ApplanixStringDecoder::GRP10002:
+            case ApplanixStringDecoder::GRP10003:
+            case ApplanixStringDecoder::GRP10009:
+                message = static_cast<ApplanixMessages>(groupNumber);
+                break;
+            default:
+                break;
         }
+        const char *payload = start + ApplanixStringDecoder::GRP_HEADER_SIZE;
+        uint32_t layoutByteCount = 0;
+        if (   (ApplanixStringDecoder::UNKNOWN != message)
+            && !getLayoutByteCount(message, payload, available - ApplanixStringDecoder::GRP_HEADER_SIZE, layoutByteCount) ) {
+            // Wait for the length field of the group.
+            break;
+        }
+        // A false group start rarely has a byte count that fits the group.
+        const bool plausible = (ApplanixStringDecoder::UNKNOWN != message)
+                            && (byteCount >= layoutByteCount)
+                            && (byteCount <= layoutByteCount + ApplanixStringDecoder::GRP_MAX_PADDING);
+        if (plausible && (available < groupSize)) {
+            // Wait for the rest of the group.
+            break;
+        }
+
+        // The byte count includes the checksum and the group end.
+        if (!plausible || (0 != memcmp(payload + byteCount - 2, GRP_END, 2))) {
+            // Nothing known found; search for the next group start.
+            m_skippedBytes++;
+            m_begin++;
+            continue;
+        }
+
+        GrpPayload buffer(payload, byteCount);
+        decodeGroup(message, buffer);
+        m_begin += groupSize;
     }
 
-    // Discard unused data from buffer but avoid copying data too often.
-    const uint32_t MAX_BUFFER = 32768;
-    if ( (m_buffer.tellg() > 0) && (m_toRemove > MAX_BUFFER) ) {
-        const string s = m_buffer.str().substr(m_buffer.tellg());
-        m_buffer.clear();
-        m_buffer.str(s);
-        m_buffer.seekp(0, ios::end);
-        m_buffer.seekg(0, ios::beg);
-        m_toRemove = 0;
+    if (m_begin == m_end) {
+        m_begin = m_end = 0;
     }
 }
 }
@@ -22,8 +22,11 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <cstring>
+#include <fstream>
 #include <memory>
 #include <iomanip>
+#include <sstream>
 
 #include <opendavinci/odcore/io/conference/ContainerConference.h>
 #include <opendavinci/odcore/io/conference/ContainerConferenceFactory.h>
@@ -40,15 +43,19 @@ using namespace opendlv::core::system::proxy;
 
 class MyContainerConference : public ContainerConference {
    public:
-    MyContainerConference() : ContainerConference(), m_callCounter(0), m_g1data() {}
+    MyContainerConference() : ContainerConference(), m_callCounter(0), m_g1data(), m_g10002data() {}
     virtual void send(odcore::data::Container &container) const {
         m_callCounter++;
         if (container.getDataType() == opendlv::core::sensors::applanix::Grp1Data::ID()) {
             m_g1data = container.getData<opendlv::core::sensors::applanix::Grp1Data>();
         }
+        if (container.getDataType() == opendlv::core::sensors::applanix::Grp10002Data::ID()) {
+            m_g10002data = container.getData<opendlv::core::sensors::applanix::Grp10002Data>();
+        }
     }
     mutable uint32_t m_callCounter;
     mutable opendlv::core::sensors::applanix::Grp1Data m_g1data;
+    mutable opendlv::core::sensors::applanix::Grp10002Data m_g10002data;
 };
 
 class ProxyApplanixTest : public CxxTest::TestSuite {
@@ -57,6 +64,37 @@ class ProxyApplanixTest : public CxxTest::TestSuite {
 
     void tearDown() {}
 
+    // Frames a payload as a group: "$GRP", group number, byte count, payload, checksum, "$#".
+    string makeGroup(const uint16_t &groupNumber, const string &payload) {
+        const uint16_t byteCount = payload.size() + 4;
+        string group("$GRP");
+        group.append((const char*)(&groupNumber), sizeof(groupNumber));
+        group.append((const char*)(&byteCount), sizeof(byteCount));
+        group += payload;
+        group.append(2, '\0');
+        group += "$#";
+        return group;
+    }
+
+    string makeGrp1(const double &lat, const double &lon) {
+        // Time/distance fields (26 bytes) followed by the navigation fields (102 bytes).
+        string payload(128, '\0');
+        memcpy(&payload[26], &lat, sizeof(lat));
+        memcpy(&payload[34], &lon, sizeof(lon));
+        return makeGroup(1, payload);
+    }
+
+    string makeGrp10002(const string &rawData) {
+        const uint16_t byteCount = rawData.size();
+        string payload(26, '\0');
+        payload += "$IMUAB";
+        payload.append((const char*)(&byteCount), sizeof(byteCount));
+        payload += rawData;
+        payload.append(2, '\0');
+        payload.append((4 - payload.size() % 4) % 4, '\0');
+        return makeGroup(10002, payload);
+    }
+
     void testApplication() {
         MyContainerConference mcc;
         ApplanixStringDecoder asd(mcc);
@@ -100,6 +138,49 @@ class ProxyApplanixTest : public CxxTest::TestSuite {
         data.close();
     }
 
+    void testGroupsSplitAcrossStrings() {
+        MyContainerConference mcc;
+        ApplanixStringDecoder asd(mcc);
+
+        // Contains a false group start with a known group number.
+        const char GARBAGE[] = "noise$GR$GRP\x01\x00\x20\x00more noise";
+        const string garbage(GARBAGE, sizeof(GARBAGE) - 1);
+        string stream;
+        stream += garbage;
+        stream += makeGrp1(57.70878319, 11.94648496);
+        stream += makeGrp10002("raw IMU data");
+        stream += garbage;
+        stream += makeGroup(4711, string(16, 'x'));
+        stream += makeGrp1(57.70878314, 11.94648486);
+
+        // Feed the stream in chunks of 1 to 15 bytes.
+        uint32_t chunk = 1;
+        for (uint32_t i = 0; i < stream.size(); i += chunk, chunk = chunk % 15 + 1) {
+            asd.nextString(stream.substr(i, chunk));
+        }
+
+        // Each GRP1 also sends a WGS84Coordinate.
+        TS_ASSERT(mcc.m_callCounter == 5);
+        TS_ASSERT_DELTA(mcc.m_g1data.getLat(), 57.70878314, 1e-8);
+        TS_ASSERT_DELTA(mcc.m_g1data.getLon(), 11.94648486, 1e-8);
+        TS_ASSERT(mcc.m_g10002data.getImu_raw_data() == "raw IMU data");
+        TS_ASSERT(asd.getSkippedBytes() == 2 * garbage.size() + makeGroup(4711, string(16, 'x')).size());
+    }
+
+    void testFalseGroupStartWithLargeByteCount() {
+        MyContainerConference mcc;
+        ApplanixStringDecoder asd(mcc);
+
+        // A GRP1 cannot span 65535 bytes; the following group must not wait for them.
+        const char GARBAGE[] = "$GRP\x01\x00\xff\xff";
+        const string garbage(GARBAGE, sizeof(GARBAGE) - 1);
+        asd.nextString(garbage + makeGrp1(57.70878319, 11.94648496));
+
+        TS_ASSERT(mcc.m_callCounter == 2);
+        TS_ASSERT_DELTA(mcc.m_g1data.getLat(), 57.70878319, 1e-8);
+        TS_ASSERT(asd.getSkippedBytes() == garbage.size());
+    }
+
 };
 
 #endif /*PROXY_PROXYAPPLANIX_TESTSUITE_H*/
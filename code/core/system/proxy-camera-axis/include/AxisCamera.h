@@ -21,11 +21,16 @@
 #define AXISCAMERA_H_
 
 #include <memory>
+#include <string>
 
 #include <opencv2/core/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
 
 #include "Camera.h"
+#include "DecoderPool.h"
+#include "FrameViewer.h"
+#include "JpegDecoder.h"
+#include "MjpegClient.h"
 
 namespace opendlv {
 namespace core {
@@ -36,6 +41,10 @@ using namespace std;
 
 /**
  * This class wraps an Axis camera and captures its data into a shared memory segment.
+ *
+ * The MJPEG stream is either received and decoded by OpenCV, or received by
+ * an own HTTP client and decoded with libjpeg-turbo, optionally downscaled
+ * and on a pool of decoder threads.
  */
 class AxisCamera : public Camera {
    private:
@@ -69,22 +78,35 @@ class AxisCamera : public Camera {
      * @param width Expected image width.
      * @param height Expected image height.
      * @param calibrationFile Name of a .yml file containing the intrinsic and extrinsic calibration parameters.
-     * @param debug Show live image feed.
+     * @param undistortionMapsFile Name of a file with undistortion maps saved by camera-calibration, used instead of calibrationFile; empty to compute them.
+     * @param debug Show live image feed on a separate thread.
+     * @param remapThreads Number of threads that undistort stripes of rows; 1 undistorts on the capturing thread.
+     * @param decoderThreads 0 to receive and decode with OpenCV; 1 to decode the frames from the own client on the capturing thread, more for a pool.
+     * @param scale Downscaling of the decoded frames by 1, 2, 4, or 8 when decoderThreads > 0; width and height are the downscaled size.
      */
-    AxisCamera(const string &name, const string &address, const string &username, const string &password, const uint32_t &width, const uint32_t &height, const string &calibrationFile, const bool &debug);
+    AxisCamera(const string &name, const string &address, const string &username, const string &password, const uint32_t &width, const uint32_t &height, const string &calibrationFile, const string &undistortionMapsFile, const bool &debug, const uint32_t &remapThreads, const uint32_t &decoderThreads, const uint32_t &scale);
     virtual ~AxisCamera();
 
    private:
     virtual bool copyImageTo(char *dest, const uint32_t &size);
+    virtual bool copyCompressedImageTo(string &jpeg);
     virtual bool isValid() const;
     virtual bool captureFrame();
 
    private:
     std::unique_ptr<cv::VideoCapture> m_capture;
+    std::unique_ptr< MjpegClient > m_client;
+    std::unique_ptr< JpegDecoder > m_decoder; // Decodes on the capturing thread.
+    std::unique_ptr< DecoderPool > m_pool;
+    std::string m_jpeg; // Last received frame.
+    std::string m_pooledJpeg; // Copy of m_jpeg handed to the pool.
     cv::Mat m_intrinsicCalibration;
     cv::Mat m_extrinsicCalibration;
     cv::Mat m_image;
-    bool m_debug;
+    cv::Mat m_map1; // Fixed-point undistortion map (CV_16SC2), empty without calibration.
+    cv::Mat m_map2; // Interpolation table for m_map1.
+    std::unique_ptr< FrameViewer > m_viewer; // Only set when debugging.
+    uint32_t m_remapThreads;
 };
 }
 }
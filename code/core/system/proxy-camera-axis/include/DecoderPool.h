@@ -0,0 +1,115 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef DECODERPOOL_H_
+#define DECODERPOOL_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class decodes JPEG frames on several worker threads for streams
+ * whose frame rate exceeds what one core can decode.
+ *
+ * At most one frame per worker waits for decoding; when the queue is full,
+ * the oldest waiting frame is dropped. Frames may finish out of order, so
+ * only a decoded frame newer than the newest one so far is kept.
+ */
+class DecoderPool {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param threads Number of worker threads.
+     * @param scale Downscaling factor: 1, 2, 4, or 8.
+     * @param width Width of the decoded frames.
+     * @param height Height of the decoded frames.
+     */
+    DecoderPool(const uint32_t &threads, const uint32_t &scale, const uint32_t &width, const uint32_t &height);
+    DecoderPool(DecoderPool const &) = delete;
+    DecoderPool &operator=(DecoderPool const &) = delete;
+    virtual ~DecoderPool();
+
+    /**
+     * This method queues a frame for decoding.
+     *
+     * @param jpeg JPEG frame; its content is swapped with a recycled buffer.
+     */
+    void submit(std::string &jpeg);
+
+    /**
+     * This method copies the newest decoded frame if it was not copied before.
+     *
+     * @param destination BGR image of width * height * 3 bytes.
+     * @return true if a new frame was copied.
+     */
+    bool getNewestFrame(char *destination);
+
+    uint64_t getDecodedFrames() const;
+    uint64_t getDroppedFrames() const;
+    uint64_t getFailedFrames() const;
+
+   private:
+    void run();
+
+   private:
+    struct Job {
+        uint64_t number;
+        std::string jpeg;
+    };
+
+    uint32_t m_scale;
+    uint32_t m_width;
+    uint32_t m_height;
+    uint32_t m_capacity;
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_running;
+    std::deque< Job > m_jobs;
+    std::vector< std::string > m_recycled; // Buffers for the next jobs.
+    uint64_t m_submitted;
+
+    std::vector< char > m_newest; // Newest decoded frame.
+    uint64_t m_newestNumber;
+    uint64_t m_copiedNumber;
+
+    std::atomic< uint64_t > m_decoded;
+    std::atomic< uint64_t > m_dropped;
+    std::atomic< uint64_t > m_failed;
+    std::vector< std::thread > m_threads;
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*DECODERPOOL_H_*/
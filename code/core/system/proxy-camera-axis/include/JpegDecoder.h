@@ -0,0 +1,72 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef JPEGDECODER_H_
+#define JPEGDECODER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class decodes JPEG frames into BGR images, optionally downscaled by
+ * 2, 4, or 8. With libjpeg-turbo (HAVE_TURBOJPEG, set by the CMake option
+ * WITH_TURBOJPEG), decoding uses its SIMD code and the downscaling happens
+ * in the DCT domain; otherwise, the frame is decoded by OpenCV and resized.
+ *
+ * An instance is not thread-safe; use one per thread.
+ */
+class JpegDecoder {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param scale Downscaling factor: 1, 2, 4, or 8.
+     */
+    JpegDecoder(const uint32_t &scale);
+    JpegDecoder(JpegDecoder const &) = delete;
+    JpegDecoder &operator=(JpegDecoder const &) = delete;
+    virtual ~JpegDecoder();
+
+    /**
+     * This method decodes a frame; the downscaled size is rounded up.
+     *
+     * @param jpeg JPEG frame.
+     * @param destination BGR image of width * height * 3 bytes.
+     * @param width Expected width after downscaling.
+     * @param height Expected height after downscaling.
+     * @return true if the frame was decoded and has the expected size.
+     */
+    bool decode(const std::string &jpeg, char *destination, const uint32_t &width, const uint32_t &height);
+
+   private:
+    uint32_t m_scale;
+    void *m_handle; // libjpeg-turbo decompressor.
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*JPEGDECODER_H_*/
@@ -0,0 +1,99 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MJPEGCLIENT_H_
+#define MJPEGCLIENT_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "MjpegStreamParser.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class receives an MJPEG stream over HTTP/1.0 with basic
+ * authentication and returns the JPEG frames as they are.
+ */
+class MjpegClient {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param address Host and optional port, e.g. 10.42.42.90:80.
+     * @param path Path and query of the stream.
+     * @param username User name for basic authentication; empty for none.
+     * @param password Password for basic authentication.
+     */
+    MjpegClient(const std::string &address, const std::string &path, const std::string &username, const std::string &password);
+    MjpegClient(MjpegClient const &) = delete;
+    MjpegClient &operator=(MjpegClient const &) = delete;
+    virtual ~MjpegClient();
+
+    /**
+     * This method connects, sends the request, and reads the response header.
+     *
+     * @return true if the server answered with a multipart stream.
+     */
+    bool connect();
+
+    void disconnect();
+
+    bool isConnected() const;
+
+    /**
+     * This method blocks until the next frame is received; it disconnects
+     * on errors and after 5 s without data.
+     *
+     * @param frame Buffer for the JPEG frame; its capacity is reused.
+     * @return true if a frame was received.
+     */
+    bool nextFrame(std::string &frame);
+
+    /**
+     * @return Number of bytes that were not part of any frame.
+     */
+    uint64_t getSkippedBytes() const;
+
+    static std::string toBase64(const std::string &data);
+
+   private:
+    int32_t receive();
+
+   private:
+    std::string m_host;
+    std::string m_port;
+    std::string m_request;
+    int32_t m_socket;
+    std::vector< char > m_receiveBuffer;
+    std::unique_ptr< MjpegStreamParser > m_parser;
+    uint64_t m_skippedBytes; // Of previous connections.
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*MJPEGCLIENT_H_*/
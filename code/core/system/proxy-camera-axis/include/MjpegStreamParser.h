@@ -0,0 +1,109 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MJPEGSTREAMPARSER_H_
+#define MJPEGSTREAMPARSER_H_
+
+#include <stdint.h>
+
+#include <string>
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class splits the body of a multipart/x-mixed-replace HTTP response
+ * (MJPEG over HTTP) into its parts.
+ *
+ * A part starts with a line holding the boundary and ends after the number
+ * of bytes given in its Content-Length header, or at the next boundary if
+ * the header is missing. Received bytes are appended to an internal buffer
+ * that is compacted and reused, so that no allocations happen once the
+ * buffers have grown to the size of a frame.
+ *
+ * A part larger than MAX_PART_SIZE is skipped and parsing resumes at the
+ * next boundary, so that a corrupt Content-Length cannot stall the stream
+ * or grow the buffer without limit.
+ */
+class MjpegStreamParser {
+   public:
+    static const uint32_t MAX_PART_SIZE = 16 * 1024 * 1024;
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param boundary Boundary parameter of the Content-Type header.
+     */
+    MjpegStreamParser(const std::string &boundary);
+    MjpegStreamParser(MjpegStreamParser const &) = delete;
+    MjpegStreamParser &operator=(MjpegStreamParser const &) = delete;
+    virtual ~MjpegStreamParser();
+
+    /**
+     * @param contentType Value of the Content-Type header.
+     * @return Boundary parameter, or an empty string if there is none.
+     */
+    static std::string parseBoundary(const std::string &contentType);
+
+    /**
+     * This method appends bytes received from the stream.
+     *
+     * @param data Received bytes.
+     * @param length Number of received bytes.
+     */
+    void append(const char *data, const uint32_t &length);
+
+    /**
+     * This method extracts the next complete part.
+     *
+     * @param frame Buffer for the part's body; its capacity is reused.
+     * @return true if a complete part was extracted.
+     */
+    bool nextFrame(std::string &frame);
+
+    /**
+     * @return Number of bytes that were not part of any frame.
+     */
+    uint64_t getSkippedBytes() const;
+
+    /**
+     * @return Number of parts that were skipped for exceeding MAX_PART_SIZE.
+     */
+    uint64_t getSkippedParts() const;
+
+   private:
+    bool skipPart(const size_t &bodyStart, std::string &frame);
+    void compact();
+
+   private:
+    std::string m_boundary;
+    std::string m_buffer;
+    size_t m_position; // Start of the unparsed bytes in m_buffer.
+    uint64_t m_skippedBytes;
+    uint64_t m_skippedParts;
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*MJPEGSTREAMPARSER_H_*/
@@ -27,6 +27,7 @@
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 
 #include "Camera.h"
+#include "CaptureThread.h"
 
 namespace opendlv {
 namespace core {
@@ -59,8 +60,12 @@ class ProxyCamera : public odcore::base::module::TimeTriggeredConferenceClientMo
     void tearDown();
     odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
 
+    void publishLatencies(Camera &camera);
+
    private:
     unique_ptr< Camera > m_camera;
+    unique_ptr< CaptureThread > m_captureThread; // Stopped before m_camera is destroyed.
+    uint32_t m_latencyPeriod; // Period of the latency HealthStatus in ms.
 };
 }
 }
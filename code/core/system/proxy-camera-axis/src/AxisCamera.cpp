@@ -17,11 +17,17 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <thread>
 
 #include <opencv2/imgproc/imgproc.hpp>
 
+#include "UndistortionMaps.h"
+
 #include "AxisCamera.h"
 
 namespace opendlv {
@@ -29,13 +35,57 @@ namespace core {
 namespace system {
 namespace proxy {
 
-AxisCamera::AxisCamera(const string &name, const string &address, const string &username, const string &password, const uint32_t &width, const uint32_t &height, const string &calibrationFile, const bool &debug)
-    : Camera(name, width, height)
+namespace {
+// Showing more frames per second adds nothing but copies.
+const uint32_t VIEWER_FREQUENCY = 10;
+
+/**
+ * This class undistorts a stripe of rows of the destination image.
+ */
+class RemapStripes : public cv::ParallelLoopBody {
+   public:
+    RemapStripes(const cv::Mat &source, cv::Mat &destination, const cv::Mat &map1, const cv::Mat &map2, const int32_t &stripes)
+        : m_source(source)
+        , m_destination(destination)
+        , m_map1(map1)
+        , m_map2(map2)
+        , m_stripes(stripes) {}
+
+    virtual void operator()(const cv::Range &range) const {
+        const int32_t rows = m_destination.rows;
+        const cv::Range r(range.start * rows / m_stripes, range.end * rows / m_stripes);
+        cv::Mat destination = m_destination.rowRange(r);
+        // The maps hold absolute source coordinates, so any rows can be remapped on their own.
+        cv::remap(m_source, destination, m_map1.rowRange(r), m_map2.rowRange(r), cv::INTER_LINEAR);
+    }
+
+   private:
+    const cv::Mat &m_source;
+    cv::Mat &m_destination;
+    const cv::Mat &m_map1;
+    const cv::Mat &m_map2;
+    int32_t m_stripes;
+};
+}
+
+AxisCamera::AxisCamera(const string &name, const string &address, const string &username, const string &password, const uint32_t &width, const uint32_t &height, const string &calibrationFile, const string &undistortionMapsFile, const bool &debug, const uint32_t &remapThreads, const uint32_t &decoderThreads, const uint32_t &scale)
+    : Camera(name, 0, width, height, 3)
     , m_capture(nullptr)
+    , m_client(nullptr)
+    , m_decoder(nullptr)
+    , m_pool(nullptr)
+    , m_jpeg()
+    , m_pooledJpeg()
     , m_intrinsicCalibration()
     , m_extrinsicCalibration()
     , m_image()
-    , m_debug(debug) {
+    , m_map1()
+    , m_map2()
+    , m_viewer(nullptr)
+    , m_remapThreads(remapThreads) {
+    if (debug) {
+        m_viewer.reset(new FrameViewer("[proxy-camera-axis]", VIEWER_FREQUENCY));
+    }
 
     const string VIDEO_STREAM_ADDRESS =
         string("http://") + username + ":"
@@ -45,16 +95,38 @@ AxisCamera::AxisCamera(const string &name, const string &address, const string &
                           + username + "&password="
                           + password + "&channel=0&.mjpg";
 
-    m_capture.reset(new cv::VideoCapture(VIDEO_STREAM_ADDRESS));
-    if (m_capture->isOpened()) {
-        m_capture->set(CV_CAP_PROP_FRAME_WIDTH, width);
-        m_capture->set(CV_CAP_PROP_FRAME_HEIGHT, height);
+    if (decoderThreads > 0) {
+        // Request the full size of the downscaled frames from the camera.
+        stringstream path;
+        path << "/axis-cgi/mjpg/video.cgi?channel=0&resolution=" << width * scale << "x" << height * scale;
+        m_client.reset(new MjpegClient(address, path.str(), username, password));
+        if (decoderThreads > 1) {
+            m_pool.reset(new DecoderPool(decoderThreads, scale, width, height));
+        } else {
+            m_decoder.reset(new JpegDecoder(scale));
+        }
+        m_image.create(height, width, CV_8UC3);
+        if (!m_client->connect()) {
+            cerr << "[proxy-camera-axis] Could not connect to camera at '" << address << "'; retrying" << endl;
+        }
     } else {
-        cerr << "[proxy-camera-axis] Could not open camera '" << VIDEO_STREAM_ADDRESS << "'" << endl;
+        m_capture.reset(new cv::VideoCapture(VIDEO_STREAM_ADDRESS));
+        if (m_capture->isOpened()) {
+            m_capture->set(CV_CAP_PROP_FRAME_WIDTH, width);
+            m_capture->set(CV_CAP_PROP_FRAME_HEIGHT, height);
+        } else {
+            cerr << "[proxy-camera-axis] Could not open camera '" << VIDEO_STREAM_ADDRESS << "'" << endl;
+        }
     }
 
-    // Try to read calibration file if camera is present.
-    if (m_capture->isOpened()) {
+    if (!undistortionMapsFile.empty()) {
+        // The maps saved by camera-calibration refer to the decoded or the camera's full frames.
+        cv::Mat map1;
+        cv::Mat map2;
+        UndistortionMaps::read(undistortionMapsFile, map1, map2);
+        UndistortionMaps::fit(map1, map2, cv::Size(width, height), (decoderThreads > 0) ? scale : 1, m_map1, m_map2);
+    } else if (isValid()) {
+        // Try to read calibration file if camera is present.
         try {
             cv::FileStorage fileStorage(calibrationFile, cv::FileStorage::READ);
             fileStorage["camera_matrix"] >> m_extrinsicCalibration;
@@ -65,10 +137,29 @@ AxisCamera::AxisCamera(const string &name, const string &address, const string &
             const char *errorMessage = ex.what();
             cerr << "[proxy-camera-axis] Failed to read calibration file " << calibrationFile <<  ": " << errorMessage << endl;
         }
+
+        // The undistortion maps are computed once; every frame is remapped with them.
+        if (!m_intrinsicCalibration.empty() && !m_extrinsicCalibration.empty()) {
+            cv::Mat cameraMatrix = m_extrinsicCalibration.clone();
+            if (decoderThreads > 0) {
+                // The calibration refers to the frames before downscaling.
+                cv::Mat focalLengthsAndCenter = cameraMatrix.rowRange(0, 2);
+                focalLengthsAndCenter /= static_cast< double >(scale);
+            }
+            cv::initUndistortRectifyMap(cameraMatrix, m_intrinsicCalibration, cv::Mat(), cameraMatrix,
+                cv::Size(width, height), CV_16SC2, m_map1, m_map2);
+        }
     }
 }
 
 AxisCamera::~AxisCamera() {
+    if (m_client != nullptr) {
+        cout << "[proxy-camera-axis] Skipped " << m_client->getSkippedBytes() << " bytes of the stream";
+        if (m_pool != nullptr) {
+            cout << ", dropped " << m_pool->getDroppedFrames() << " frames before decoding, failed to decode " << m_pool->getFailedFrames();
+        }
+        cout << "." << endl;
+    }
     if (m_capture != nullptr) {
         m_capture->release();
         m_capture = nullptr;
@@ -76,35 +167,85 @@ AxisCamera::~AxisCamera() {
 }
 
 bool AxisCamera::isValid() const {
-    return ((m_capture != nullptr) && m_capture->isOpened());
+    // The own client reconnects when capturing.
+    return (m_client != nullptr) || ((m_capture != nullptr) && m_capture->isOpened());
 }
 
 bool AxisCamera::captureFrame() {
     bool retVal = false;
-    if (m_capture != nullptr) {
-        if (m_capture->read(m_image)) {
-            if (!m_intrinsicCalibration.empty() && !m_extrinsicCalibration.empty()){
-                cv::Mat tmpClone = m_image.clone();
-                cv::undistort(tmpClone, m_image, m_extrinsicCalibration, m_intrinsicCalibration);
-                tmpClone.release();
+    if (m_client != nullptr) {
+        if (!m_client->isConnected() && !m_client->connect()) {
+            // Do not flood an unreachable camera with connection attempts.
+            this_thread::sleep_for(chrono::seconds(1));
+        } else if (m_client->nextFrame(m_jpeg)) {
+            if ((m_pool != nullptr) && hasRawOutput()) {
+                // The pool takes the buffer; the bitstream is still needed for the compressed output.
+                if (hasCompressedOutput()) {
+                    m_pooledJpeg.assign(m_jpeg);
+                    m_pool->submit(m_pooledJpeg);
+                } else {
+                    m_pool->submit(m_jpeg);
+                }
+                if (m_pool->getNewestFrame(reinterpret_cast< char * >(m_image.data))) {
+                    retVal = true;
+                } else if (hasCompressedOutput()) {
+                    // No decoded frame is ready yet; do not publish the previous one again.
+                    setCompressedFrameOnly();
+                    retVal = true;
+                }
+            } else {
+                retVal = true;
             }
+        }
+    } else if (m_capture != nullptr) {
+        if (m_capture->read(m_image)) {
             retVal = true;
         }
     }
     return retVal;
 }
 
+bool AxisCamera::copyCompressedImageTo(string &jpeg) {
+    // The camera's bitstream is passed on as it is.
+    bool retVal = false;
+    if ((m_client != nullptr) && !m_jpeg.empty()) {
+        jpeg.assign(m_jpeg);
+        retVal = true;
+    }
+    return retVal;
+}
+
 bool AxisCamera::copyImageTo(char *dest, const uint32_t &size) {
     bool retVal = false;
 
     if ((dest != NULL) && (size > 0)) {
-        ::memcpy(dest, m_image.data, size);
+        cv::Mat destination(getHeight(), getWidth(), CV_8UC3, dest);
+        if ((m_decoder != nullptr) && m_map1.empty()) {
+            // Decode straight into the shared memory.
+            retVal = m_decoder->decode(m_jpeg, dest, getWidth(), getHeight());
+        } else {
+            retVal = true;
+            if (m_decoder != nullptr) {
+                retVal = m_decoder->decode(m_jpeg, reinterpret_cast< char * >(m_image.data), getWidth(), getHeight());
+            }
+            if (retVal) {
+                // Undistort straight into the shared memory.
+                if (!m_map1.empty()) {
+                    if (m_remapThreads > 1) {
+                        const int32_t stripes = static_cast< int32_t >(m_remapThreads);
+                        cv::parallel_for_(cv::Range(0, stripes), RemapStripes(m_image, destination, m_map1, m_map2, stripes), stripes);
+                    } else {
+                        cv::remap(m_image, destination, m_map1, m_map2, cv::INTER_LINEAR);
+                    }
+                } else {
+                    ::memcpy(dest, m_image.data, size);
+                }
+            }
+        }
 
-        if (m_debug) {
-            cv::imshow("[proxy-camera-axis]", m_image);
-            cv::waitKey(10);
+        if (retVal && (m_viewer != nullptr)) {
+            m_viewer->offer(destination);
         }
-        retVal = true;
     }
     return retVal;
 }
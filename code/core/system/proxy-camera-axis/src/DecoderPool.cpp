@@ -0,0 +1,152 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include "DecoderPool.h"
+#include "JpegDecoder.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+DecoderPool::DecoderPool(const uint32_t &threads, const uint32_t &scale, const uint32_t &width, const uint32_t &height)
+    : m_scale(scale)
+    , m_width(width)
+    , m_height(height)
+    , m_capacity(threads)
+    , m_mutex()
+    , m_condition()
+    , m_running(true)
+    , m_jobs()
+    , m_recycled()
+    , m_submitted(0)
+    , m_newest(width * height * 3)
+    , m_newestNumber(0)
+    , m_copiedNumber(0)
+    , m_decoded(0)
+    , m_dropped(0)
+    , m_failed(0)
+    , m_threads() {
+    // Fail early on an invalid scale rather than on the workers.
+    JpegDecoder decoder(scale);
+    for (uint32_t i = 0; i < threads; i++) {
+        m_threads.push_back(thread(&DecoderPool::run, this));
+    }
+}
+
+DecoderPool::~DecoderPool() {
+    {
+        lock_guard< mutex > l(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+    for (uint32_t i = 0; i < m_threads.size(); i++) {
+        m_threads[i].join();
+    }
+}
+
+void DecoderPool::submit(string &jpeg) {
+    {
+        lock_guard< mutex > l(m_mutex);
+        if (m_jobs.size() >= m_capacity) {
+            m_recycled.push_back(string());
+            m_recycled.back().swap(m_jobs.front().jpeg);
+            m_jobs.pop_front();
+            m_dropped.fetch_add(1, memory_order_relaxed);
+        }
+        m_jobs.push_back(Job());
+        Job &job = m_jobs.back();
+        job.number = ++m_submitted;
+        if (!m_recycled.empty()) {
+            job.jpeg.swap(m_recycled.back());
+            m_recycled.pop_back();
+        }
+        // The caller gets the recycled buffer back for the next frame.
+        job.jpeg.swap(jpeg);
+    }
+    m_condition.notify_one();
+}
+
+void DecoderPool::run() {
+    JpegDecoder decoder(m_scale);
+    vector< char > image(m_width * m_height * 3);
+    Job job;
+    while (true) {
+        {
+            unique_lock< mutex > l(m_mutex);
+            while (m_running && m_jobs.empty()) {
+                m_condition.wait(l);
+            }
+            if (!m_running) {
+                return;
+            }
+            job.number = m_jobs.front().number;
+            job.jpeg.swap(m_jobs.front().jpeg);
+            m_jobs.pop_front();
+        }
+
+        const bool decoded = decoder.decode(job.jpeg, image.data(), m_width, m_height);
+
+        lock_guard< mutex > l(m_mutex);
+        m_recycled.push_back(string());
+        m_recycled.back().swap(job.jpeg);
+        if (!decoded) {
+            m_failed.fetch_add(1, memory_order_relaxed);
+            continue;
+        }
+        m_decoded.fetch_add(1, memory_order_relaxed);
+        if (job.number > m_newestNumber) {
+            m_newest.swap(image);
+            m_newestNumber = job.number;
+        } else {
+            // A newer frame finished first.
+            m_dropped.fetch_add(1, memory_order_relaxed);
+        }
+    }
+}
+
+bool DecoderPool::getNewestFrame(char *destination) {
+    lock_guard< mutex > l(m_mutex);
+    if ((destination == NULL) || (m_newestNumber == m_copiedNumber)) {
+        return false;
+    }
+    memcpy(destination, m_newest.data(), m_newest.size());
+    m_copiedNumber = m_newestNumber;
+    return true;
+}
+
+uint64_t DecoderPool::getDecodedFrames() const {
+    return m_decoded.load(memory_order_relaxed);
+}
+
+uint64_t DecoderPool::getDroppedFrames() const {
+    return m_dropped.load(memory_order_relaxed);
+}
+
+uint64_t DecoderPool::getFailedFrames() const {
+    return m_failed.load(memory_order_relaxed);
+}
+}
+}
+}
+} // opendlv::core::system::proxy
@@ -0,0 +1,100 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdexcept>
+
+#if defined(HAVE_TURBOJPEG)
+#include <turbojpeg.h>
+#else
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#endif
+
+#include "JpegDecoder.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+JpegDecoder::JpegDecoder(const uint32_t &scale)
+    : m_scale(scale)
+    , m_handle(NULL) {
+    if ((1 != scale) && (2 != scale) && (4 != scale) && (8 != scale)) {
+        throw invalid_argument("Invalid JPEG scale! Use 1, 2, 4, or 8");
+    }
+#if defined(HAVE_TURBOJPEG)
+    m_handle = tjInitDecompress();
+#endif
+}
+
+JpegDecoder::~JpegDecoder() {
+#if defined(HAVE_TURBOJPEG)
+    if (m_handle != NULL) {
+        tjDestroy(m_handle);
+    }
+#endif
+}
+
+bool JpegDecoder::decode(const string &jpeg, char *destination, const uint32_t &width, const uint32_t &height) {
+    if ((destination == NULL) || jpeg.empty()) {
+        return false;
+    }
+#if defined(HAVE_TURBOJPEG)
+    if (m_handle == NULL) {
+        return false;
+    }
+    unsigned char *data = reinterpret_cast< unsigned char * >(const_cast< char * >(jpeg.data()));
+    int32_t fullWidth = 0;
+    int32_t fullHeight = 0;
+    int32_t subsampling = 0;
+    int32_t colorspace = 0;
+    if (0 != tjDecompressHeader3(m_handle, data, jpeg.size(), &fullWidth, &fullHeight, &subsampling, &colorspace)) {
+        return false;
+    }
+    const tjscalingfactor factor = {1, static_cast< int32_t >(m_scale)};
+    if ((static_cast< uint32_t >(TJSCALED(fullWidth, factor)) != width) || (static_cast< uint32_t >(TJSCALED(fullHeight, factor)) != height)) {
+        return false;
+    }
+    // Requesting the scaled size makes libjpeg-turbo skip DCT coefficients.
+    return (0 == tjDecompress2(m_handle, data, jpeg.size(), reinterpret_cast< unsigned char * >(destination), width, 0, height, TJPF_BGR, TJFLAG_FASTDCT));
+#else
+    const cv::Mat encoded(1, static_cast< int32_t >(jpeg.size()), CV_8UC1, const_cast< char * >(jpeg.data()));
+    cv::Mat decoded = cv::imdecode(encoded, CV_LOAD_IMAGE_COLOR);
+    if (decoded.empty()) {
+        return false;
+    }
+    if (((static_cast< uint32_t >(decoded.cols) + m_scale - 1) / m_scale != width) || ((static_cast< uint32_t >(decoded.rows) + m_scale - 1) / m_scale != height)) {
+        return false;
+    }
+    cv::Mat image(height, width, CV_8UC3, destination);
+    if (1 == m_scale) {
+        decoded.copyTo(image);
+    } else {
+        cv::resize(decoded, image, image.size(), 0, 0, cv::INTER_AREA);
+    }
+    return true;
+#endif
+}
+}
+}
+}
+} // opendlv::core::system::proxy
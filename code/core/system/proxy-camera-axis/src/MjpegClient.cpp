@@ -0,0 +1,200 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include "MjpegClient.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+namespace {
+const uint32_t RECEIVE_BUFFER_SIZE = 65536;
+const uint32_t MAX_HEADER_SIZE = 8192;
+const int32_t TIMEOUT = 5;
+}
+
+MjpegClient::MjpegClient(const string &address, const string &path, const string &username, const string &password)
+    : m_host(address)
+    , m_port("80")
+    , m_request()
+    , m_socket(-1)
+    , m_receiveBuffer(RECEIVE_BUFFER_SIZE)
+    , m_parser()
+    , m_skippedBytes(0) {
+    const size_t colon = address.find(':');
+    if (string::npos != colon) {
+        m_host = address.substr(0, colon);
+        m_port = address.substr(colon + 1);
+    }
+
+    stringstream request;
+    request << "GET " << path << " HTTP/1.0\r\n"
+            << "Host: " << m_host << "\r\n";
+    if (!username.empty()) {
+        request << "Authorization: Basic " << toBase64(username + ":" + password) << "\r\n";
+    }
+    request << "\r\n";
+    m_request = request.str();
+}
+
+MjpegClient::~MjpegClient() {
+    disconnect();
+}
+
+string MjpegClient::toBase64(const string &data) {
+    const char *ALPHABET = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    string encoded;
+    uint32_t i = 0;
+    for (; i + 2 < data.size(); i += 3) {
+        const uint32_t v = (static_cast< uint8_t >(data[i]) << 16) | (static_cast< uint8_t >(data[i + 1]) << 8) | static_cast< uint8_t >(data[i + 2]);
+        encoded.push_back(ALPHABET[(v >> 18) & 0x3F]);
+        encoded.push_back(ALPHABET[(v >> 12) & 0x3F]);
+        encoded.push_back(ALPHABET[(v >> 6) & 0x3F]);
+        encoded.push_back(ALPHABET[v & 0x3F]);
+    }
+    if (i + 1 == data.size()) {
+        const uint32_t v = static_cast< uint8_t >(data[i]) << 16;
+        encoded.push_back(ALPHABET[(v >> 18) & 0x3F]);
+        encoded.push_back(ALPHABET[(v >> 12) & 0x3F]);
+        encoded.append("==");
+    } else if (i + 2 == data.size()) {
+        const uint32_t v = (static_cast< uint8_t >(data[i]) << 16) | (static_cast< uint8_t >(data[i + 1]) << 8);
+        encoded.push_back(ALPHABET[(v >> 18) & 0x3F]);
+        encoded.push_back(ALPHABET[(v >> 12) & 0x3F]);
+        encoded.push_back(ALPHABET[(v >> 6) & 0x3F]);
+        encoded.push_back('=');
+    }
+    return encoded;
+}
+
+bool MjpegClient::connect() {
+    disconnect();
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *addresses = NULL;
+    if (0 != getaddrinfo(m_host.c_str(), m_port.c_str(), &hints, &addresses)) {
+        return false;
+    }
+    for (struct addrinfo *a = addresses; (a != NULL) && (m_socket < 0); a = a->ai_next) {
+        m_socket = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if ((m_socket >= 0) && (0 != ::connect(m_socket, a->ai_addr, a->ai_addrlen))) {
+            close(m_socket);
+            m_socket = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (m_socket < 0) {
+        return false;
+    }
+
+    struct timeval timeout;
+    timeout.tv_sec = TIMEOUT;
+    timeout.tv_usec = 0;
+    setsockopt(m_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (send(m_socket, m_request.c_str(), m_request.size(), MSG_NOSIGNAL) != static_cast< ssize_t >(m_request.size())) {
+        disconnect();
+        return false;
+    }
+
+    // Read the response header; the rest belongs to the first part.
+    string header;
+    size_t headerEnd = string::npos;
+    while ((string::npos == headerEnd) && (header.size() < MAX_HEADER_SIZE)) {
+        const int32_t length = receive();
+        if (length <= 0) {
+            disconnect();
+            return false;
+        }
+        header.append(m_receiveBuffer.data(), length);
+        headerEnd = header.find("\r\n\r\n");
+    }
+    if ((string::npos == headerEnd) || (string::npos == header.substr(0, header.find("\r\n")).find(" 200"))) {
+        cerr << "[proxy-camera-axis] Unexpected response from " << m_host << ": " << header.substr(0, header.find("\r\n")) << endl;
+        disconnect();
+        return false;
+    }
+
+    const string boundary = MjpegStreamParser::parseBoundary(header.substr(0, headerEnd));
+    if (boundary.empty()) {
+        cerr << "[proxy-camera-axis] " << m_host << " did not send a multipart stream" << endl;
+        disconnect();
+        return false;
+    }
+    m_parser.reset(new MjpegStreamParser(boundary));
+    m_parser->append(header.data() + headerEnd + 4, static_cast< uint32_t >(header.size() - headerEnd - 4));
+    return true;
+}
+
+void MjpegClient::disconnect() {
+    if (m_socket >= 0) {
+        close(m_socket);
+        m_socket = -1;
+    }
+    if (m_parser.get() != NULL) {
+        m_skippedBytes += m_parser->getSkippedBytes();
+        m_parser.reset();
+    }
+}
+
+bool MjpegClient::isConnected() const {
+    return (m_socket >= 0);
+}
+
+int32_t MjpegClient::receive() {
+    return static_cast< int32_t >(recv(m_socket, m_receiveBuffer.data(), m_receiveBuffer.size(), 0));
+}
+
+bool MjpegClient::nextFrame(string &frame) {
+    if (!isConnected()) {
+        return false;
+    }
+    while (!m_parser->nextFrame(frame)) {
+        const int32_t length = receive();
+        if (length <= 0) {
+            disconnect();
+            return false;
+        }
+        m_parser->append(m_receiveBuffer.data(), static_cast< uint32_t >(length));
+    }
+    return true;
+}
+
+uint64_t MjpegClient::getSkippedBytes() const {
+    return m_skippedBytes + ((m_parser.get() != NULL) ? m_parser->getSkippedBytes() : 0);
+}
+}
+}
+}
+} // opendlv::core::system::proxy
@@ -0,0 +1,172 @@
+/**
+ * proxy-camera-axis - Interface to network cameras from Axis.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+#include "MjpegStreamParser.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+namespace {
+const string HEADER_END = "\r\n\r\n";
+const string CONTENT_LENGTH = "content-length:";
+// "\r\n--" in front of every boundary.
+const size_t DELIMITER_PREFIX = 4;
+
+string toLower(const string &s) {
+    string lower(s);
+    transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower;
+}
+}
+
+MjpegStreamParser::MjpegStreamParser(const string &boundary)
+    : m_boundary(boundary)
+    , m_buffer()
+    , m_position(0)
+    , m_skippedBytes(0)
+    , m_skippedParts(0) {}
+
+MjpegStreamParser::~MjpegStreamParser() {}
+
+string MjpegStreamParser::parseBoundary(const string &contentType) {
+    const string KEY = "boundary=";
+    const size_t position = toLower(contentType).find(KEY);
+    if (string::npos == position) {
+        return "";
+    }
+    string boundary = contentType.substr(position + KEY.size());
+    boundary = boundary.substr(0, boundary.find(';'));
+    boundary.erase(remove(boundary.begin(), boundary.end(), '"'), boundary.end());
+    boundary.erase(remove(boundary.begin(), boundary.end(), ' '), boundary.end());
+    boundary.erase(remove(boundary.begin(), boundary.end(), '\r'), boundary.end());
+    // Some cameras announce the boundary with the leading dashes of the delimiter.
+    if (0 == boundary.compare(0, 2, "--")) {
+        boundary.erase(0, 2);
+    }
+    return boundary;
+}
+
+void MjpegStreamParser::append(const char *data, const uint32_t &length) {
+    m_buffer.append(data, length);
+}
+
+bool MjpegStreamParser::nextFrame(string &frame) {
+    if (m_boundary.empty()) {
+        return false;
+    }
+
+    const size_t start = m_buffer.find(m_boundary, m_position);
+    if (string::npos == start) {
+        // Keep the tail as it might hold the beginning of the next boundary.
+        const size_t keep = min(m_buffer.size() - m_position, m_boundary.size() + DELIMITER_PREFIX);
+        m_skippedBytes += m_buffer.size() - m_position - keep;
+        m_position = m_buffer.size() - keep;
+        compact();
+        return false;
+    }
+    // The dashes and the line break in front of the boundary belong to the delimiter.
+    size_t delimiter = start;
+    if ((delimiter >= m_position + 2) && (0 == m_buffer.compare(delimiter - 2, 2, "--"))) {
+        delimiter -= 2;
+        if ((delimiter >= m_position + 2) && (0 == m_buffer.compare(delimiter - 2, 2, "\r\n"))) {
+            delimiter -= 2;
+        }
+    }
+    m_skippedBytes += delimiter - m_position;
+    m_position = start;
+
+    const size_t headerEnd = m_buffer.find(HEADER_END, start);
+    if (string::npos == headerEnd) {
+        compact();
+        return false;
+    }
+    const size_t bodyStart = headerEnd + HEADER_END.size();
+    const size_t maxPartSize = MAX_PART_SIZE;
+
+    const string headers = toLower(m_buffer.substr(start, headerEnd - start));
+    const size_t contentLength = headers.find(CONTENT_LENGTH);
+    size_t bodyEnd = 0;
+    if (string::npos != contentLength) {
+        const size_t length = strtoul(headers.c_str() + contentLength + CONTENT_LENGTH.size(), NULL, 10);
+        if (length > maxPartSize) {
+            return skipPart(bodyStart, frame);
+        }
+        bodyEnd = bodyStart + length;
+        if (m_buffer.size() < bodyEnd) {
+            compact();
+            return false;
+        }
+    } else {
+        const size_t next = m_buffer.find(m_boundary, bodyStart);
+        if (string::npos == next) {
+            if (m_buffer.size() - bodyStart > maxPartSize + m_boundary.size() + DELIMITER_PREFIX) {
+                return skipPart(bodyStart, frame);
+            }
+            compact();
+            return false;
+        }
+        bodyEnd = next;
+        if ((bodyEnd >= bodyStart + 2) && (0 == m_buffer.compare(bodyEnd - 2, 2, "--"))) {
+            bodyEnd -= 2;
+        }
+        if ((bodyEnd >= bodyStart + 2) && (0 == m_buffer.compare(bodyEnd - 2, 2, "\r\n"))) {
+            bodyEnd -= 2;
+        }
+    }
+
+    frame.assign(m_buffer, bodyStart, bodyEnd - bodyStart);
+    m_position = bodyEnd;
+    compact();
+    return true;
+}
+
+bool MjpegStreamParser::skipPart(const size_t &bodyStart, string &frame) {
+    // The body is counted as skipped while searching for the next boundary.
+    m_skippedParts++;
+    m_position = bodyStart;
+    return nextFrame(frame);
+}
+
+uint64_t MjpegStreamParser::getSkippedBytes() const {
+    return m_skippedBytes;
+}
+
+uint64_t MjpegStreamParser::getSkippedParts() const {
+    return m_skippedParts;
+}
+
+void MjpegStreamParser::compact() {
+    // Moving the unparsed bytes to the front is cheap once most of the buffer was consumed.
+    if ((m_position > 0) && (m_position >= m_buffer.size() / 2)) {
+        m_buffer.erase(0, m_position);
+        m_position = 0;
+    }
+}
+}
+}
+}
+} // opendlv::core::system::proxy
@@ -19,8 +19,12 @@
 
 #include <stdint.h>
 
+#include <chrono>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <opencv2/highgui/highgui.hpp>
 
@@ -28,6 +32,9 @@
 #include <opendavinci/odcore/data/TimeStamp.h>
 #include <opendavinci/odcore/strings/StringToolbox.h>
 
+#include "odvdvehicle/generated/opendlv/proxy/ImageReadingCompressed.h"
+#include "odvdvehicle/generated/opendlv/system/HealthStatus.h"
+
 #include "AxisCamera.h"
 
 #include "ProxyCamera.h"
@@ -43,7 +50,9 @@ using namespace odcore::data;
 
 ProxyCamera::ProxyCamera(const int &argc, char **argv)
     : TimeTriggeredConferenceClientModule(argc, argv, "proxy-camera-axis")
-    , m_camera() {}
+    , m_camera()
+    , m_captureThread()
+    , m_latencyPeriod(0) {}
 
 ProxyCamera::~ProxyCamera() {}
 
@@ -61,35 +70,185 @@ void ProxyCamera::setUp() {
     catch(...) {
         CALIBRATION_FILE = "";
     }
+    // Undistortion maps saved by camera-calibration replace computing them from the calibration file.
+    string UNDISTORTION_MAPS_FILE = "";
+    try {
+        UNDISTORTION_MAPS_FILE = getKeyValueConfiguration().getValue< string >("proxy-camera-axis.undistortionmapsfile");
+        odcore::strings::StringToolbox::trim(UNDISTORTION_MAPS_FILE);
+    }
+    catch(...) {
+        UNDISTORTION_MAPS_FILE = "";
+    }
     const bool DEBUG = getKeyValueConfiguration().getValue< bool >("proxy-camera-axis.debug") == 1;
+    uint32_t REMAP_THREADS = 1;
+    try {
+        REMAP_THREADS = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.remapthreads");
+    }
+    catch(...) {
+        REMAP_THREADS = 1;
+    }
+    // 0 receives and decodes the stream with OpenCV.
+    uint32_t DECODER_THREADS = 0;
+    try {
+        DECODER_THREADS = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.decoderthreads");
+    }
+    catch(...) {
+        DECODER_THREADS = 0;
+    }
+    uint32_t SCALE = 1;
+    try {
+        SCALE = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.scale");
+    }
+    catch(...) {
+        SCALE = 1;
+    }
 
-    m_camera = unique_ptr< Camera >(new AxisCamera(NAME, ADDRESS, USERNAME, PASSWORD, WIDTH, HEIGHT, CALIBRATION_FILE, DEBUG));
+    m_camera = unique_ptr< Camera >(new AxisCamera(NAME, ADDRESS, USERNAME, PASSWORD, WIDTH, HEIGHT, CALIBRATION_FILE, UNDISTORTION_MAPS_FILE, DEBUG, REMAP_THREADS, DECODER_THREADS, SCALE));
     if (m_camera.get() == NULL) {
         cerr << "[" << getName() << "] No valid camera type defined." << endl;
+    } else {
+        // Ring of shared memory segments so that readers have time to copy a frame.
+        uint32_t SLOTS = 1;
+        try {
+            SLOTS = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.slots");
+        } catch (...) {
+        }
+        m_camera->setNumberOfSlots(SLOTS);
+
+        // raw publishes SharedImages, compressed publishes JPEG frames, e.g. for recording.
+        string OUTPUT = "raw";
+        try {
+            OUTPUT = getKeyValueConfiguration().getValue< string >("proxy-camera-axis.output");
+            odcore::strings::StringToolbox::trim(OUTPUT);
+        } catch (...) {
+        }
+        if (("raw" != OUTPUT) && ("compressed" != OUTPUT) && ("both" != OUTPUT)) {
+            throw invalid_argument("Unsupported output '" + OUTPUT + "'! Use raw, compressed, or both");
+        }
+        uint32_t QUALITY = 90;
+        try {
+            QUALITY = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.jpeg.quality");
+        } catch (...) {
+        }
+        m_camera->setOutputs("compressed" != OUTPUT, "raw" != OUTPUT, QUALITY);
+
+        // Derived images, e.g. half resolution or a region of interest, in segments <name>.<derived>.
+        string DERIVED = "";
+        try {
+            DERIVED = getKeyValueConfiguration().getValue< string >("proxy-camera-axis.derived");
+        } catch (...) {
+        }
+        vector< string > derivedNames = odcore::strings::StringToolbox::split(DERIVED, ',');
+        for (uint32_t i = 0; i < derivedNames.size(); i++) {
+            string derivedName = derivedNames.at(i);
+            odcore::strings::StringToolbox::trim(derivedName);
+            if (derivedName.empty()) {
+                continue;
+            }
+            // scale,gray or scale,gray,x,y,width,height.
+            const string KEY = "proxy-camera-axis.derived." + derivedName;
+            vector< string > derived = odcore::strings::StringToolbox::split(getKeyValueConfiguration().getValue< string >(KEY), ',');
+            if ((2 != derived.size()) && (6 != derived.size())) {
+                throw invalid_argument("Invalid " + KEY + "! Expected scale,gray or scale,gray,x,y,width,height");
+            }
+            uint32_t roi[4] = {0, 0, WIDTH, HEIGHT};
+            for (uint32_t j = 2; j < derived.size(); j++) {
+                roi[j - 2] = static_cast< uint32_t >(stoul(derived.at(j)));
+            }
+            m_camera->addDerivedImage(derivedName, roi[0], roi[1], roi[2], roi[3], static_cast< uint32_t >(stoul(derived.at(0))), 1 == stoul(derived.at(1)));
+            cout << "[" << getName() << "] Deriving '" << derivedName << "' from " << roi[2] << "x" << roi[3] << "+" << roi[0] << "+" << roi[1] << endl;
+        }
+        m_captureThread = unique_ptr< CaptureThread >(new CaptureThread(*m_camera));
+    }
+
+    // Ages of the frames at capture, conversion, shared memory, and sending as HealthStatus; 0 disables them.
+    m_latencyPeriod = 1000;
+    try {
+        m_latencyPeriod = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera-axis.latency.telemetryPeriod");
+    } catch (...) {
     }
 }
 
-void ProxyCamera::tearDown() {}
+void ProxyCamera::tearDown() {
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->stop();
+    }
+}
+
+void ProxyCamera::publishLatencies(Camera &camera) {
+    const char *STAGES[Camera::NUMBER_OF_LATENCY_STAGES] = {"grabbed", "converted", "copied", "sent"};
+    opendlv::system::HealthStatus hs;
+    for (uint32_t i = 0; i < Camera::NUMBER_OF_LATENCY_STAGES; i++) {
+        const LatencyHistogram::Summary summary = camera.getLatency(static_cast< Camera::LatencyStage >(i));
+        const string KEY = "proxy-camera-axis." + camera.getName() + ".latency." + STAGES[i];
+        hs.putTo_MapOfStatus(KEY + ".count", to_string(summary.count));
+        hs.putTo_MapOfStatus(KEY + ".p50", to_string(summary.p50));
+        hs.putTo_MapOfStatus(KEY + ".p99", to_string(summary.p99));
+        hs.putTo_MapOfStatus(KEY + ".max", to_string(summary.max));
+    }
+    Container c(hs);
+    getConference().send(c);
+}
 
 odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode ProxyCamera::body() {
+    // Frames are captured as they arrive; every cycle publishes the newest one.
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->start();
+    }
+
     uint32_t captureCounter = 0;
+    string compressedFrame;
+    vector< odcore::data::image::SharedImage > derivedImages;
+    if (m_camera.get() != NULL) {
+        derivedImages = m_camera->getDerivedImages();
+    }
+    chrono::steady_clock::time_point lastLatencies = chrono::steady_clock::now();
     while (getModuleStateAndWaitForRemainingTimeInTimeslice() == odcore::data::dmcp::ModuleStateMessage::RUNNING) {
-        if (m_camera.get() != NULL) {
-            // Capture frame.
-            odcore::data::image::SharedImage si = m_camera->capture();
-            TimeStamp now;
-
-            // Create container with meta-information about captured frame.
-            Container c(si);
-            c.setSampleTimeStamp(now);
+        odcore::data::image::SharedImage si;
+        TimeStamp sampleTimeStamp;
+        bool rawFrame = false;
+        if ((m_captureThread.get() != NULL) && m_captureThread->getNewestFrame(si, compressedFrame, rawFrame, sampleTimeStamp)) {
+            if (m_camera->hasRawOutput() && rawFrame) {
+                // Create container with meta-information about captured frame.
+                Container c(si);
+                c.setSampleTimeStamp(sampleTimeStamp);
 
-            // Share container for recording.
-            getConference().send(c);
+                // Share container for recording.
+                getConference().send(c);
+            }
+            // The derived images of the frame.
+            for (uint32_t i = 0; rawFrame && (i < derivedImages.size()); i++) {
+                Container c(derivedImages.at(i));
+                c.setSampleTimeStamp(sampleTimeStamp);
+                getConference().send(c);
+            }
+            if (m_camera->hasCompressedOutput()) {
+                // The frame itself travels in the container; it is recorded without decoding.
+                opendlv::proxy::ImageReadingCompressed irc;
+                irc.setName(m_camera->getName());
+                irc.setWidth(si.getWidth());
+                irc.setHeight(si.getHeight());
+                irc.setFormat("jpeg");
+                irc.setData(compressedFrame);
+                Container c(irc);
+                c.setSampleTimeStamp(sampleTimeStamp);
+                getConference().send(c);
+            }
+            m_camera->addLatency(Camera::SENT, TimeStamp().toMicroseconds() - sampleTimeStamp.toMicroseconds());
 
             captureCounter++;
         }
+        if ((m_camera.get() != NULL) && (m_latencyPeriod > 0) && (chrono::steady_clock::now() - lastLatencies >= chrono::milliseconds(m_latencyPeriod))) {
+            lastLatencies = chrono::steady_clock::now();
+            publishLatencies(*m_camera);
+        }
+    }
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->stop();
+        cout << "[" << getName() << "] Captured " << m_captureThread->getCapturedFrames() << " frames, dropped "
+             << m_captureThread->getDroppedFrames() << ", " << m_captureThread->getDuplicateFrames() << " duplicate." << endl;
     }
-    cout << "[" << getName() << "] Captured " << captureCounter << " frames." << endl;
+    cout << "[" << getName() << "] Published " << captureCounter << " frames." << endl;
     return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
 }
 }
@@ -22,12 +22,36 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "LatencyHistogram.h"
+#include "UndistortionMaps.h"
+
 // Include local header files.
+#include "../include/DecoderPool.h"
+#include "../include/JpegDecoder.h"
+#include "../include/MjpegClient.h"
+#include "../include/MjpegStreamParser.h"
 #include "../include/ProxyCamera.h"
 
 using namespace std;
 using namespace odcore::data;
 using namespace opendlv::core::system::proxy;
+using opendlv::core::LatencyHistogram;
 
 /**
  * This class derives from SensorBoard to allow access to protected methods.
@@ -43,6 +67,111 @@ class ProxyTestling : public ProxyCamera {
         // Here, you need to add all methods which are protected in ProxyCamera and which are needed for the test cases.
 };
 
+/**
+ * This class serves a canned MJPEG stream on a loopback port. Every
+ * connection gets the frames once and is closed afterwards; a request
+ * without the expected credentials is answered with 401.
+ */
+class MjpegTestServer {
+    public:
+        MjpegTestServer(const vector< string > &frames, const string &authorization) :
+            m_frames(frames),
+            m_authorization(authorization),
+            m_socket(-1),
+            m_port(0),
+            m_running(true),
+            m_mutex(),
+            m_requests(),
+            m_thread() {
+            m_socket = socket(AF_INET, SOCK_STREAM, 0);
+            struct sockaddr_in address;
+            memset(&address, 0, sizeof(address));
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = 0;
+            socklen_t length = sizeof(address);
+            if (   (0 == ::bind(m_socket, reinterpret_cast< struct sockaddr * >(&address), sizeof(address)))
+                && (0 == listen(m_socket, 4))
+                && (0 == getsockname(m_socket, reinterpret_cast< struct sockaddr * >(&address), &length)) ) {
+                m_port = ntohs(address.sin_port);
+            }
+            m_thread = thread(&MjpegTestServer::run, this);
+        }
+
+        ~MjpegTestServer() {
+            m_running.store(false);
+            m_thread.join();
+            close(m_socket);
+        }
+
+        string getAddress() const {
+            return "127.0.0.1:" + to_string(m_port);
+        }
+
+        vector< string > getRequests() {
+            lock_guard< mutex > l(m_mutex);
+            return m_requests;
+        }
+
+    private:
+        MjpegTestServer(const MjpegTestServer &);
+        MjpegTestServer& operator=(const MjpegTestServer &);
+
+        void run() {
+            struct pollfd fd;
+            fd.fd = m_socket;
+            fd.events = POLLIN;
+            while (m_running.load()) {
+                fd.revents = 0;
+                if (::poll(&fd, 1, 10) <= 0) {
+                    continue;
+                }
+                const int32_t connection = accept(m_socket, NULL, NULL);
+                if (connection >= 0) {
+                    serve(connection);
+                    close(connection);
+                }
+            }
+        }
+
+        void serve(const int32_t &connection) {
+            string request;
+            char buffer[1024];
+            while (string::npos == request.find("\r\n\r\n")) {
+                const ssize_t length = recv(connection, buffer, sizeof(buffer), 0);
+                if (length <= 0) {
+                    return;
+                }
+                request.append(buffer, length);
+            }
+            {
+                lock_guard< mutex > l(m_mutex);
+                m_requests.push_back(request);
+            }
+
+            string response;
+            if (string::npos == request.find("Authorization: Basic " + m_authorization + "\r\n")) {
+                response = "HTTP/1.0 401 Unauthorized\r\n\r\n";
+            } else {
+                response = "HTTP/1.0 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=myboundary\r\n\r\n";
+                for (uint32_t i = 0; i < m_frames.size(); i++) {
+                    response += "--myboundary\r\nContent-Type: image/jpeg\r\ncontent-length: " + to_string(m_frames[i].size()) + "\r\n\r\n" + m_frames[i] + "\r\n";
+                }
+            }
+            send(connection, response.data(), response.size(), MSG_NOSIGNAL);
+        }
+
+    private:
+        vector< string > m_frames;
+        string m_authorization;
+        int32_t m_socket;
+        uint16_t m_port;
+        atomic< bool > m_running;
+        mutex m_mutex;
+        vector< string > m_requests;
+        thread m_thread;
+};
+
 /**
  * The actual testsuite starts here.
  */
@@ -74,6 +203,205 @@ class ProxyCameraTest : public CxxTest::TestSuite {
         //TS_ASSERT(true);
         TS_ASSERT(dt != NULL);
     }
+
+    void testMjpegBoundary() {
+        TS_ASSERT(MjpegStreamParser::parseBoundary("multipart/x-mixed-replace; boundary=myboundary") == "myboundary");
+        TS_ASSERT(MjpegStreamParser::parseBoundary("multipart/x-mixed-replace;boundary=\"--myboundary\"") == "myboundary");
+        TS_ASSERT(MjpegStreamParser::parseBoundary("image/jpeg") == "");
+    }
+
+    void testMjpegStreamParser() {
+        const string stream("garbage--myboundary\r\nContent-Type: image/jpeg\r\ncontent-length: 5\r\n\r\nfirst\r\n"
+                            "--myboundary\r\nContent-Type: image/jpeg\r\n\r\nsecond\r\n--myboundary\r\n");
+
+        // Feeding the stream byte by byte must give the same parts.
+        MjpegStreamParser parser("myboundary");
+        vector< string > frames;
+        string frame;
+        for (uint32_t i = 0; i < stream.size(); i++) {
+            parser.append(stream.data() + i, 1);
+            while (parser.nextFrame(frame)) {
+                frames.push_back(frame);
+            }
+        }
+        TS_ASSERT(frames.size() == 2);
+        TS_ASSERT(frames[0] == "first");
+        TS_ASSERT(frames[1] == "second");
+        TS_ASSERT(parser.getSkippedBytes() == 7);
+    }
+
+    void testMjpegStreamParserOversizedPart() {
+        // A corrupt Content-Length must not hold back the following parts.
+        const string oversized("--myboundary\r\ncontent-length: 4000000000\r\n\r\nbroken\r\n");
+        const string stream(oversized + "--myboundary\r\ncontent-length: 4\r\n\r\nnext\r\n");
+
+        MjpegStreamParser parser("myboundary");
+        parser.append(stream.data(), static_cast< uint32_t >(stream.size()));
+        string frame;
+        TS_ASSERT(parser.nextFrame(frame));
+        TS_ASSERT(frame == "next");
+        TS_ASSERT(parser.getSkippedParts() == 1);
+        TS_ASSERT(parser.getSkippedBytes() == string("broken").size());
+        TS_ASSERT(!parser.nextFrame(frame));
+    }
+
+    void testBase64() {
+        TS_ASSERT(MjpegClient::toBase64("root:pass") == "cm9vdDpwYXNz");
+        TS_ASSERT(MjpegClient::toBase64("a") == "YQ==");
+        TS_ASSERT(MjpegClient::toBase64("ab") == "YWI=");
+    }
+
+    void testMjpegClient() {
+        vector< string > frames;
+        frames.push_back("first");
+        frames.push_back(string(100000, 'x'));
+        MjpegTestServer server(frames, MjpegClient::toBase64("root:pass"));
+
+        // The credentials are checked by the server.
+        MjpegClient unauthorized(server.getAddress(), "/mjpg/video.mjpg", "root", "wrong");
+        TS_ASSERT(!unauthorized.connect());
+        TS_ASSERT(!unauthorized.isConnected());
+
+        MjpegClient client(server.getAddress(), "/mjpg/video.mjpg", "root", "pass");
+        string frame;
+        TS_ASSERT(!client.nextFrame(frame));
+        TS_ASSERT(client.connect());
+        TS_ASSERT(client.isConnected());
+        TS_ASSERT(client.nextFrame(frame));
+        TS_ASSERT(frame == "first");
+        TS_ASSERT(client.nextFrame(frame));
+        TS_ASSERT(frame == frames[1]);
+
+        // The server closes the stream; the client gets it again after reconnecting.
+        TS_ASSERT(!client.nextFrame(frame));
+        TS_ASSERT(!client.isConnected());
+        TS_ASSERT(client.connect());
+        TS_ASSERT(client.nextFrame(frame));
+        TS_ASSERT(frame == "first");
+        TS_ASSERT(client.getSkippedBytes() == 0);
+
+        const vector< string > requests = server.getRequests();
+        TS_ASSERT(requests.size() == 3);
+        if (requests.size() == 3) {
+            TS_ASSERT(requests[1].find("GET /mjpg/video.mjpg HTTP/1.0\r\n") == 0);
+            TS_ASSERT(requests[1].find("Authorization: Basic cm9vdDpwYXNz\r\n") != string::npos);
+        }
+    }
+
+    void testDecoderPoolThroughput() {
+        cv::Mat image(720, 1280, CV_8UC3);
+        cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(255));
+        vector< uchar > encoded;
+        TS_ASSERT(cv::imencode(".jpg", image, encoded));
+        const string jpeg(encoded.begin(), encoded.end());
+
+        // Frames are submitted as fast as the workers take them, so none is dropped.
+        const uint32_t FRAMES = 100;
+        const uint32_t threads[2] = {1, max(2u, thread::hardware_concurrency())};
+        for (uint32_t t = 0; t < 2; t++) {
+            DecoderPool pool(threads[t], 1, 1280, 720);
+            string buffer;
+            const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < FRAMES; i++) {
+                while (i - pool.getDecodedFrames() - pool.getFailedFrames() >= threads[t]) {
+                    this_thread::sleep_for(chrono::microseconds(100));
+                }
+                buffer = jpeg;
+                pool.submit(buffer);
+            }
+            while (pool.getDecodedFrames() + pool.getFailedFrames() < FRAMES) {
+                this_thread::sleep_for(chrono::microseconds(100));
+            }
+            const double seconds = chrono::duration< double >(chrono::steady_clock::now() - start).count();
+            cout << "DecoderPool with " << threads[t] << " threads decodes " << FRAMES / seconds << " frames/s of 1280x720." << endl;
+            TS_ASSERT(pool.getDecodedFrames() == FRAMES);
+            TS_ASSERT(pool.getFailedFrames() == 0);
+
+            vector< char > newest(1280 * 720 * 3);
+            TS_ASSERT(pool.getNewestFrame(newest.data()));
+        }
+    }
+
+    void testJpegDecoder() {
+        cv::Mat image(48, 64, CV_8UC3, cv::Scalar(10, 100, 200));
+        vector< uchar > encoded;
+        TS_ASSERT(cv::imencode(".jpg", image, encoded));
+        const string jpeg(encoded.begin(), encoded.end());
+
+        vector< char > full(64 * 48 * 3);
+        JpegDecoder decoder(1);
+        TS_ASSERT(decoder.decode(jpeg, full.data(), 64, 48));
+        TS_ASSERT(abs(static_cast< uint8_t >(full[0]) - 10) < 4);
+        TS_ASSERT(abs(static_cast< uint8_t >(full[2]) - 200) < 4);
+        // The size must match the expected one.
+        TS_ASSERT(!decoder.decode(jpeg, full.data(), 32, 24));
+
+        vector< char > half(32 * 24 * 3);
+        JpegDecoder halfDecoder(2);
+        TS_ASSERT(halfDecoder.decode(jpeg, half.data(), 32, 24));
+        TS_ASSERT(abs(static_cast< uint8_t >(half[1]) - 100) < 4);
+
+        TS_ASSERT_THROWS(JpegDecoder invalid(3), std::invalid_argument);
+    }
+
+    void testUndistortionMaps() {
+        const cv::Mat cameraMatrix = (cv::Mat_< double >(3, 3) << 600, 0, 320, 0, 600, 240, 0, 0, 1);
+        const cv::Mat distortionCoefficients = (cv::Mat_< double >(1, 5) << -0.1, 0.02, 0, 0, 0);
+        cv::Mat full1;
+        cv::Mat full2;
+        opendlv::core::UndistortionMaps::compute(cameraMatrix, distortionCoefficients, cv::Size(640, 480), full1, full2);
+
+        // Maps of the frames' size are used as they are.
+        cv::Mat fitted1;
+        cv::Mat fitted2;
+        opendlv::core::UndistortionMaps::fit(full1, full2, cv::Size(640, 480), 2, fitted1, fitted2);
+        TS_ASSERT(cv::countNonZero(fitted1.reshape(1) != full1.reshape(1)) == 0);
+
+        // Maps of the camera's full frames are downscaled with the frames.
+        opendlv::core::UndistortionMaps::fit(full1, full2, cv::Size(320, 240), 2, fitted1, fitted2);
+        TS_ASSERT(fitted1.size() == cv::Size(320, 240));
+        TS_ASSERT(fitted1.type() == CV_16SC2);
+        cv::Mat halfMatrix = cameraMatrix.clone();
+        cv::Mat focalLengthsAndCenter = halfMatrix.rowRange(0, 2);
+        focalLengthsAndCenter /= 2.0;
+        cv::Mat half1;
+        cv::Mat half2;
+        opendlv::core::UndistortionMaps::compute(halfMatrix, distortionCoefficients, cv::Size(320, 240), half1, half2);
+        cv::Mat fittedX;
+        cv::Mat fittedY;
+        cv::Mat halfX;
+        cv::Mat halfY;
+        cv::convertMaps(fitted1, fitted2, fittedX, fittedY, CV_32FC1);
+        cv::convertMaps(half1, half2, halfX, halfY, CV_32FC1);
+        TS_ASSERT(cv::norm(fittedX, halfX, cv::NORM_INF) < 0.5);
+        TS_ASSERT(cv::norm(fittedY, halfY, cv::NORM_INF) < 0.5);
+
+        // Maps of another camera are rejected.
+        TS_ASSERT_THROWS(opendlv::core::UndistortionMaps::fit(full1, full2, cv::Size(320, 240), 1, fitted1, fitted2), std::invalid_argument);
+        TS_ASSERT_THROWS(opendlv::core::UndistortionMaps::fit(full1, full2, cv::Size(200, 150), 4, fitted1, fitted2), std::invalid_argument);
+    }
+
+    void testLatencyHistogram() {
+        LatencyHistogram histogram;
+        for (int64_t i = 1; i <= 100; i++) {
+            histogram.add(i * 1000);
+        }
+        const LatencyHistogram::Summary summary = histogram.getSummaryAndReset();
+        TS_ASSERT(summary.count == 100);
+        TS_ASSERT(summary.max == 100000);
+        // Buckets are 12.5 % wide.
+        TS_ASSERT((summary.p50 >= 50000) && (summary.p50 < 50000 * 1.125));
+        TS_ASSERT((summary.p99 >= 99000) && (summary.p99 <= 100000));
+        TS_ASSERT(histogram.getSummaryAndReset().count == 0);
+
+        // A median of 0 us is a valid result.
+        for (uint32_t i = 0; i < 100; i++) {
+            histogram.add((i < 60) ? 0 : 1000);
+        }
+        const LatencyHistogram::Summary zeroMedian = histogram.getSummaryAndReset();
+        TS_ASSERT(zeroMedian.p50 == 0);
+        TS_ASSERT(zeroMedian.p99 == 1000);
+    }
    
    ////////////////////////////////////////////////////////////////////////////////////
         // Below this line the necessary constructor for initializing the pointer variables,
@@ -0,0 +1,91 @@
+/**
+ * proxy-camera - Interface to OpenCV-based cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMECONVERTER_H_
+#define FRAMECONVERTER_H_
+
+#include <stdint.h>
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class converts a frame from the camera's pixel format into the
+ * format of the shared memory, rotates it by 180 degrees for cameras that
+ * are mounted upside down, and writes it to the shared memory, all in one
+ * pass over the pixels and without allocating memory.
+ *
+ * Sources are BGR (OpenCV), YUYV, or GREY (V4L2); destinations have 1
+ * (gray), 2 (YUYV, from YUYV only), or 3 (BGR) bytes per pixel. The gray
+ * and BGR values are computed with the fixed-point coefficients of OpenCV's
+ * cvtColor (BT.601), so the results are the same as converting with
+ * cvtColor. Extracting the luma of YUYV uses SSE2 if available.
+ */
+class FrameConverter {
+   public:
+    enum PixelFormat {
+        BGR,
+        YUYV,
+        GREY
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param width Width of the frames.
+     * @param height Height of the frames.
+     * @param source Pixel format of the camera's frames.
+     * @param bpp Bytes per pixel in the shared memory.
+     * @param flipped Rotate by 180 degrees.
+     */
+    FrameConverter(const uint32_t &width, const uint32_t &height, const PixelFormat &source, const uint32_t &bpp, const bool &flipped);
+    virtual ~FrameConverter();
+
+    /**
+     * This method converts a frame.
+     *
+     * @param source Frame from the camera.
+     * @param sourceStride Bytes per row of the source frame.
+     * @param destination Shared memory of width * height * bpp bytes.
+     */
+    void convert(const char *source, const uint32_t &sourceStride, char *destination) const;
+
+    /**
+     * @return Bytes per pixel of the camera's frames.
+     */
+    static uint32_t getBytesPerPixel(const PixelFormat &format);
+
+   private:
+    void convertRow(const uint8_t *source, uint8_t *destination) const;
+
+   private:
+    uint32_t m_width;
+    uint32_t m_height;
+    PixelFormat m_source;
+    uint32_t m_bpp;
+    bool m_flipped;
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*FRAMECONVERTER_H_*/
@@ -0,0 +1,140 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FRAMESYNCHRONIZER_H_
+#define FRAMESYNCHRONIZER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class groups the frames of several cameras into synchronized sets.
+ *
+ * Every camera has at most one pending frame; a newer frame replaces it.
+ * As soon as every camera has a pending frame and the capture times of
+ * these frames are at most the tolerance apart, they form a set. Pending
+ * frames that are older than the newest one minus the tolerance cannot be
+ * part of a set anymore and are dropped. The newest complete set is kept
+ * until it is taken or replaced by the next one.
+ *
+ * A camera with a ring of slots overwrites the slot of a frame after as
+ * many frames as it has slots. A set is thus dropped instead of taken once
+ * the slot of one of its frames is reused, or is about to be reused by the
+ * frame that the camera is capturing.
+ *
+ * This class is not thread-safe.
+ */
+class FrameSynchronizer {
+   public:
+    struct Frame {
+        Frame()
+            : sharedImage()
+            , compressedFrame()
+            , timeStamp(0)
+            , frameNumber(0)
+            , valid(false) {}
+
+        odcore::data::image::SharedImage sharedImage;
+        std::string compressedFrame;
+        int64_t timeStamp; // Capture time in microseconds.
+        uint64_t frameNumber; // As in the trailer of the frame's slot.
+        bool valid;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param numberOfCameras Number of frames per set.
+     * @param tolerance Largest difference of capture times in a set in microseconds.
+     */
+    FrameSynchronizer(const uint32_t &numberOfCameras, const int64_t &tolerance);
+    virtual ~FrameSynchronizer();
+
+    /**
+     * This method sets the number of slots of a camera; without, its slots
+     * are not checked for reuse.
+     *
+     * @param camera Index of the camera.
+     * @param slots Number of slots written in turn.
+     */
+    void setNumberOfSlots(const uint32_t &camera, const uint32_t &slots);
+
+    /**
+     * This method adds a captured frame.
+     *
+     * @param camera Index of the camera.
+     * @param sharedImage Meta information about the frame.
+     * @param frameNumber Number of the frame, counted by the camera from 1.
+     * @param compressedFrame JPEG bitstream of the frame, if any; its content is swapped with a recycled buffer.
+     * @param timeStamp Capture time in microseconds.
+     * @return true if the frame completed a set.
+     */
+    bool add(const uint32_t &camera, const odcore::data::image::SharedImage &sharedImage, const uint64_t &frameNumber, std::string &compressedFrame, const int64_t &timeStamp);
+
+    /**
+     * This method returns the newest set if it was not returned before.
+     *
+     * @param set Frames of the set, one per camera; swapped with the internal buffers.
+     * @return true if there is a new set whose slots are not reused.
+     */
+    bool getNewestSet(std::vector< Frame > &set);
+
+    uint64_t getSets() const;
+    uint64_t getDroppedFrames() const;
+    uint64_t getDroppedSets() const;
+    uint64_t getOverwrittenSets() const;
+
+    /**
+     * @return Difference of the capture times in the newest set in microseconds.
+     */
+    int64_t getSkew() const;
+    int64_t getMaximumSkew() const;
+    int64_t getMeanSkew() const;
+
+   private:
+    std::vector< Frame > m_pending;
+    std::vector< Frame > m_set;
+    std::vector< uint32_t > m_slots; // Per camera; 0 if not checked.
+    std::vector< uint64_t > m_frameNumbers; // Newest frame per camera.
+    int64_t m_tolerance;
+    bool m_hasNewSet;
+
+    uint64_t m_sets;
+    uint64_t m_droppedFrames;
+    uint64_t m_droppedSets;
+    uint64_t m_overwrittenSets;
+    int64_t m_skew;
+    int64_t m_maximumSkew;
+    int64_t m_skewSum;
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*FRAMESYNCHRONIZER_H_*/
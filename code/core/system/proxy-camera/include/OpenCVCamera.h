@@ -20,9 +20,13 @@
 #ifndef OPENCVCAMERA_H_
 #define OPENCVCAMERA_H_
 
+#include <memory>
+
 #include <opencv2/highgui/highgui.hpp>
 
 #include "Camera.h"
+#include "FrameConverter.h"
+#include "FrameViewer.h"
 
 namespace opendlv {
 namespace core {
@@ -33,6 +37,9 @@ using namespace std;
 
 /**
  * This class wraps an OpenCV camera and captures its data into a shared memory segment.
+ *
+ * OpenCV delivers BGR frames in its own buffer; they are converted to gray
+ * if needed, flipped, and copied into the shared memory in one pass.
  */
 class OpenCVCamera : public Camera {
    private:
@@ -64,7 +71,7 @@ class OpenCVCamera : public Camera {
      * @param width Expected image width.
      * @param height Expected image height.
      * @param bpp Bytes per pixel.
-     * @param debug Show live image feed.
+     * @param debug Show live image feed on a separate thread.
      * @param flipped Is the camera mounted upside down?
      */
     OpenCVCamera(const string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp, const bool &debug, const bool &flipped);
@@ -77,9 +84,9 @@ class OpenCVCamera : public Camera {
 
    private:
     CvCapture *m_capture;
-    IplImage *m_image;
-    bool m_debug;
-    bool m_flipped;
+    IplImage *m_image; // Owned by m_capture.
+    FrameConverter m_converter;
+    unique_ptr< FrameViewer > m_viewer; // Only set when debugging.
 };
 }
 }
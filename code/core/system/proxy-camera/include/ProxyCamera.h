@@ -22,11 +22,15 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include <opendavinci/odcore/data/Container.h>
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 
 #include "Camera.h"
+#include "CaptureThread.h"
+#include "SynchronizedCaptureThread.h"
 
 namespace opendlv {
 namespace core {
@@ -36,7 +40,10 @@ namespace proxy {
 using namespace std;
 
 /**
- * Interface to OpenCV-supported /dev/node based cameras.
+ * Interface to OpenCV-supported or V4L2 /dev/node based cameras.
+ *
+ * With several cameras, their frames are grouped into synchronized sets by
+ * capture time and every set is published in one go.
  */
 class ProxyCamera : public odcore::base::module::TimeTriggeredConferenceClientModule {
    private:
@@ -59,8 +66,17 @@ class ProxyCamera : public odcore::base::module::TimeTriggeredConferenceClientMo
     void tearDown();
     odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
 
+    unique_ptr< Camera > createCamera(const string &prefix, const uint32_t &defaultSlots);
+    void publish(const Camera &camera, const odcore::data::image::SharedImage &si, const vector< odcore::data::image::SharedImage > &derivedImages, const string &compressedFrame, const odcore::data::TimeStamp &sampleTimeStamp);
+    void publishTelemetry();
+    void publishLatencies(Camera &camera);
+
    private:
-    unique_ptr< Camera > m_camera;
+    vector< unique_ptr< Camera > > m_cameras;
+    unique_ptr< CaptureThread > m_captureThread; // Stopped before m_cameras are destroyed.
+    unique_ptr< SynchronizedCaptureThread > m_synchronizedCaptureThread;
+    uint32_t m_telemetryPeriod; // Period of the synchronization HealthStatus in ms.
+    uint32_t m_latencyPeriod; // Period of the latency HealthStatus in ms.
 };
 }
 }
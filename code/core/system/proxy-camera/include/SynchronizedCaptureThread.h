@@ -0,0 +1,115 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef SYNCHRONIZEDCAPTURETHREAD_H_
+#define SYNCHRONIZEDCAPTURETHREAD_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Camera.h"
+#include "FrameSynchronizer.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class captures frames from several cameras and groups them into
+ * synchronized sets by their capture time stamps.
+ *
+ * Cameras with a file descriptor (V4L2) are waited for together with poll
+ * on one thread, so that a frame is captured as soon as it arrives on any of
+ * them; every other camera is captured on a thread of its own. The module
+ * publishes the newest complete set; a set that is replaced before it is
+ * published counts as dropped.
+ *
+ * A frame waits in its slot until the frames of the other cameras arrive
+ * and the set is published; a set is dropped if a camera reused the slot of
+ * its frame meanwhile, so the cameras should have at least three slots.
+ */
+class SynchronizedCaptureThread {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param cameras Cameras to capture from; must outlive this object.
+     * @param tolerance Largest difference of capture times in a set in microseconds.
+     */
+    SynchronizedCaptureThread(const std::vector< Camera * > &cameras, const int64_t &tolerance);
+    SynchronizedCaptureThread(SynchronizedCaptureThread const &) = delete;
+    SynchronizedCaptureThread &operator=(SynchronizedCaptureThread const &) = delete;
+    virtual ~SynchronizedCaptureThread();
+
+    void start();
+    void stop();
+
+    /**
+     * This method returns the newest set if it was not returned before.
+     *
+     * @param set Frames of the set in the order of the cameras.
+     * @return true if there is a new set.
+     */
+    bool getNewestSet(std::vector< FrameSynchronizer::Frame > &set);
+
+    uint64_t getCapturedFrames() const;
+    uint64_t getDuplicateSets() const;
+
+    /**
+     * This method copies the synchronization statistics.
+     *
+     * @param sets Number of complete sets.
+     * @param droppedFrames Frames that did not become part of a set.
+     * @param droppedSets Sets that were replaced before they were published.
+     * @param overwrittenSets Sets that were dropped as a camera reused the slot of their frame.
+     * @param skew Difference of capture times in the newest set in microseconds.
+     * @param maximumSkew Largest difference so far in microseconds.
+     * @param meanSkew Mean difference in microseconds.
+     */
+    void getStatistics(uint64_t &sets, uint64_t &droppedFrames, uint64_t &droppedSets, uint64_t &overwrittenSets, int64_t &skew, int64_t &maximumSkew, int64_t &meanSkew);
+
+   private:
+    void poll(const std::vector< uint32_t > &cameras);
+    void capture(const uint32_t &camera);
+    void add(const uint32_t &camera, const odcore::data::TimeStamp &sampleTimeStamp);
+
+   private:
+    std::vector< Camera * > m_cameras;
+    std::vector< std::string > m_compressedFrames; // One buffer per camera, used by its capturing thread only.
+    std::vector< std::thread > m_threads;
+    std::atomic< bool > m_running;
+
+    std::mutex m_mutex;
+    FrameSynchronizer m_synchronizer;
+
+    std::atomic< uint64_t > m_captured;
+    std::atomic< uint64_t > m_duplicates;
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*SYNCHRONIZEDCAPTURETHREAD_H_*/
@@ -0,0 +1,138 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef V4L2CAMERA_H_
+#define V4L2CAMERA_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Camera.h"
+#include "FrameConverter.h"
+#include "FrameViewer.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+/**
+ * This class captures from a V4L2 device (/dev/video<id>) using memory
+ * mapped streaming buffers. Frames in the sensor's native format are
+ * converted and flipped while they are copied from the driver buffer into the
+ * shared memory segment, or copied as they are if nothing is to be done.
+ *
+ * Supported pixel formats are YUYV (into 1, 2, or 3 bytes per pixel), GREY
+ * (into 1 or 3 bytes per pixel), and MJPEG. MJPEG frames are not decoded;
+ * they are only passed on as the compressed output without re-encoding, so
+ * ProxyCamera rejects MJPEG with a raw output or derived images. For the
+ * same reason, only frames of 1 or 3 bytes per pixel can be shown while
+ * debugging.
+ */
+class V4L2Camera : public Camera {
+   private:
+    /**
+     * "Forbidden" copy constructor. Goal: The compiler should warn
+     * already at compile time for unwanted bugs caused by any misuse
+     * of the copy constructor.
+     *
+     * @param obj Reference to an object of this class.
+     */
+    V4L2Camera(const V4L2Camera & /*obj*/);
+
+    /**
+     * "Forbidden" assignment operator. Goal: The compiler should warn
+     * already at compile time for unwanted bugs caused by any misuse
+     * of the assignment operator.
+     *
+     * @param obj Reference to an object of this class.
+     * @return Reference to this instance.
+     */
+    V4L2Camera &operator=(const V4L2Camera & /*obj*/);
+
+   public:
+    /**
+     * Constructor.
+     *
+     * @param name Name of the shared memory segment.
+     * @param id Number of the device /dev/video<id>.
+     * @param width Expected image width.
+     * @param height Expected image height.
+     * @param bpp Bytes per pixel: 1 (gray), 2 (YUYV), or 3 (BGR).
+     * @param format Pixel format: YUYV, GREY, or MJPEG.
+     * @param numberOfBuffers Number of streaming buffers to request.
+     * @param debug Show live image feed on a separate thread.
+     * @param flipped Is the camera mounted upside down?
+     */
+    V4L2Camera(const string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp, const string &format, const uint32_t &numberOfBuffers, const bool &debug, const bool &flipped);
+    virtual ~V4L2Camera();
+
+    /**
+     * @param format Pixel format: YUYV, GREY, or MJPEG.
+     * @return V4L2 fourcc code of the pixel format.
+     */
+    static uint32_t toPixelFormat(const string &format);
+
+    /**
+     * @param pixelFormat V4L2 fourcc code.
+     * @return Bytes per pixel of the format, or 0 for compressed formats.
+     */
+    static uint32_t getBytesPerPixel(const uint32_t &pixelFormat);
+
+    virtual bool getFileDescriptor(int32_t &fd) const;
+
+   private:
+    virtual bool copyImageTo(char *dest, const uint32_t &size);
+    virtual bool copyCompressedImageTo(string &jpeg);
+    virtual bool isValid() const;
+    virtual bool captureFrame();
+
+    bool open(const uint32_t &pixelFormat, const uint32_t &numberOfBuffers);
+    void close();
+    bool requeue();
+
+   private:
+    struct Buffer {
+        void *start;
+        size_t length;
+    };
+
+    string m_device;
+    uint32_t m_pixelFormat;
+    unique_ptr< FrameConverter > m_converter; // Not for MJPEG.
+    uint32_t m_stride; // Bytes per line of the driver buffers.
+    int32_t m_fd;
+    vector< Buffer > m_buffers;
+    bool m_streaming;
+    bool m_dequeued; // A buffer is owned by us until it is copied.
+    uint32_t m_index; // Index of the dequeued buffer.
+    uint32_t m_bytesUsed; // Bytes of the frame in the dequeued buffer.
+    unique_ptr< FrameViewer > m_viewer; // Only set when debugging.
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*V4L2CAMERA_H_*/
@@ -0,0 +1,200 @@
+/**
+ * proxy-camera - Interface to OpenCV-based cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+
+#include "FrameConverter.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+namespace {
+// BGR to gray as in OpenCV: Y = 0.114 B + 0.587 G + 0.299 R with 14 bit fixed point.
+const int32_t GRAY_SHIFT = 14;
+const int32_t GRAY_B = 1868;
+const int32_t GRAY_G = 9617;
+const int32_t GRAY_R = 4899;
+
+// YUV (BT.601, limited range) to BGR as in OpenCV with 20 bit fixed point.
+const int32_t YUV_SHIFT = 20;
+const int32_t YUV_CY = 1220542;
+const int32_t YUV_CUB = 2116026;
+const int32_t YUV_CUG = -409993;
+const int32_t YUV_CVG = -852492;
+const int32_t YUV_CVR = 1673527;
+
+inline uint8_t saturate(const int32_t &v) {
+    return static_cast< uint8_t >((v < 0) ? 0 : ((v > 255) ? 255 : v));
+}
+
+inline uint8_t toGray(const uint8_t *bgr) {
+    return static_cast< uint8_t >((bgr[0] * GRAY_B + bgr[1] * GRAY_G + bgr[2] * GRAY_R + (1 << (GRAY_SHIFT - 1))) >> GRAY_SHIFT);
+}
+
+inline void toBGR(const int32_t &y, const int32_t &u, const int32_t &v, uint8_t *bgr) {
+    const int32_t Y = ((y > 16) ? (y - 16) : 0) * YUV_CY;
+    const int32_t ROUND = 1 << (YUV_SHIFT - 1);
+    bgr[0] = saturate((Y + YUV_CUB * u + ROUND) >> YUV_SHIFT);
+    bgr[1] = saturate((Y + YUV_CVG * v + YUV_CUG * u + ROUND) >> YUV_SHIFT);
+    bgr[2] = saturate((Y + YUV_CVR * v + ROUND) >> YUV_SHIFT);
+}
+
+/**
+ * This function copies the luma of a row of YUYV pixels, optionally in
+ * reverse order.
+ */
+void yuyvToGray(const uint8_t *source, uint8_t *destination, const uint32_t &width, const bool &reversed) {
+    uint32_t x = 0;
+#if defined(__SSE2__)
+    const __m128i LOW_BYTES = _mm_set1_epi16(0x00FF);
+    for (; x + 16 <= width; x += 16) {
+        const __m128i first = _mm_loadu_si128(reinterpret_cast< const __m128i * >(source + 2 * x));
+        const __m128i second = _mm_loadu_si128(reinterpret_cast< const __m128i * >(source + 2 * x + 16));
+        __m128i luma = _mm_packus_epi16(_mm_and_si128(first, LOW_BYTES), _mm_and_si128(second, LOW_BYTES));
+        if (reversed) {
+            // Reverse the 16 bytes: within words, then the words.
+            luma = _mm_or_si128(_mm_slli_epi16(luma, 8), _mm_srli_epi16(luma, 8));
+            luma = _mm_shufflelo_epi16(luma, _MM_SHUFFLE(0, 1, 2, 3));
+            luma = _mm_shufflehi_epi16(luma, _MM_SHUFFLE(0, 1, 2, 3));
+            luma = _mm_shuffle_epi32(luma, _MM_SHUFFLE(1, 0, 3, 2));
+            _mm_storeu_si128(reinterpret_cast< __m128i * >(destination + width - x - 16), luma);
+        } else {
+            _mm_storeu_si128(reinterpret_cast< __m128i * >(destination + x), luma);
+        }
+    }
+#endif
+    for (; x < width; x++) {
+        destination[reversed ? (width - 1 - x) : x] = source[2 * x];
+    }
+}
+}
+
+FrameConverter::FrameConverter(const uint32_t &width, const uint32_t &height, const PixelFormat &source, const uint32_t &bpp, const bool &flipped)
+    : m_width(width)
+    , m_height(height)
+    , m_source(source)
+    , m_bpp(bpp)
+    , m_flipped(flipped) {
+    if ((1 != bpp) && (3 != bpp) && !((2 == bpp) && (YUYV == source))) {
+        throw invalid_argument("Unsupported conversion! Use 1 or 3 bytes per pixel, or 2 for YUYV");
+    }
+    if ((YUYV == source) && (0 != (width % 2))) {
+        throw invalid_argument("YUYV frames need an even width");
+    }
+}
+
+FrameConverter::~FrameConverter() {}
+
+uint32_t FrameConverter::getBytesPerPixel(const PixelFormat &format) {
+    uint32_t retVal = 1;
+    if (BGR == format) {
+        retVal = 3;
+    } else if (YUYV == format) {
+        retVal = 2;
+    }
+    return retVal;
+}
+
+void FrameConverter::convert(const char *source, const uint32_t &sourceStride, char *destination) const {
+    const uint32_t destinationStride = m_width * m_bpp;
+    const uint8_t *src = reinterpret_cast< const uint8_t * >(source);
+    uint8_t *dst = reinterpret_cast< uint8_t * >(destination);
+
+    // Same format and orientation: a plain copy.
+    if (!m_flipped && (getBytesPerPixel(m_source) == m_bpp)) {
+        if (sourceStride == destinationStride) {
+            memcpy(dst, src, destinationStride * m_height);
+        } else {
+            for (uint32_t y = 0; y < m_height; y++) {
+                memcpy(dst + y * destinationStride, src + y * sourceStride, destinationStride);
+            }
+        }
+        return;
+    }
+
+    for (uint32_t y = 0; y < m_height; y++) {
+        // Rotating by 180 degrees reverses the order of the rows and of the pixels in a row.
+        const uint32_t row = m_flipped ? (m_height - 1 - y) : y;
+        convertRow(src + y * sourceStride, dst + row * destinationStride);
+    }
+}
+
+void FrameConverter::convertRow(const uint8_t *source, uint8_t *destination) const {
+    const uint32_t w = m_width;
+    const bool reversed = m_flipped;
+    if (BGR == m_source) {
+        if (1 == m_bpp) {
+            for (uint32_t x = 0; x < w; x++) {
+                destination[reversed ? (w - 1 - x) : x] = toGray(source + 3 * x);
+            }
+        } else {
+            for (uint32_t x = 0; x < w; x++) {
+                uint8_t *d = destination + 3 * (reversed ? (w - 1 - x) : x);
+                d[0] = source[3 * x];
+                d[1] = source[3 * x + 1];
+                d[2] = source[3 * x + 2];
+            }
+        }
+    } else if (YUYV == m_source) {
+        if (1 == m_bpp) {
+            yuyvToGray(source, destination, w, reversed);
+        } else {
+            // Two pixels share U and V: Y0 U Y1 V.
+            for (uint32_t x = 0; x < w; x += 2) {
+                const uint8_t *s = source + 2 * x;
+                const uint32_t first = reversed ? (w - 1 - x) : x;
+                const uint32_t second = reversed ? (w - 2 - x) : (x + 1);
+                if (2 == m_bpp) {
+                    uint8_t *d = destination + 2 * (reversed ? second : first);
+                    d[0] = reversed ? s[2] : s[0];
+                    d[1] = s[1];
+                    d[2] = reversed ? s[0] : s[2];
+                    d[3] = s[3];
+                } else {
+                    const int32_t u = static_cast< int32_t >(s[1]) - 128;
+                    const int32_t v = static_cast< int32_t >(s[3]) - 128;
+                    toBGR(s[0], u, v, destination + 3 * first);
+                    toBGR(s[2], u, v, destination + 3 * second);
+                }
+            }
+        }
+    } else {
+        for (uint32_t x = 0; x < w; x++) {
+            uint8_t *d = destination + m_bpp * (reversed ? (w - 1 - x) : x);
+            d[0] = source[x];
+            if (3 == m_bpp) {
+                d[1] = source[x];
+                d[2] = source[x];
+            }
+        }
+    }
+}
+}
+}
+}
+} // opendlv::core::system::proxy
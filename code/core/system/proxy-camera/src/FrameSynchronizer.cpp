@@ -0,0 +1,166 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <stdexcept>
+
+#include "FrameSynchronizer.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+FrameSynchronizer::FrameSynchronizer(const uint32_t &numberOfCameras, const int64_t &tolerance)
+    : m_pending(numberOfCameras)
+    , m_set(numberOfCameras)
+    , m_slots(numberOfCameras, 0)
+    , m_frameNumbers(numberOfCameras, 0)
+    , m_tolerance(tolerance)
+    , m_hasNewSet(false)
+    , m_sets(0)
+    , m_droppedFrames(0)
+    , m_droppedSets(0)
+    , m_overwrittenSets(0)
+    , m_skew(0)
+    , m_maximumSkew(0)
+    , m_skewSum(0) {
+    if (0 == numberOfCameras) {
+        throw invalid_argument("A synchronized set needs at least one camera");
+    }
+    if (tolerance < 0) {
+        throw invalid_argument("The synchronization tolerance must not be negative");
+    }
+}
+
+FrameSynchronizer::~FrameSynchronizer() {}
+
+void FrameSynchronizer::setNumberOfSlots(const uint32_t &camera, const uint32_t &slots) {
+    if (camera < m_slots.size()) {
+        m_slots[camera] = slots;
+    }
+}
+
+bool FrameSynchronizer::add(const uint32_t &camera, const odcore::data::image::SharedImage &sharedImage, const uint64_t &frameNumber, string &compressedFrame, const int64_t &timeStamp) {
+    if (camera >= m_pending.size()) {
+        return false;
+    }
+    m_frameNumbers[camera] = frameNumber;
+    Frame &frame = m_pending[camera];
+    if (frame.valid) {
+        m_droppedFrames++;
+    }
+    frame.sharedImage = sharedImage;
+    frame.compressedFrame.swap(compressedFrame);
+    frame.timeStamp = timeStamp;
+    frame.frameNumber = frameNumber;
+    frame.valid = true;
+
+    int64_t oldest = timeStamp;
+    int64_t newest = timeStamp;
+    bool complete = true;
+    for (uint32_t i = 0; i < m_pending.size(); i++) {
+        if (m_pending[i].valid) {
+            oldest = (m_pending[i].timeStamp < oldest) ? m_pending[i].timeStamp : oldest;
+            newest = (m_pending[i].timeStamp > newest) ? m_pending[i].timeStamp : newest;
+        } else {
+            complete = false;
+        }
+    }
+
+    if (newest - oldest > m_tolerance) {
+        // Later frames of the other cameras are even further away from these.
+        for (uint32_t i = 0; i < m_pending.size(); i++) {
+            if (m_pending[i].valid && (m_pending[i].timeStamp < newest - m_tolerance)) {
+                m_pending[i].valid = false;
+                m_droppedFrames++;
+            }
+        }
+        return false;
+    }
+    if (!complete) {
+        return false;
+    }
+
+    if (m_hasNewSet) {
+        m_droppedSets++;
+    }
+    m_set.swap(m_pending);
+    for (uint32_t i = 0; i < m_pending.size(); i++) {
+        m_pending[i].valid = false;
+    }
+    m_hasNewSet = true;
+    m_sets++;
+    m_skew = newest - oldest;
+    m_maximumSkew = (m_skew > m_maximumSkew) ? m_skew : m_maximumSkew;
+    m_skewSum += m_skew;
+    return true;
+}
+
+bool FrameSynchronizer::getNewestSet(vector< Frame > &set) {
+    if (!m_hasNewSet) {
+        return false;
+    }
+    for (uint32_t i = 0; i < m_set.size(); i++) {
+        // The frame after the newest one may already be written.
+        if ((m_slots[i] > 0) && (m_frameNumbers[i] + 1 >= m_set[i].frameNumber + m_slots[i])) {
+            m_hasNewSet = false;
+            m_overwrittenSets++;
+            return false;
+        }
+    }
+    set.swap(m_set);
+    // The buffers of the returned set are reused for the next one.
+    m_set.resize(m_pending.size());
+    m_hasNewSet = false;
+    return true;
+}
+
+uint64_t FrameSynchronizer::getSets() const {
+    return m_sets;
+}
+
+uint64_t FrameSynchronizer::getDroppedFrames() const {
+    return m_droppedFrames;
+}
+
+uint64_t FrameSynchronizer::getDroppedSets() const {
+    return m_droppedSets;
+}
+
+uint64_t FrameSynchronizer::getOverwrittenSets() const {
+    return m_overwrittenSets;
+}
+
+int64_t FrameSynchronizer::getSkew() const {
+    return m_skew;
+}
+
+int64_t FrameSynchronizer::getMaximumSkew() const {
+    return m_maximumSkew;
+}
+
+int64_t FrameSynchronizer::getMeanSkew() const {
+    return (m_sets > 0) ? m_skewSum / static_cast< int64_t >(m_sets) : 0;
+}
+}
+}
+}
+} // opendlv::core::system::proxy
@@ -19,9 +19,6 @@
 
 #include <iostream>
 
-#include <opencv2/imgproc/imgproc.hpp>
-#include <opencv2/imgproc/imgproc_c.h>
-
 #include "OpenCVCamera.h"
 
 namespace opendlv {
@@ -29,12 +26,20 @@ namespace core {
 namespace system {
 namespace proxy {
 
+namespace {
+// Showing more frames per second adds nothing but copies.
+const uint32_t VIEWER_FREQUENCY = 10;
+}
+
 OpenCVCamera::OpenCVCamera(const string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp, const bool &debug, const bool &flipped)
     : Camera(name, id, width, height, bpp)
     , m_capture(NULL)
     , m_image(NULL)
-    , m_debug(debug)
-    , m_flipped(flipped) {
+    , m_converter(width, height, FrameConverter::BGR, bpp, flipped)
+    , m_viewer() {
+    if (debug) {
+        m_viewer.reset(new FrameViewer("[proxy-camera]", VIEWER_FREQUENCY));
+    }
 
     m_capture = cvCaptureFromCAM(id);
     if (m_capture) {
@@ -60,20 +65,8 @@ bool OpenCVCamera::captureFrame() {
     bool retVal = false;
     if (m_capture != NULL) {
         if (cvGrabFrame(m_capture)) {
-            if (getBPP() == 1) {
-                IplImage *tmpFrame = cvRetrieveFrame(m_capture);
-
-                if (m_image == NULL) {
-                    m_image = cvCreateImage(cvGetSize(tmpFrame), IPL_DEPTH_8U, 1);
-                }
-
-                cvCvtColor(tmpFrame, m_image, CV_BGR2GRAY);
-            }
-            else {
-                m_image = cvRetrieveFrame(m_capture);
-            }
-
-            retVal = true;
+            m_image = cvRetrieveFrame(m_capture);
+            retVal = (m_image != NULL);
         }
     }
     return retVal;
@@ -83,14 +76,16 @@ bool OpenCVCamera::copyImageTo(char *dest, const uint32_t &size) {
     bool retVal = false;
 
     if ((dest != NULL) && (size > 0) && (m_image != NULL)) {
-        if (m_flipped) {
-            cvFlip(m_image, m_image, -1);
+        if ((static_cast< uint32_t >(m_image->width) != getWidth()) || (static_cast< uint32_t >(m_image->height) != getHeight()) || (m_image->nChannels != 3)
+            || (m_image->depth != IPL_DEPTH_8U) || (size < getSize())) {
+            cerr << "[proxy-camera] Camera '" << getName() << "' delivers " << m_image->width << "x" << m_image->height << " with " << m_image->nChannels << " channels instead of " << getWidth() << "x" << getHeight() << endl;
+            return false;
         }
-        ::memcpy(dest, m_image->imageData, size);
+        m_converter.convert(m_image->imageData, static_cast< uint32_t >(m_image->widthStep), dest);
 
-        if (m_debug) {
-            cvShowImage("[proxy-camera]", m_image);
-            cvWaitKey(10);
+        if (m_viewer.get() != NULL) {
+            const cv::Mat image(getHeight(), getWidth(), (getBPP() == 1) ? CV_8UC1 : CV_8UC3, dest);
+            m_viewer->offer(image);
         }
 
         retVal = true;
@@ -19,8 +19,12 @@
 
 #include <stdint.h>
 
+#include <chrono>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include <opencv2/highgui/highgui.hpp>
 
@@ -28,7 +32,11 @@
 #include <opendavinci/odcore/data/TimeStamp.h>
 #include <opendavinci/odcore/strings/StringToolbox.h>
 
+#include "odvdvehicle/generated/opendlv/proxy/ImageReadingCompressed.h"
+#include "odvdvehicle/generated/opendlv/system/HealthStatus.h"
+
 #include "OpenCVCamera.h"
+#include "V4L2Camera.h"
 
 #include "ProxyCamera.h"
 
@@ -43,46 +51,306 @@ using namespace odcore::data;
 
 ProxyCamera::ProxyCamera(const int &argc, char **argv)
     : TimeTriggeredConferenceClientModule(argc, argv, "proxy-camera")
-    , m_camera() {}
+    , m_cameras()
+    , m_captureThread()
+    , m_synchronizedCaptureThread()
+    , m_telemetryPeriod(0)
+    , m_latencyPeriod(0) {}
 
 ProxyCamera::~ProxyCamera() {}
 
 void ProxyCamera::setUp() {
-    const string NAME = getKeyValueConfiguration().getValue< string >("proxy-camera.camera.name");
-    const uint32_t ID = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.camera.id");
-    const uint32_t WIDTH = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.camera.width");
-    const uint32_t HEIGHT = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.camera.height");
-    const uint32_t BPP = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.camera.bpp");
-    const bool DEBUG = getKeyValueConfiguration().getValue< bool >("proxy-camera.camera.debug") == 1;
-    const bool FLIPPED = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.camera.flipped") == 1;
-
-    m_camera = unique_ptr< Camera >(new OpenCVCamera(NAME, ID, WIDTH, HEIGHT, BPP, DEBUG, FLIPPED));
-    if (m_camera.get() == NULL) {
+    // Several cameras in one process are captured in synchronized sets; each is configured as proxy-camera.<camera>.*.
+    string CAMERAS = "camera";
+    try {
+        CAMERAS = getKeyValueConfiguration().getValue< string >("proxy-camera.cameras");
+    } catch (...) {
+    }
+    vector< string > cameraNames = odcore::strings::StringToolbox::split(CAMERAS, ',');
+    for (uint32_t i = 0; i < cameraNames.size(); i++) {
+        string cameraName = cameraNames.at(i);
+        odcore::strings::StringToolbox::trim(cameraName);
+        if (!cameraName.empty()) {
+            // A frame waits in its slot for the frames of the other cameras.
+            m_cameras.push_back(createCamera("proxy-camera." + cameraName + ".", (cameraNames.size() > 1) ? 3 : 1));
+        }
+    }
+    // Ages of the frames at capture, conversion, shared memory, and sending as HealthStatus; 0 disables them.
+    m_latencyPeriod = 1000;
+    try {
+        m_latencyPeriod = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.latency.telemetryPeriod");
+    } catch (...) {
+    }
+
+    if (1 == m_cameras.size()) {
+        m_captureThread = unique_ptr< CaptureThread >(new CaptureThread(*m_cameras.front()));
+    } else if (m_cameras.size() > 1) {
+        uint32_t TOLERANCE = 5000;
+        try {
+            TOLERANCE = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.synchronization.tolerance");
+        } catch (...) {
+        }
+        m_telemetryPeriod = 1000;
+        try {
+            m_telemetryPeriod = getKeyValueConfiguration().getValue< uint32_t >("proxy-camera.synchronization.telemetryPeriod");
+        } catch (...) {
+        }
+        vector< Camera * > cameras;
+        for (uint32_t i = 0; i < m_cameras.size(); i++) {
+            cameras.push_back(m_cameras.at(i).get());
+        }
+        m_synchronizedCaptureThread = unique_ptr< SynchronizedCaptureThread >(new SynchronizedCaptureThread(cameras, TOLERANCE));
+        cout << "[" << getName() << "] Synchronizing " << m_cameras.size() << " cameras within " << TOLERANCE << " us" << endl;
+    } else {
         cerr << "[" << getName() << "] No valid camera type defined." << endl;
     }
 }
 
-void ProxyCamera::tearDown() {}
+unique_ptr< Camera > ProxyCamera::createCamera(const string &prefix, const uint32_t &defaultSlots) {
+    const string NAME = getKeyValueConfiguration().getValue< string >(prefix + "name");
+    const uint32_t ID = getKeyValueConfiguration().getValue< uint32_t >(prefix + "id");
+    const uint32_t WIDTH = getKeyValueConfiguration().getValue< uint32_t >(prefix + "width");
+    const uint32_t HEIGHT = getKeyValueConfiguration().getValue< uint32_t >(prefix + "height");
+    const uint32_t BPP = getKeyValueConfiguration().getValue< uint32_t >(prefix + "bpp");
+    const bool DEBUG = getKeyValueConfiguration().getValue< bool >(prefix + "debug") == 1;
+    const bool FLIPPED = getKeyValueConfiguration().getValue< uint32_t >(prefix + "flipped") == 1;
 
-odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode ProxyCamera::body() {
-    uint32_t captureCounter = 0;
-    while (getModuleStateAndWaitForRemainingTimeInTimeslice() == odcore::data::dmcp::ModuleStateMessage::RUNNING) {
-        if (m_camera.get() != NULL) {
-            // Capture frame.
-            odcore::data::image::SharedImage si = m_camera->capture();
-            TimeStamp now;
+    string TYPE = "OpenCV";
+    try {
+        TYPE = getKeyValueConfiguration().getValue< string >(prefix + "type");
+        odcore::strings::StringToolbox::trim(TYPE);
+    } catch (...) {
+    }
+
+    unique_ptr< Camera > camera;
+    // MJPEG frames are passed on as they are but never decoded into pixels.
+    bool jpegFrames = false;
+    if ("V4L2" == TYPE) {
+        // Native sensor formats, converted while copying: YUYV (bpp = 1, 2, or 3), GREY (bpp = 1 or 3), or MJPEG.
+        const string FORMAT = getKeyValueConfiguration().getValue< string >(prefix + "v4l2.format");
+        jpegFrames = ("MJPEG" == FORMAT);
+        uint32_t BUFFERS = 4;
+        try {
+            BUFFERS = getKeyValueConfiguration().getValue< uint32_t >(prefix + "v4l2.buffers");
+        } catch (...) {
+        }
+        camera = unique_ptr< Camera >(new V4L2Camera(NAME, ID, WIDTH, HEIGHT, BPP, FORMAT, BUFFERS, DEBUG, FLIPPED));
+    } else if ("OpenCV" == TYPE) {
+        camera = unique_ptr< Camera >(new OpenCVCamera(NAME, ID, WIDTH, HEIGHT, BPP, DEBUG, FLIPPED));
+    } else {
+        throw invalid_argument("Unsupported camera type '" + TYPE + "'! Use OpenCV or V4L2");
+    }
+
+    // Ring of shared memory segments so that readers have time to copy a frame.
+    uint32_t SLOTS = defaultSlots;
+    try {
+        SLOTS = getKeyValueConfiguration().getValue< uint32_t >(prefix + "slots");
+    } catch (...) {
+    }
+    camera->setNumberOfSlots(SLOTS);
+
+    // raw publishes SharedImages, compressed publishes JPEG frames, e.g. for recording.
+    string OUTPUT = "raw";
+    try {
+        OUTPUT = getKeyValueConfiguration().getValue< string >(prefix + "output");
+        odcore::strings::StringToolbox::trim(OUTPUT);
+    } catch (...) {
+    }
+    if (("raw" != OUTPUT) && ("compressed" != OUTPUT) && ("both" != OUTPUT)) {
+        throw invalid_argument("Unsupported output '" + OUTPUT + "'! Use raw, compressed, or both");
+    }
+    if (jpegFrames && ("compressed" != OUTPUT)) {
+        throw invalid_argument("MJPEG frames are not decoded! Use " + prefix + "output = compressed");
+    }
+    uint32_t QUALITY = 90;
+    try {
+        QUALITY = getKeyValueConfiguration().getValue< uint32_t >(prefix + "jpeg.quality");
+    } catch (...) {
+    }
+    camera->setOutputs("compressed" != OUTPUT, "raw" != OUTPUT, QUALITY);
+
+    // Derived images, e.g. half resolution or a region of interest, in segments <name>.<derived>.
+    string DERIVED = "";
+    try {
+        DERIVED = getKeyValueConfiguration().getValue< string >(prefix + "derived");
+    } catch (...) {
+    }
+    vector< string > derivedNames = odcore::strings::StringToolbox::split(DERIVED, ',');
+    for (uint32_t i = 0; i < derivedNames.size(); i++) {
+        string derivedName = derivedNames.at(i);
+        odcore::strings::StringToolbox::trim(derivedName);
+        if (derivedName.empty()) {
+            continue;
+        }
+        if (jpegFrames) {
+            throw invalid_argument("MJPEG frames are not decoded! Remove " + prefix + "derived");
+        }
+        // scale,gray or scale,gray,x,y,width,height.
+        const string KEY = prefix + "derived." + derivedName;
+        vector< string > derived = odcore::strings::StringToolbox::split(getKeyValueConfiguration().getValue< string >(KEY), ',');
+        if ((2 != derived.size()) && (6 != derived.size())) {
+            throw invalid_argument("Invalid " + KEY + "! Expected scale,gray or scale,gray,x,y,width,height");
+        }
+        uint32_t roi[4] = {0, 0, WIDTH, HEIGHT};
+        for (uint32_t j = 2; j < derived.size(); j++) {
+            roi[j - 2] = static_cast< uint32_t >(stoul(derived.at(j)));
+        }
+        camera->addDerivedImage(derivedName, roi[0], roi[1], roi[2], roi[3], static_cast< uint32_t >(stoul(derived.at(0))), 1 == stoul(derived.at(1)));
+        cout << "[" << getName() << "] Deriving '" << derivedName << "' from " << roi[2] << "x" << roi[3] << "+" << roi[0] << "+" << roi[1] << endl;
+    }
+    return camera;
+}
 
-            // Create container with meta-information about captured frame.
-            Container c(si);
-            c.setSampleTimeStamp(now);
+void ProxyCamera::tearDown() {
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->stop();
+    }
+    if (m_synchronizedCaptureThread.get() != NULL) {
+        m_synchronizedCaptureThread->stop();
+    }
+}
 
-            // Share container for recording.
-            getConference().send(c);
+void ProxyCamera::publish(const Camera &camera, const odcore::data::image::SharedImage &si, const vector< odcore::data::image::SharedImage > &derivedImages, const string &compressedFrame, const TimeStamp &sampleTimeStamp) {
+    if (camera.hasRawOutput()) {
+        // Create container with meta-information about captured frame.
+        Container c(si);
+        c.setSampleTimeStamp(sampleTimeStamp);
 
+        // Share container for recording.
+        getConference().send(c);
+    }
+    // The derived images of the frame.
+    for (uint32_t i = 0; i < derivedImages.size(); i++) {
+        Container c(derivedImages.at(i));
+        c.setSampleTimeStamp(sampleTimeStamp);
+        getConference().send(c);
+    }
+    if (camera.hasCompressedOutput()) {
+        // The frame itself travels in the container; it is recorded without decoding.
+        opendlv::proxy::ImageReadingCompressed irc;
+        irc.setName(camera.getName());
+        irc.setWidth(si.getWidth());
+        irc.setHeight(si.getHeight());
+        irc.setFormat("jpeg");
+        irc.setData(compressedFrame);
+        Container c(irc);
+        c.setSampleTimeStamp(sampleTimeStamp);
+        getConference().send(c);
+    }
+}
+
+void ProxyCamera::publishTelemetry() {
+    uint64_t sets = 0;
+    uint64_t droppedFrames = 0;
+    uint64_t droppedSets = 0;
+    uint64_t overwrittenSets = 0;
+    int64_t skew = 0;
+    int64_t maximumSkew = 0;
+    int64_t meanSkew = 0;
+    m_synchronizedCaptureThread->getStatistics(sets, droppedFrames, droppedSets, overwrittenSets, skew, maximumSkew, meanSkew);
+
+    opendlv::system::HealthStatus hs;
+    hs.putTo_MapOfStatus("proxy-camera.sets", to_string(sets));
+    hs.putTo_MapOfStatus("proxy-camera.droppedFrames", to_string(droppedFrames));
+    hs.putTo_MapOfStatus("proxy-camera.droppedSets", to_string(droppedSets));
+    hs.putTo_MapOfStatus("proxy-camera.overwrittenSets", to_string(overwrittenSets));
+    hs.putTo_MapOfStatus("proxy-camera.skewMicroseconds", to_string(skew));
+    hs.putTo_MapOfStatus("proxy-camera.maximumSkewMicroseconds", to_string(maximumSkew));
+    hs.putTo_MapOfStatus("proxy-camera.meanSkewMicroseconds", to_string(meanSkew));
+    Container c(hs);
+    getConference().send(c);
+}
+
+void ProxyCamera::publishLatencies(Camera &camera) {
+    const char *STAGES[Camera::NUMBER_OF_LATENCY_STAGES] = {"grabbed", "converted", "copied", "sent"};
+    opendlv::system::HealthStatus hs;
+    for (uint32_t i = 0; i < Camera::NUMBER_OF_LATENCY_STAGES; i++) {
+        const LatencyHistogram::Summary summary = camera.getLatency(static_cast< Camera::LatencyStage >(i));
+        const string KEY = "proxy-camera." + camera.getName() + ".latency." + STAGES[i];
+        hs.putTo_MapOfStatus(KEY + ".count", to_string(summary.count));
+        hs.putTo_MapOfStatus(KEY + ".p50", to_string(summary.p50));
+        hs.putTo_MapOfStatus(KEY + ".p99", to_string(summary.p99));
+        hs.putTo_MapOfStatus(KEY + ".max", to_string(summary.max));
+    }
+    Container c(hs);
+    getConference().send(c);
+}
+
+odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode ProxyCamera::body() {
+    // Frames are captured as they arrive; every cycle publishes the newest one, or the newest set of all cameras.
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->start();
+    }
+    if (m_synchronizedCaptureThread.get() != NULL) {
+        m_synchronizedCaptureThread->start();
+    }
+
+    uint32_t captureCounter = 0;
+    string compressedFrame;
+    vector< FrameSynchronizer::Frame > set;
+    vector< vector< odcore::data::image::SharedImage > > derivedImages;
+    for (uint32_t i = 0; i < m_cameras.size(); i++) {
+        derivedImages.push_back(m_cameras.at(i)->getDerivedImages());
+    }
+    chrono::steady_clock::time_point lastTelemetry = chrono::steady_clock::now();
+    chrono::steady_clock::time_point lastLatencies = lastTelemetry;
+    while (getModuleStateAndWaitForRemainingTimeInTimeslice() == odcore::data::dmcp::ModuleStateMessage::RUNNING) {
+        odcore::data::image::SharedImage si;
+        TimeStamp sampleTimeStamp;
+        if ((m_captureThread.get() != NULL) && m_captureThread->getNewestFrame(si, compressedFrame, sampleTimeStamp)) {
+            publish(*m_cameras.front(), si, derivedImages.front(), compressedFrame, sampleTimeStamp);
+            m_cameras.front()->addLatency(Camera::SENT, TimeStamp().toMicroseconds() - sampleTimeStamp.toMicroseconds());
+            captureCounter++;
+        }
+        if ((m_synchronizedCaptureThread.get() != NULL) && m_synchronizedCaptureThread->getNewestSet(set)) {
+            // All frames of a set are sent together with the capture time of the newest one, so that receivers can group them.
+            int64_t newest = 0;
+            for (uint32_t i = 0; i < set.size(); i++) {
+                newest = (set.at(i).timeStamp > newest) ? set.at(i).timeStamp : newest;
+            }
+            sampleTimeStamp = TimeStamp(static_cast< int32_t >(newest / 1000000L), static_cast< int32_t >(newest % 1000000L));
+            for (uint32_t i = 0; i < set.size(); i++) {
+                publish(*m_cameras.at(i), set.at(i).sharedImage, derivedImages.at(i), set.at(i).compressedFrame, sampleTimeStamp);
+            }
+            const int64_t sent = TimeStamp().toMicroseconds();
+            for (uint32_t i = 0; i < set.size(); i++) {
+                m_cameras.at(i)->addLatency(Camera::SENT, sent - set.at(i).timeStamp);
+            }
             captureCounter++;
         }
+        if ((m_synchronizedCaptureThread.get() != NULL) && (m_telemetryPeriod > 0) && (chrono::steady_clock::now() - lastTelemetry >= chrono::milliseconds(m_telemetryPeriod))) {
+            lastTelemetry = chrono::steady_clock::now();
+            publishTelemetry();
+        }
+        if ((m_latencyPeriod > 0) && (chrono::steady_clock::now() - lastLatencies >= chrono::milliseconds(m_latencyPeriod))) {
+            lastLatencies = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < m_cameras.size(); i++) {
+                publishLatencies(*m_cameras.at(i));
+            }
+        }
+    }
+    if (m_captureThread.get() != NULL) {
+        m_captureThread->stop();
+        cout << "[" << getName() << "] Captured " << m_captureThread->getCapturedFrames() << " frames, dropped "
+             << m_captureThread->getDroppedFrames() << ", " << m_captureThread->getDuplicateFrames() << " duplicate." << endl;
+    }
+    if (m_synchronizedCaptureThread.get() != NULL) {
+        m_synchronizedCaptureThread->stop();
+        uint64_t sets = 0;
+        uint64_t droppedFrames = 0;
+        uint64_t droppedSets = 0;
+        uint64_t overwrittenSets = 0;
+        int64_t skew = 0;
+        int64_t maximumSkew = 0;
+        int64_t meanSkew = 0;
+        m_synchronizedCaptureThread->getStatistics(sets, droppedFrames, droppedSets, overwrittenSets, skew, maximumSkew, meanSkew);
+        cout << "[" << getName() << "] Captured " << m_synchronizedCaptureThread->getCapturedFrames() << " frames in " << sets << " sets, dropped "
+             << droppedFrames << " frames and " << droppedSets << " sets, " << overwrittenSets << " overwritten, " << m_synchronizedCaptureThread->getDuplicateSets() << " duplicate; skew mean "
+             << meanSkew << " us, maximum " << maximumSkew << " us." << endl;
+        cout << "[" << getName() << "] Published " << captureCounter << " sets." << endl;
+    } else {
+        cout << "[" << getName() << "] Published " << captureCounter << " frames." << endl;
     }
-    cout << "[" << getName() << "] Captured " << captureCounter << " frames." << endl;
     return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
 }
 }
@@ -0,0 +1,167 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <poll.h>
+
+#include <chrono>
+
+#include "SynchronizedCaptureThread.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+namespace {
+// Time to wait for the next frame in ms before checking whether to stop.
+const int32_t POLL_TIMEOUT = 100;
+}
+
+SynchronizedCaptureThread::SynchronizedCaptureThread(const vector< Camera * > &cameras, const int64_t &tolerance)
+    : m_cameras(cameras)
+    , m_compressedFrames(cameras.size())
+    , m_threads()
+    , m_running(false)
+    , m_mutex()
+    , m_synchronizer(static_cast< uint32_t >(cameras.size()), tolerance)
+    , m_captured(0)
+    , m_duplicates(0) {
+    for (uint32_t i = 0; i < cameras.size(); i++) {
+        m_synchronizer.setNumberOfSlots(i, cameras[i]->getNumberOfSlots());
+    }
+}
+
+SynchronizedCaptureThread::~SynchronizedCaptureThread() {
+    stop();
+}
+
+void SynchronizedCaptureThread::start() {
+    if (!m_running.exchange(true)) {
+        vector< uint32_t > pollable;
+        for (uint32_t i = 0; i < m_cameras.size(); i++) {
+            int32_t fd = -1;
+            if (m_cameras[i]->getFileDescriptor(fd)) {
+                pollable.push_back(i);
+            } else {
+                m_threads.push_back(thread(&SynchronizedCaptureThread::capture, this, i));
+            }
+        }
+        if (!pollable.empty()) {
+            m_threads.push_back(thread(&SynchronizedCaptureThread::poll, this, pollable));
+        }
+    }
+}
+
+void SynchronizedCaptureThread::stop() {
+    m_running.store(false);
+    for (uint32_t i = 0; i < m_threads.size(); i++) {
+        m_threads[i].join();
+    }
+    m_threads.clear();
+}
+
+void SynchronizedCaptureThread::poll(const vector< uint32_t > &cameras) {
+    vector< struct pollfd > fds(cameras.size());
+    for (uint32_t i = 0; i < cameras.size(); i++) {
+        int32_t fd = -1;
+        m_cameras[cameras[i]]->getFileDescriptor(fd);
+        fds[i].fd = fd;
+        fds[i].events = POLLIN;
+    }
+    while (m_running.load()) {
+        for (uint32_t i = 0; i < fds.size(); i++) {
+            fds[i].revents = 0;
+        }
+        if (::poll(fds.data(), fds.size(), POLL_TIMEOUT) <= 0) {
+            continue;
+        }
+        // Frames that arrived together are captured in one go.
+        for (uint32_t i = 0; i < fds.size(); i++) {
+            if (fds[i].revents & POLLIN) {
+                odcore::data::TimeStamp sampleTimeStamp;
+                if (m_cameras[cameras[i]]->capture(sampleTimeStamp)) {
+                    add(cameras[i], sampleTimeStamp);
+                }
+            } else if (fds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                // Do not spin on a disconnected camera.
+                fds[i].fd = -1;
+            }
+        }
+    }
+}
+
+void SynchronizedCaptureThread::capture(const uint32_t &camera) {
+    while (m_running.load()) {
+        odcore::data::TimeStamp sampleTimeStamp;
+        if (m_cameras[camera]->capture(sampleTimeStamp)) {
+            add(camera, sampleTimeStamp);
+        } else {
+            // Do not spin on a disconnected camera.
+            this_thread::sleep_for(chrono::milliseconds(10));
+        }
+    }
+}
+
+void SynchronizedCaptureThread::add(const uint32_t &camera, const odcore::data::TimeStamp &sampleTimeStamp) {
+    m_captured.fetch_add(1, memory_order_relaxed);
+    string &compressedFrame = m_compressedFrames[camera];
+    compressedFrame.clear();
+    if (m_cameras[camera]->hasCompressedOutput()) {
+        m_cameras[camera]->getCompressedFrame(compressedFrame);
+    }
+    const odcore::data::image::SharedImage si = m_cameras[camera]->getSharedImage();
+    const uint64_t frameNumber = m_cameras[camera]->getFrameNumber();
+    lock_guard< mutex > l(m_mutex);
+    m_synchronizer.add(camera, si, frameNumber, compressedFrame, sampleTimeStamp.toMicroseconds());
+}
+
+bool SynchronizedCaptureThread::getNewestSet(vector< FrameSynchronizer::Frame > &set) {
+    lock_guard< mutex > l(m_mutex);
+    const uint64_t overwrittenSets = m_synchronizer.getOverwrittenSets();
+    const bool retVal = m_synchronizer.getNewestSet(set);
+    if (!retVal && (overwrittenSets == m_synchronizer.getOverwrittenSets())) {
+        m_duplicates.fetch_add(1, memory_order_relaxed);
+    }
+    return retVal;
+}
+
+uint64_t SynchronizedCaptureThread::getCapturedFrames() const {
+    return m_captured.load(memory_order_relaxed);
+}
+
+uint64_t SynchronizedCaptureThread::getDuplicateSets() const {
+    return m_duplicates.load(memory_order_relaxed);
+}
+
+void SynchronizedCaptureThread::getStatistics(uint64_t &sets, uint64_t &droppedFrames, uint64_t &droppedSets, uint64_t &overwrittenSets, int64_t &skew, int64_t &maximumSkew, int64_t &meanSkew) {
+    lock_guard< mutex > l(m_mutex);
+    sets = m_synchronizer.getSets();
+    droppedFrames = m_synchronizer.getDroppedFrames();
+    droppedSets = m_synchronizer.getDroppedSets();
+    overwrittenSets = m_synchronizer.getOverwrittenSets();
+    skew = m_synchronizer.getSkew();
+    maximumSkew = m_synchronizer.getMaximumSkew();
+    meanSkew = m_synchronizer.getMeanSkew();
+}
+}
+}
+}
+} // opendlv::core::system::proxy
@@ -0,0 +1,301 @@
+/**
+ * proxy-camera - Interface to cameras.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "V4L2Camera.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+namespace {
+// Time to wait for the next frame in ms.
+const int32_t POLL_TIMEOUT = 1000;
+// Showing more frames per second adds nothing but copies.
+const uint32_t VIEWER_FREQUENCY = 10;
+
+int32_t xioctl(const int32_t &fd, const unsigned long &request, void *argument) {
+    int32_t retVal = 0;
+    do {
+        retVal = ioctl(fd, request, argument);
+    } while ((retVal == -1) && (errno == EINTR));
+    return retVal;
+}
+}
+
+V4L2Camera::V4L2Camera(const string &name, const uint32_t &id, const uint32_t &width, const uint32_t &height, const uint32_t &bpp, const string &format, const uint32_t &numberOfBuffers, const bool &debug, const bool &flipped)
+    : Camera(name, id, width, height, bpp)
+    , m_device()
+    , m_pixelFormat(0)
+    , m_converter()
+    , m_stride(0)
+    , m_fd(-1)
+    , m_buffers()
+    , m_streaming(false)
+    , m_dequeued(false)
+    , m_index(0)
+    , m_bytesUsed(0)
+    , m_viewer() {
+    stringstream device;
+    device << "/dev/video" << id;
+    m_device = device.str();
+
+    m_pixelFormat = toPixelFormat(format);
+    if (V4L2_PIX_FMT_MJPEG != m_pixelFormat) {
+        if ((V4L2_PIX_FMT_GREY == m_pixelFormat) && (2 == bpp)) {
+            throw invalid_argument("Pixel format " + format + " does not match proxy-camera.camera.bpp");
+        }
+        m_converter = unique_ptr< FrameConverter >(new FrameConverter(width, height, (V4L2_PIX_FMT_YUYV == m_pixelFormat) ? FrameConverter::YUYV : FrameConverter::GREY, bpp, flipped));
+    } else if (flipped) {
+        throw invalid_argument("Flipping is not supported for MJPEG");
+    }
+    if (debug) {
+        if ((V4L2_PIX_FMT_MJPEG == m_pixelFormat) || (2 == bpp)) {
+            throw invalid_argument("Showing frames is only supported for 1 or 3 bytes per pixel");
+        }
+        m_viewer.reset(new FrameViewer("[proxy-camera]", VIEWER_FREQUENCY));
+    }
+
+    if (!open(m_pixelFormat, numberOfBuffers)) {
+        cerr << "[proxy-camera] Could not open camera '" << name << "' at " << m_device << ": " << strerror(errno) << endl;
+        close();
+    }
+}
+
+V4L2Camera::~V4L2Camera() {
+    close();
+}
+
+uint32_t V4L2Camera::toPixelFormat(const string &format) {
+    if ("YUYV" == format) {
+        return V4L2_PIX_FMT_YUYV;
+    }
+    if ("GREY" == format) {
+        return V4L2_PIX_FMT_GREY;
+    }
+    if ("MJPEG" == format) {
+        return V4L2_PIX_FMT_MJPEG;
+    }
+    throw invalid_argument("Unsupported pixel format '" + format + "'! Use YUYV, GREY, or MJPEG");
+}
+
+uint32_t V4L2Camera::getBytesPerPixel(const uint32_t &pixelFormat) {
+    uint32_t retVal = 0;
+    if (V4L2_PIX_FMT_YUYV == pixelFormat) {
+        retVal = 2;
+    } else if (V4L2_PIX_FMT_GREY == pixelFormat) {
+        retVal = 1;
+    }
+    return retVal;
+}
+
+bool V4L2Camera::open(const uint32_t &pixelFormat, const uint32_t &numberOfBuffers) {
+    m_fd = ::open(m_device.c_str(), O_RDWR | O_NONBLOCK);
+    if (m_fd < 0) {
+        return false;
+    }
+
+    struct v4l2_capability capability;
+    memset(&capability, 0, sizeof(capability));
+    if ((xioctl(m_fd, VIDIOC_QUERYCAP, &capability) == -1)
+        || !(capability.capabilities & V4L2_CAP_VIDEO_CAPTURE)
+        || !(capability.capabilities & V4L2_CAP_STREAMING)) {
+        errno = ENODEV;
+        return false;
+    }
+
+    struct v4l2_format fmt;
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    fmt.fmt.pix.width = getWidth();
+    fmt.fmt.pix.height = getHeight();
+    fmt.fmt.pix.pixelformat = pixelFormat;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (xioctl(m_fd, VIDIOC_S_FMT, &fmt) == -1) {
+        return false;
+    }
+    // The driver may adjust the format and pad the lines; the shared memory layout may not change.
+    const uint32_t bpp = getBytesPerPixel(pixelFormat);
+    if ((fmt.fmt.pix.pixelformat != pixelFormat) || (fmt.fmt.pix.width != getWidth()) || (fmt.fmt.pix.height != getHeight())
+        || ((bpp > 0) && (fmt.fmt.pix.bytesperline < getWidth() * bpp))) {
+        cerr << "[proxy-camera] " << m_device << " offers " << fmt.fmt.pix.width << "x" << fmt.fmt.pix.height << " with " << fmt.fmt.pix.bytesperline << " bytes per line only" << endl;
+        errno = EINVAL;
+        return false;
+    }
+    m_stride = fmt.fmt.pix.bytesperline;
+
+    struct v4l2_requestbuffers request;
+    memset(&request, 0, sizeof(request));
+    request.count = numberOfBuffers;
+    request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    request.memory = V4L2_MEMORY_MMAP;
+    if ((xioctl(m_fd, VIDIOC_REQBUFS, &request) == -1) || (request.count < 2)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < request.count; i++) {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i;
+        if (xioctl(m_fd, VIDIOC_QUERYBUF, &buffer) == -1) {
+            return false;
+        }
+        Buffer b;
+        b.length = buffer.length;
+        b.start = mmap(NULL, buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, buffer.m.offset);
+        if (MAP_FAILED == b.start) {
+            return false;
+        }
+        m_buffers.push_back(b);
+        if (xioctl(m_fd, VIDIOC_QBUF, &buffer) == -1) {
+            return false;
+        }
+    }
+
+    enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (xioctl(m_fd, VIDIOC_STREAMON, &type) == -1) {
+        return false;
+    }
+    m_streaming = true;
+    cout << "[proxy-camera] Streaming from " << m_device << " with " << m_buffers.size() << " buffers" << endl;
+    return true;
+}
+
+void V4L2Camera::close() {
+    if (m_streaming) {
+        enum v4l2_buf_type type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        xioctl(m_fd, VIDIOC_STREAMOFF, &type);
+        m_streaming = false;
+    }
+    for (uint32_t i = 0; i < m_buffers.size(); i++) {
+        munmap(m_buffers[i].start, m_buffers[i].length);
+    }
+    m_buffers.clear();
+    m_dequeued = false;
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+bool V4L2Camera::getFileDescriptor(int32_t &fd) const {
+    fd = m_fd;
+    return (m_fd >= 0);
+}
+
+bool V4L2Camera::isValid() const {
+    return m_streaming;
+}
+
+bool V4L2Camera::requeue() {
+    bool retVal = true;
+    if (m_dequeued) {
+        struct v4l2_buffer buffer;
+        memset(&buffer, 0, sizeof(buffer));
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = m_index;
+        retVal = (xioctl(m_fd, VIDIOC_QBUF, &buffer) != -1);
+        m_dequeued = false;
+    }
+    return retVal;
+}
+
+bool V4L2Camera::captureFrame() {
+    // Return a buffer that was not copied, e.g. when the shared memory is invalid.
+    requeue();
+
+    struct pollfd pfd;
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if ((poll(&pfd, 1, POLL_TIMEOUT) <= 0) || !(pfd.revents & POLLIN)) {
+        return false;
+    }
+
+    struct v4l2_buffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    if (xioctl(m_fd, VIDIOC_DQBUF, &buffer) == -1) {
+        return false;
+    }
+    m_dequeued = true;
+    m_index = buffer.index;
+    m_bytesUsed = buffer.bytesused;
+    if (V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC == (buffer.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK)) {
+        // The driver's time of the frame on the clock of steady_clock.
+        setDriverTimeStamp(chrono::steady_clock::time_point(chrono::seconds(buffer.timestamp.tv_sec) + chrono::microseconds(buffer.timestamp.tv_usec)));
+    }
+    if (buffer.flags & V4L2_BUF_FLAG_ERROR) {
+        requeue();
+        return false;
+    }
+    return true;
+}
+
+bool V4L2Camera::copyImageTo(char *dest, const uint32_t &size) {
+    bool retVal = false;
+    if ((dest != NULL) && (size > 0) && m_dequeued) {
+        // The only copy of the frame: driver buffer to shared memory.
+        if (m_converter.get() == NULL) {
+            const uint32_t length = (m_bytesUsed < size) ? m_bytesUsed : size;
+            ::memcpy(dest, m_buffers[m_index].start, length);
+            retVal = true;
+        } else if ((size >= getSize()) && (m_bytesUsed >= m_stride * (getHeight() - 1) + getWidth() * getBytesPerPixel(m_pixelFormat))) {
+            m_converter->convert(static_cast< const char * >(m_buffers[m_index].start), m_stride, dest);
+            if (m_viewer.get() != NULL) {
+                const cv::Mat image(getHeight(), getWidth(), (getBPP() == 1) ? CV_8UC1 : CV_8UC3, dest);
+                m_viewer->offer(image);
+            }
+            retVal = true;
+        }
+    }
+    requeue();
+    return retVal;
+}
+
+bool V4L2Camera::copyCompressedImageTo(string &jpeg) {
+    bool retVal = false;
+    if ((V4L2_PIX_FMT_MJPEG == m_pixelFormat) && m_dequeued) {
+        jpeg.assign(static_cast< const char * >(m_buffers[m_index].start), m_bytesUsed);
+        retVal = true;
+    }
+    return retVal;
+}
+}
+}
+}
+} // opendlv::core::system::proxy
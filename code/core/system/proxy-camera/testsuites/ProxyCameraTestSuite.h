@@ -22,12 +22,37 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <linux/videodev2.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
 // Include local header files.
+#include "../include/FrameConverter.h"
+#include "../include/FrameSynchronizer.h"
 #include "../include/ProxyCamera.h"
+#include "../include/SynchronizedCaptureThread.h"
+#include "../include/V4L2Camera.h"
+#include "CaptureThread.h"
+#include "LatencyHistogram.h"
+#include "SeqLock.h"
 
 using namespace std;
 using namespace odcore::data;
 using namespace opendlv::core::system::proxy;
+using opendlv::core::Camera;
+using opendlv::core::CaptureThread;
+using opendlv::core::LatencyHistogram;
+using opendlv::core::SeqLock;
 
 /**
  * This class derives from SensorBoard to allow access to protected methods.
@@ -43,6 +68,35 @@ class ProxyTestling : public ProxyCamera {
         // Here, you need to add all methods which are protected in ProxyCamera and which are needed for the test cases.
 };
 
+/**
+ * This camera delivers a frame every millisecond.
+ */
+class FakeCamera : public Camera {
+    public:
+        FakeCamera(const string &name = "proxy-camera-test-fake") :
+            Camera(name, 0, 4, 4, 1), copyFails(false) {}
+
+        bool copyFails;
+
+    private:
+        virtual bool copyImageTo(char *dest, const uint32_t &size) {
+            if (copyFails) {
+                return false;
+            }
+            memset(dest, 1, size);
+            return true;
+        }
+
+        virtual bool captureFrame() {
+            this_thread::sleep_for(chrono::milliseconds(1));
+            return true;
+        }
+
+        virtual bool isValid() const {
+            return true;
+        }
+};
+
 /**
  * The actual testsuite starts here.
  */
@@ -74,6 +128,385 @@ class ProxyCameraTest : public CxxTest::TestSuite {
         //TS_ASSERT(true);
         TS_ASSERT(dt != NULL);
     }
+
+    void testSeqLock() {
+        // 100 bytes of payload: the trailer starts at 128.
+        SeqLock writer(100);
+        TS_ASSERT(writer.getSegmentSize() == 192);
+        vector< char > segment(writer.getSegmentSize(), 0);
+        TS_ASSERT(!writer.initialize(segment.data(), 150));
+        TS_ASSERT(!writer.isValid());
+
+        // Legacy segments without a trailer are not attached.
+        SeqLock reader(100);
+        TS_ASSERT(!reader.attach(segment.data(), writer.getSegmentSize()));
+
+        TS_ASSERT(writer.initialize(segment.data(), writer.getSegmentSize()));
+        TS_ASSERT(reader.attach(segment.data(), writer.getSegmentSize()));
+        writer.beginWrite();
+        memset(segment.data(), 42, 100);
+        writer.endWrite();
+
+        vector< char > image(100, 0);
+        TS_ASSERT(reader.read(image.data(), 100));
+        TS_ASSERT(image[0] == 42);
+        TS_ASSERT(image[99] == 42);
+
+        // A reader gives up while the writer is updating the payload.
+        writer.beginWrite();
+        TS_ASSERT(!reader.read(image.data(), 100));
+        writer.endWrite();
+        TS_ASSERT(reader.read(image.data(), 100));
+
+        // An aborted write keeps reads that started before it consistent.
+        uint64_t sequence = 0;
+        TS_ASSERT(reader.beginRead(sequence));
+        writer.beginWrite();
+        writer.abortWrite();
+        TS_ASSERT(reader.endRead(sequence));
+    }
+
+    void testV4L2PixelFormat() {
+        TS_ASSERT(V4L2Camera::toPixelFormat("YUYV") == V4L2_PIX_FMT_YUYV);
+        TS_ASSERT(V4L2Camera::toPixelFormat("GREY") == V4L2_PIX_FMT_GREY);
+        TS_ASSERT(V4L2Camera::toPixelFormat("MJPEG") == V4L2_PIX_FMT_MJPEG);
+        TS_ASSERT_THROWS(V4L2Camera::toPixelFormat("BGR3"), invalid_argument);
+
+        TS_ASSERT(V4L2Camera::getBytesPerPixel(V4L2_PIX_FMT_YUYV) == 2);
+        TS_ASSERT(V4L2Camera::getBytesPerPixel(V4L2_PIX_FMT_GREY) == 1);
+        TS_ASSERT(V4L2Camera::getBytesPerPixel(V4L2_PIX_FMT_MJPEG) == 0);
+
+        // GREY cannot be converted into YUYV.
+        TS_ASSERT_THROWS(V4L2Camera("proxy-camera-test", 99, 640, 480, 2, "GREY", 4, false, false), invalid_argument);
+        // Only frames of 1 or 3 bytes per pixel can be shown.
+        TS_ASSERT_THROWS(V4L2Camera("proxy-camera-test", 99, 640, 480, 2, "YUYV", 4, true, false), invalid_argument);
+        TS_ASSERT_THROWS(V4L2Camera("proxy-camera-test", 99, 640, 480, 3, "MJPEG", 4, true, false), invalid_argument);
+    }
+
+    void testCaptureThread() {
+        FakeCamera camera;
+        CaptureThread captureThread(camera);
+        odcore::data::image::SharedImage si;
+        odcore::data::TimeStamp sampleTimeStamp;
+        TS_ASSERT(!captureThread.getNewestFrame(si, sampleTimeStamp));
+        TS_ASSERT(captureThread.getDuplicateFrames() == 1);
+
+        captureThread.start();
+        this_thread::sleep_for(chrono::milliseconds(50));
+        TS_ASSERT(captureThread.getNewestFrame(si, sampleTimeStamp));
+        TS_ASSERT(si.getName() == "proxy-camera-test-fake");
+        captureThread.stop();
+
+        // All frames but the published one were overwritten.
+        TS_ASSERT(captureThread.getCapturedFrames() > 1);
+        uint64_t published = 1;
+        if (captureThread.getNewestFrame(si, sampleTimeStamp)) {
+            published++;
+        }
+        TS_ASSERT(captureThread.getDroppedFrames() + published == captureThread.getCapturedFrames());
+    }
+
+    void testSlots() {
+        FakeCamera camera;
+        TS_ASSERT_THROWS(camera.setNumberOfSlots(0), invalid_argument);
+        camera.setNumberOfSlots(3);
+        odcore::data::TimeStamp sampleTimeStamp;
+        const string names[4] = {"proxy-camera-test-fake.0", "proxy-camera-test-fake.1", "proxy-camera-test-fake.2", "proxy-camera-test-fake.0"};
+        for (uint32_t i = 0; i < 4; i++) {
+            TS_ASSERT(camera.capture(sampleTimeStamp));
+            TS_ASSERT(camera.getSharedImage().getName() == names[i]);
+            TS_ASSERT(camera.getFrameNumber() == i + 1);
+        }
+
+        // Every slot carries the number of the frame it holds.
+        std::shared_ptr< odcore::wrapper::SharedMemory > sharedMemory = odcore::wrapper::SharedMemoryFactory::attachToSharedMemory("proxy-camera-test-fake.1");
+        TS_ASSERT(sharedMemory->isValid());
+        SeqLock seqLock(16);
+        TS_ASSERT(seqLock.attach(static_cast< char * >(sharedMemory->getSharedMemory()), sharedMemory->getSize()));
+        char image[16];
+        uint64_t frameNumber = 0;
+        TS_ASSERT(seqLock.read(image, 16, frameNumber));
+        TS_ASSERT(frameNumber == 2);
+        TS_ASSERT(image[15] == 1);
+    }
+
+    void testFailedCopy() {
+        FakeCamera camera;
+        camera.setNumberOfSlots(2);
+        odcore::data::TimeStamp sampleTimeStamp;
+        TS_ASSERT(camera.capture(sampleTimeStamp));
+
+        std::shared_ptr< odcore::wrapper::SharedMemory > sharedMemory = odcore::wrapper::SharedMemoryFactory::attachToSharedMemory("proxy-camera-test-fake.1");
+        TS_ASSERT(sharedMemory->isValid());
+        SeqLock seqLock(16);
+        TS_ASSERT(seqLock.attach(static_cast< char * >(sharedMemory->getSharedMemory()), sharedMemory->getSize()));
+        uint64_t sequence = 0;
+        TS_ASSERT(seqLock.beginRead(sequence));
+
+        // The failed frame neither counts nor changes the slot it was meant for.
+        camera.copyFails = true;
+        TS_ASSERT(!camera.capture(sampleTimeStamp));
+        TS_ASSERT(camera.getFrameNumber() == 1);
+        TS_ASSERT(camera.getSharedImage().getName() == "proxy-camera-test-fake.0");
+        TS_ASSERT(seqLock.endRead(sequence));
+
+        camera.copyFails = false;
+        TS_ASSERT(camera.capture(sampleTimeStamp));
+        TS_ASSERT(camera.getFrameNumber() == 2);
+        TS_ASSERT(camera.getSharedImage().getName() == "proxy-camera-test-fake.1");
+        TS_ASSERT(!seqLock.endRead(sequence));
+    }
+
+    void testCompressedOutput() {
+        FakeCamera camera;
+        TS_ASSERT_THROWS(camera.setOutputs(false, false, 90), invalid_argument);
+        TS_ASSERT_THROWS(camera.setOutputs(true, true, 0), invalid_argument);
+
+        // Frames without a bitstream of their own are encoded.
+        camera.setOutputs(false, true, 90);
+        TS_ASSERT(!camera.hasRawOutput());
+        TS_ASSERT(camera.hasCompressedOutput());
+        odcore::data::TimeStamp sampleTimeStamp;
+        TS_ASSERT(camera.capture(sampleTimeStamp));
+        string jpeg;
+        camera.getCompressedFrame(jpeg);
+        TS_ASSERT(jpeg.size() > 2);
+        TS_ASSERT(static_cast< uint8_t >(jpeg[0]) == 0xFF);
+        TS_ASSERT(static_cast< uint8_t >(jpeg[1]) == 0xD8);
+
+        // The capture thread hands out the bitstream with the frame.
+        CaptureThread captureThread(camera);
+        captureThread.start();
+        this_thread::sleep_for(chrono::milliseconds(50));
+        captureThread.stop();
+        odcore::data::image::SharedImage si;
+        jpeg.clear();
+        TS_ASSERT(captureThread.getNewestFrame(si, jpeg, sampleTimeStamp));
+        TS_ASSERT(static_cast< uint8_t >(jpeg[1]) == 0xD8);
+    }
+
+    void testDerivedImage() {
+        FakeCamera camera;
+        TS_ASSERT_THROWS(camera.addDerivedImage("outside", 2, 2, 4, 4, 1, false), invalid_argument);
+        TS_ASSERT_THROWS(camera.addDerivedImage("empty", 0, 0, 4, 4, 8, false), invalid_argument);
+        // <name>.1 is the second slot of a ring of segments.
+        TS_ASSERT_THROWS(camera.addDerivedImage("1", 0, 0, 4, 4, 2, false), invalid_argument);
+        camera.addDerivedImage("half", 0, 0, 4, 4, 2, false);
+        // The region is cropped to a multiple of the scale.
+        camera.addDerivedImage("corner", 1, 1, 3, 3, 2, false);
+        vector< odcore::data::image::SharedImage > derivedImages = camera.getDerivedImages();
+        TS_ASSERT(derivedImages.size() == 2);
+        TS_ASSERT(derivedImages[0].getName() == "proxy-camera-test-fake.half");
+        TS_ASSERT(derivedImages[0].getWidth() == 2);
+        TS_ASSERT(derivedImages[0].getSize() == 4);
+        TS_ASSERT(derivedImages[1].getWidth() == 1);
+
+        odcore::data::TimeStamp sampleTimeStamp;
+        TS_ASSERT(camera.capture(sampleTimeStamp));
+        std::shared_ptr< odcore::wrapper::SharedMemory > sharedMemory = odcore::wrapper::SharedMemoryFactory::attachToSharedMemory("proxy-camera-test-fake.half");
+        TS_ASSERT(sharedMemory->isValid());
+        SeqLock seqLock(4);
+        TS_ASSERT(seqLock.attach(static_cast< char * >(sharedMemory->getSharedMemory()), sharedMemory->getSize()));
+        char image[4];
+        uint64_t frameNumber = 0;
+        TS_ASSERT(seqLock.read(image, 4, frameNumber));
+        TS_ASSERT(frameNumber == 1);
+        TS_ASSERT(image[0] == 1);
+        TS_ASSERT(image[3] == 1);
+    }
+
+    void testLatencyHistogram() {
+        for (uint64_t v = 0; v < 100000000; v = v * 3 / 2 + 1) {
+            const uint32_t bucket = LatencyHistogram::toBucket(v);
+            TS_ASSERT(static_cast< int64_t >(v) <= LatencyHistogram::toUpperBound(bucket));
+            TS_ASSERT((0 == bucket) || (static_cast< int64_t >(v) > LatencyHistogram::toUpperBound(bucket - 1)));
+        }
+
+        LatencyHistogram histogram;
+        for (int64_t i = 1; i <= 100; i++) {
+            histogram.add(i * 1000);
+        }
+        histogram.add(-5);
+        LatencyHistogram::Summary summary = histogram.getSummaryAndReset();
+        TS_ASSERT(summary.count == 101);
+        TS_ASSERT(summary.max == 100000);
+        TS_ASSERT((summary.p50 >= 50000) && (summary.p50 < 50000 * 1.125));
+        TS_ASSERT((summary.p99 >= 99000) && (summary.p99 <= 100000));
+        TS_ASSERT(histogram.getSummaryAndReset().count == 0);
+
+        // A median of 0 us is a valid result.
+        for (uint32_t i = 0; i < 100; i++) {
+            histogram.add((i < 60) ? 0 : 1000);
+        }
+        const LatencyHistogram::Summary zeroMedian = histogram.getSummaryAndReset();
+        TS_ASSERT(zeroMedian.p50 == 0);
+        TS_ASSERT(zeroMedian.p99 == 1000);
+
+        // Every captured frame is measured at all points but sending.
+        FakeCamera camera;
+        odcore::data::TimeStamp sampleTimeStamp;
+        TS_ASSERT(camera.capture(sampleTimeStamp));
+        TS_ASSERT(camera.getLatency(Camera::GRABBED).count == 1);
+        TS_ASSERT(camera.getLatency(Camera::CONVERTED).count == 1);
+        TS_ASSERT(camera.getLatency(Camera::COPIED).count == 1);
+        TS_ASSERT(camera.getLatency(Camera::SENT).count == 0);
+        camera.addLatency(Camera::SENT, 2000);
+        summary = camera.getLatency(Camera::SENT);
+        TS_ASSERT(summary.max == 2000);
+    }
+
+    void testFrameSynchronizer() {
+        FrameSynchronizer synchronizer(3, 1000);
+        odcore::data::image::SharedImage si;
+        string jpeg;
+        vector< FrameSynchronizer::Frame > set;
+        TS_ASSERT(!synchronizer.add(0, si, 1, jpeg, 10000));
+        TS_ASSERT(!synchronizer.add(1, si, 1, jpeg, 10500));
+        TS_ASSERT(!synchronizer.getNewestSet(set));
+
+        // Too late for the pending frames: they are dropped.
+        TS_ASSERT(!synchronizer.add(2, si, 1, jpeg, 12000));
+        TS_ASSERT(synchronizer.getDroppedFrames() == 2);
+
+        TS_ASSERT(!synchronizer.add(0, si, 2, jpeg, 12300));
+        jpeg = "frame";
+        TS_ASSERT(synchronizer.add(1, si, 2, jpeg, 11900));
+        TS_ASSERT(synchronizer.getSets() == 1);
+        TS_ASSERT(synchronizer.getSkew() == 400);
+        TS_ASSERT(synchronizer.getNewestSet(set));
+        TS_ASSERT(set.size() == 3);
+        TS_ASSERT(set[0].timeStamp == 12300);
+        TS_ASSERT(set[1].compressedFrame == "frame");
+        TS_ASSERT(set[2].timeStamp == 12000);
+        TS_ASSERT(!synchronizer.getNewestSet(set));
+
+        // A set that is not taken is replaced by the next one.
+        for (uint32_t i = 0; i < 2; i++) {
+            TS_ASSERT(!synchronizer.add(0, si, 3 + i, jpeg, 20000 + i * 10000));
+            TS_ASSERT(!synchronizer.add(1, si, 3 + i, jpeg, 20100 + i * 10000));
+            TS_ASSERT(synchronizer.add(2, si, 2 + i, jpeg, 20200 + i * 10000));
+        }
+        TS_ASSERT(synchronizer.getDroppedSets() == 1);
+        TS_ASSERT(synchronizer.getMaximumSkew() == 400);
+        TS_ASSERT(synchronizer.getMeanSkew() == 266);
+        TS_ASSERT(synchronizer.getNewestSet(set));
+        TS_ASSERT(set[0].timeStamp == 30000);
+        TS_ASSERT(set[0].frameNumber == 4);
+    }
+
+    void testOverwrittenSet() {
+        FrameSynchronizer synchronizer(2, 1000);
+        synchronizer.setNumberOfSlots(0, 3);
+        synchronizer.setNumberOfSlots(1, 3);
+        odcore::data::image::SharedImage si;
+        string jpeg;
+        vector< FrameSynchronizer::Frame > set;
+        TS_ASSERT(!synchronizer.add(0, si, 1, jpeg, 10000));
+        TS_ASSERT(synchronizer.add(1, si, 1, jpeg, 10100));
+
+        // Frame 3 may be written while the set is taken, but not into the slot of frame 1.
+        TS_ASSERT(!synchronizer.add(0, si, 2, jpeg, 20000));
+        TS_ASSERT(synchronizer.getNewestSet(set));
+        TS_ASSERT(set[0].frameNumber == 1);
+
+        TS_ASSERT(synchronizer.add(1, si, 2, jpeg, 20100));
+        TS_ASSERT(!synchronizer.add(0, si, 3, jpeg, 30000));
+        // Frame 5 may be written into the slot of frame 2.
+        TS_ASSERT(!synchronizer.add(0, si, 4, jpeg, 40000));
+        TS_ASSERT(!synchronizer.getNewestSet(set));
+        TS_ASSERT(synchronizer.getOverwrittenSets() == 1);
+        TS_ASSERT(synchronizer.getDroppedSets() == 0);
+    }
+
+    void testSynchronizedCaptureThread() {
+        FakeCamera left("proxy-camera-test-left");
+        FakeCamera right("proxy-camera-test-right");
+        vector< Camera * > cameras;
+        cameras.push_back(&left);
+        cameras.push_back(&right);
+        // Enough slots that a camera does not reuse the slot of the newest set.
+        left.setNumberOfSlots(16);
+        right.setNumberOfSlots(16);
+        // Without file descriptors, every fake camera is captured on its own thread.
+        SynchronizedCaptureThread captureThread(cameras, 100000);
+        vector< FrameSynchronizer::Frame > set;
+        TS_ASSERT(!captureThread.getNewestSet(set));
+        TS_ASSERT(captureThread.getDuplicateSets() == 1);
+
+        captureThread.start();
+        this_thread::sleep_for(chrono::milliseconds(50));
+        captureThread.stop();
+        TS_ASSERT(captureThread.getNewestSet(set));
+        TS_ASSERT(set.size() == 2);
+        TS_ASSERT(set[0].sharedImage.getName().find("proxy-camera-test-left.") == 0);
+        TS_ASSERT(set[1].sharedImage.getName().find("proxy-camera-test-right.") == 0);
+        TS_ASSERT(set[0].frameNumber + 16 > left.getFrameNumber() + 1);
+        TS_ASSERT(captureThread.getCapturedFrames() > 2);
+    }
+
+    void testFrameConverter() {
+        TS_ASSERT_THROWS(FrameConverter(4, 2, FrameConverter::BGR, 2, false), invalid_argument);
+        TS_ASSERT_THROWS(FrameConverter(3, 2, FrameConverter::YUYV, 2, false), invalid_argument);
+
+        // Rotating a 4x2 YUYV frame swaps the rows and the luma within the pairs.
+        const char yuyv[16] = {1, 10, 2, 20, 3, 30, 4, 40, 5, 50, 6, 60, 7, 70, 8, 80};
+        char rotated[16];
+        FrameConverter(4, 2, FrameConverter::YUYV, 2, true).convert(yuyv, 8, rotated);
+        const char expected[16] = {8, 70, 7, 80, 6, 50, 5, 60, 4, 30, 3, 40, 2, 10, 1, 20};
+        TS_ASSERT(0 == memcmp(rotated, expected, 16));
+
+        // Fused conversion vs. the former path: cvtColor, flip, and memcpy.
+        const uint32_t WIDTH = 1280;
+        const uint32_t HEIGHT = 720;
+        cv::Mat bgr(HEIGHT, WIDTH, CV_8UC3);
+        cv::Mat yuv(HEIGHT, WIDTH, CV_8UC2);
+        srand(0);
+        for (uint32_t i = 0; i < WIDTH * HEIGHT * 3; i++) {
+            bgr.data[i] = static_cast< uint8_t >(rand());
+        }
+        for (uint32_t i = 0; i < WIDTH * HEIGHT * 2; i++) {
+            yuv.data[i] = static_cast< uint8_t >(rand());
+        }
+        struct Case {
+            const char *name;
+            cv::Mat source;
+            FrameConverter::PixelFormat format;
+            uint32_t bpp;
+            int32_t code;
+        };
+        const Case CASES[] = {{"BGR to gray", bgr, FrameConverter::BGR, 1, CV_BGR2GRAY},
+                              {"YUYV to gray", yuv, FrameConverter::YUYV, 1, CV_YUV2GRAY_YUYV},
+                              {"YUYV to BGR", yuv, FrameConverter::YUYV, 3, CV_YUV2BGR_YUYV}};
+        const uint32_t RUNS = 20;
+        for (uint32_t c = 0; c < 3; c++) {
+            const Case &test = CASES[c];
+            vector< char > fused(WIDTH * HEIGHT * test.bpp);
+            vector< char > reference(WIDTH * HEIGHT * test.bpp);
+            FrameConverter converter(WIDTH, HEIGHT, test.format, test.bpp, true);
+            cv::Mat converted;
+
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < RUNS; i++) {
+                converter.convert(reinterpret_cast< const char * >(test.source.data), static_cast< uint32_t >(test.source.step), fused.data());
+            }
+            const double fusedTime = chrono::duration< double, milli >(chrono::steady_clock::now() - start).count() / RUNS;
+
+            start = chrono::steady_clock::now();
+            for (uint32_t i = 0; i < RUNS; i++) {
+                cv::cvtColor(test.source, converted, test.code);
+                cv::flip(converted, converted, -1);
+                memcpy(reference.data(), converted.data, reference.size());
+            }
+            const double threePassTime = chrono::duration< double, milli >(chrono::steady_clock::now() - start).count() / RUNS;
+
+            int32_t maxDifference = 0;
+            for (uint32_t i = 0; i < reference.size(); i++) {
+                maxDifference = max(maxDifference, abs(static_cast< uint8_t >(fused[i]) - static_cast< uint8_t >(reference[i])));
+            }
+            TS_ASSERT(maxDifference <= 1);
+            cout << endl << "[proxy-camera] " << test.name << ", flipped, " << WIDTH << "x" << HEIGHT << ": fused " << fusedTime << " ms, three passes " << threePassTime << " ms" << endl;
+        }
+    }
    
    ////////////////////////////////////////////////////////////////////////////////////
         // Below this line the necessary constructor for initializing the pointer variables,
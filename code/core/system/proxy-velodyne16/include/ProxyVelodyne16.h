@@ -20,7 +20,10 @@
 #ifndef PROXY_PROXYVELODYNE16_H
 #define PROXY_PROXYVELODYNE16_H
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "opendavinci/odcore/base/module/DataTriggeredConferenceClientModule.h"
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
@@ -74,6 +77,7 @@ class ProxyVelodyne16 : public odcore::base::module::DataTriggeredConferenceClie
    private:
     virtual void setUp();
     virtual void tearDown();
+    void publishTelemetry();
     
    private:
     uint8_t m_pointCloudOption;  //0: shared point cloud (SPC) only; 1: compact point cloud (CPC) only; 2: both SPC and CPC
@@ -92,6 +96,12 @@ class ProxyVelodyne16 : public odcore::base::module::DataTriggeredConferenceClie
     std::shared_ptr< SharedMemory > m_velodyneSharedMemory;
     std::shared_ptr< odcore::io::udp::UDPReceiver > m_udpreceiver;
     std::shared_ptr< opendlv::core::system::proxy::Velodyne16Decoder > m_velodyne16decoder;
+
+    uint32_t m_telemetryPeriod; //Period in ms between two HealthStatus messages; 0: disabled
+    std::mutex m_telemetryMutex;
+    std::condition_variable m_telemetryCondition;
+    bool m_telemetryRunning;
+    std::thread m_telemetryThread;
 };
 }
 }
@@ -30,6 +30,10 @@
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
 #include <opendavinci/odcore/io/StringListener.h>
 #include "automotivedata/generated/cartesian/Constants.h"
+#include "odvdvehicle/generated/opendlv/system/HealthStatus.h"
+
+#include "SeqLock.h"
+#include "VelodyneTelemetry.h"
 
 namespace opendlv {
 namespace core {
@@ -85,6 +89,11 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
 
     virtual void nextString(const std::string &s);
 
+    /**
+     * @return Packet-loss and health counters; can be called from any thread.
+     */
+    opendlv::system::HealthStatus getTelemetry() const;
+
    private:
     void readCalibrationFile();
     void index16sensorIDs();
@@ -111,6 +120,7 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
     float m_deltaAzimuth;
     float m_distance;
     std::shared_ptr< SharedMemory > m_velodyneSharedMemory; //shared memory for shared point cloud
+    SeqLock m_seqLock; //sequence lock in the trailer of the shared memory
     float *m_segment;  //temporary memory for transferring data of each frame to the shared memory
     odcore::io::conference::ContainerConference &m_conference;
     odcore::data::SharedPointCloud m_spc; //shared point cloud
@@ -129,6 +139,7 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
     std::array<uint8_t, 16> m_sensorOrderIndex;//Specify the sensor ID order for each 16 points with increasing vertical angle for CPC and SPC
     std::array<uint16_t, 16> m_16SensorsNoIntensity;//Store the distance values of the current 16 sensors for CPC without intensity
     std::array<uint16_t, 16> m_16SensorsWithIntensity;//Store the distance values of the current 16 sensors for CPC with intensity
+    VelodyneTelemetry m_telemetry; //packet-loss and health counters
 };
 }
 }
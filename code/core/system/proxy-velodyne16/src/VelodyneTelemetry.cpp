@@ -0,0 +1,181 @@
+/**
+ * proxy-velodyne16 - Interface to VLP-16.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+#include "VelodyneTelemetry.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+using namespace std;
+
+namespace {
+const uint32_t PACKET_SIZE = 1206;
+const uint32_t BLOCKS_PER_PACKET = 12;
+const uint32_t BLOCK_SIZE = 100;
+const uint32_t TIME_STAMP_POSITION = 1200;
+const uint64_t MICROSECONDS_PER_HOUR = 3600000000ULL;
+// A sensor sends a packet every 1.3ms or less; longer silence is reported.
+const int64_t NO_PACKET_TIMEOUT = 200;
+
+// Azimuth of a block in deg, stored little endian in 1/100 deg after the block flag.
+float blockAzimuth(const string &payload, const uint32_t &block) {
+    const uint32_t position = block * BLOCK_SIZE + 2;
+    const uint32_t value = static_cast< uint8_t >(payload[position]) | (static_cast< uint8_t >(payload[position + 1]) << 8);
+    return static_cast< float >(value) / 100.0f;
+}
+
+float azimuthDifference(const float &from, const float &to) {
+    float difference = to - from;
+    if (difference < 0.0f) {
+        difference += 360.0f;
+    }
+    return difference;
+}
+
+int64_t nanosecondsNow() {
+    return static_cast< int64_t >(chrono::duration_cast< chrono::nanoseconds >(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+string toString(const uint64_t &value) {
+    stringstream s;
+    s << value;
+    return s.str();
+}
+}
+
+VelodyneTelemetry::VelodyneTelemetry(const string &prefix, const bool &hasSensorTimeStamp)
+    : m_prefix(prefix)
+    , m_hasSensorTimeStamp(hasSensorTimeStamp)
+    , m_packets(0)
+    , m_wrongSizePackets(0)
+    , m_azimuthGaps(0)
+    , m_droppedPoints(0)
+    , m_frames(0)
+    , m_decodedPackets(0)
+    , m_decodeNanoseconds(0)
+    , m_rpm(0)
+    , m_lastPacket(nanosecondsNow())
+    , m_lastValidPacket(nanosecondsNow())
+    , m_hasPreviousPacket(false)
+    , m_previousAzimuth(0.0f)
+    , m_previousTimeStamp(0)
+    , m_revolutionAzimuth(0.0f)
+    , m_revolutionTime(0) {}
+
+VelodyneTelemetry::~VelodyneTelemetry() {}
+
+bool VelodyneTelemetry::packetReceived(const string &payload) {
+    const int64_t now = nanosecondsNow();
+    m_packets.fetch_add(1, memory_order_relaxed);
+    m_lastPacket.store(now, memory_order_relaxed);
+    if (payload.length() != PACKET_SIZE) {
+        m_wrongSizePackets.fetch_add(1, memory_order_relaxed);
+        return false;
+    }
+    m_lastValidPacket.store(now, memory_order_relaxed);
+
+    const float firstAzimuth = blockAzimuth(payload, 0);
+    uint64_t timeStamp = 0;
+    if (m_hasSensorTimeStamp) {
+        timeStamp = static_cast< uint8_t >(payload[TIME_STAMP_POSITION])
+            | (static_cast< uint8_t >(payload[TIME_STAMP_POSITION + 1]) << 8)
+            | (static_cast< uint8_t >(payload[TIME_STAMP_POSITION + 2]) << 16)
+            | (static_cast< uint64_t >(static_cast< uint8_t >(payload[TIME_STAMP_POSITION + 3])) << 24);
+    } else {
+        timeStamp = static_cast< uint64_t >(chrono::duration_cast< chrono::microseconds >(chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    if (m_hasPreviousPacket) {
+        // Azimuth span of this packet extrapolated by one more block.
+        const float span = azimuthDifference(firstAzimuth, blockAzimuth(payload, BLOCKS_PER_PACKET - 1));
+        const float packetAdvance = span * static_cast< float >(BLOCKS_PER_PACKET) / static_cast< float >(BLOCKS_PER_PACKET - 1);
+        const float advance = azimuthDifference(m_previousAzimuth, firstAzimuth);
+        if (advance > 1.5f * packetAdvance) {
+            m_azimuthGaps.fetch_add(1, memory_order_relaxed);
+        }
+
+        // The sensor time stamp restarts at the top of every hour.
+        uint64_t elapsed = timeStamp;
+        if (timeStamp < m_previousTimeStamp) {
+            elapsed += MICROSECONDS_PER_HOUR;
+        }
+        elapsed -= m_previousTimeStamp;
+        m_revolutionAzimuth += advance;
+        m_revolutionTime += elapsed;
+        if ((m_revolutionAzimuth >= 360.0f) && (m_revolutionTime > 0)) {
+            const double rpm = static_cast< double >(m_revolutionAzimuth) / 360.0 * 60.0e6 / static_cast< double >(m_revolutionTime);
+            m_rpm.store(static_cast< uint32_t >(lround(rpm)), memory_order_relaxed);
+            m_revolutionAzimuth = 0.0f;
+            m_revolutionTime = 0;
+        }
+    }
+    m_hasPreviousPacket = true;
+    m_previousAzimuth = firstAzimuth;
+    m_previousTimeStamp = timeStamp;
+    return true;
+}
+
+void VelodyneTelemetry::packetDecoded(const chrono::steady_clock::time_point &start, const uint32_t &droppedPoints) {
+    const int64_t nanoseconds = chrono::duration_cast< chrono::nanoseconds >(chrono::steady_clock::now() - start).count();
+    m_decodedPackets.fetch_add(1, memory_order_relaxed);
+    m_decodeNanoseconds.fetch_add(static_cast< uint64_t >(nanoseconds), memory_order_relaxed);
+    if (droppedPoints > 0) {
+        m_droppedPoints.fetch_add(droppedPoints, memory_order_relaxed);
+    }
+}
+
+void VelodyneTelemetry::frameEmitted() {
+    m_frames.fetch_add(1, memory_order_relaxed);
+}
+
+opendlv::system::HealthStatus VelodyneTelemetry::getHealthStatus() const {
+    const uint64_t decodedPackets = m_decodedPackets.load(memory_order_relaxed);
+    const uint64_t decodeNanoseconds = m_decodeNanoseconds.load(memory_order_relaxed);
+    const int64_t now = nanosecondsNow();
+    const int64_t sinceLastPacket = max< int64_t >(0, now - m_lastPacket.load(memory_order_relaxed)) / 1000000;
+    const int64_t sinceLastValidPacket = max< int64_t >(0, now - m_lastValidPacket.load(memory_order_relaxed)) / 1000000;
+    string status = "ok";
+    if (sinceLastPacket >= NO_PACKET_TIMEOUT) {
+        status = "no packets for " + toString(static_cast< uint64_t >(sinceLastPacket)) + " ms";
+    } else if (sinceLastValidPacket >= NO_PACKET_TIMEOUT) {
+        status = "no valid packets for " + toString(static_cast< uint64_t >(sinceLastValidPacket)) + " ms";
+    }
+
+    opendlv::system::HealthStatus hs;
+    hs.putTo_MapOfStatus(m_prefix + ".packets", toString(m_packets.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".wrongSizePackets", toString(m_wrongSizePackets.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".azimuthGaps", toString(m_azimuthGaps.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".droppedPoints", toString(m_droppedPoints.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".frames", toString(m_frames.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".decodeNanosecondsPerPacket", toString((decodedPackets > 0) ? decodeNanoseconds / decodedPackets : 0));
+    hs.putTo_MapOfStatus(m_prefix + ".rpm", toString(m_rpm.load(memory_order_relaxed)));
+    hs.putTo_MapOfStatus(m_prefix + ".millisecondsSinceLastPacket", toString(static_cast< uint64_t >(sinceLastPacket)));
+    hs.putTo_MapOfStatus(m_prefix + ".millisecondsSinceLastValidPacket", toString(static_cast< uint64_t >(sinceLastValidPacket)));
+    hs.putTo_MapOfStatus(m_prefix + ".status", status);
+    return hs;
+}
+}
+}
+}
+} // opendlv::core::system::proxy
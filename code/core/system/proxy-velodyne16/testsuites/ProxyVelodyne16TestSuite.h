@@ -22,9 +22,12 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "opendavinci/generated/odcore/data/SharedPointCloud.h"
@@ -40,6 +43,7 @@
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
 #include "opendavinci/odcore/wrapper/SharedMemoryFactory.h"
 
+#include "../include/VelodyneTelemetry.h"
 #include "../include/velodyne16Decoder.h"
 
 using namespace std;
@@ -103,6 +107,10 @@ class packetToByte : public odcore::io::conference::ContainerListener {
         }
     }
 
+    opendlv::system::HealthStatus getTelemetry() const {
+        return m_velodyne16decoder.getTelemetry();
+    }
+
    private:
     MyContainerConference m_mcc;
     opendlv::core::system::proxy::Velodyne16Decoder m_velodyne16decoder;
@@ -167,6 +175,14 @@ class ProxyVelodyne16Test : public CxxTest::TestSuite {
         cout << "File read complete." << endl;
         delete[] buffer;
 
+        //The sample recording has neither lost packets nor packets of a wrong size, and the sensor spins at 600 RPM
+        opendlv::system::HealthStatus hs = p2b.getTelemetry();
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne16.packets")) > 0);
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne16.wrongSizePackets") == "0");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne16.azimuthGaps") == "0");
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne16.frames")) >= 2);
+        TS_ASSERT_DELTA(stod(hs.getValueForKey_MapOfStatus("proxy-velodyne16.rpm")), 600.0, 5.0);
+
         uint32_t compare = 0; //Number of points matched between VeloView and our Velodyne decoder
 
         if (m_segment->isValid()) {
@@ -188,6 +204,54 @@ class ProxyVelodyne16Test : public CxxTest::TestSuite {
         TS_ASSERT(static_cast<float>(compare)/static_cast<float>(m_xDataV.size())>0.98f);  //At least 98% of all the points of Frame 1 should be matched between Velodyne16Decoder and VeloView for the sample pcap file. 100% is not expected due to azimuth interpolation. Velodyne16Decoder takes the average of two reported azimuth values, while VeloView takes time stamp into account to give more precise but more expensive azimuth interpolation.
     }
 
+    void testTelemetry() {
+        //Synthetic VLP-16 packets at 600 RPM: 12 blocks 0.4 deg apart, one packet every 1333 us
+        opendlv::core::system::proxy::VelodyneTelemetry telemetry("test", true);
+        string payload(1206, 0);
+        uint32_t timeStamp = 0;
+        uint32_t azimuth = 0; //in 1/100 deg
+        for (uint32_t packet = 0; packet < 200; packet++) {
+            for (uint32_t block = 0; block < 12; block++) {
+                const uint32_t blockAzimuth = (azimuth + 40 * block) % 36000;
+                payload[block * 100 + 2] = static_cast< char >(blockAzimuth & 0xFF);
+                payload[block * 100 + 3] = static_cast< char >(blockAzimuth >> 8);
+            }
+            payload[1200] = static_cast< char >(timeStamp & 0xFF);
+            payload[1201] = static_cast< char >((timeStamp >> 8) & 0xFF);
+            payload[1202] = static_cast< char >((timeStamp >> 16) & 0xFF);
+            payload[1203] = static_cast< char >(timeStamp >> 24);
+            if (packet != 100) { //Packet 100 is lost
+                TS_ASSERT(telemetry.packetReceived(payload));
+            }
+            azimuth = (azimuth + 480) % 36000;
+            timeStamp += 1333;
+        }
+        TS_ASSERT(!telemetry.packetReceived(string(100, 0)));
+        telemetry.frameEmitted();
+
+        opendlv::system::HealthStatus hs = telemetry.getHealthStatus();
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.packets") == "200");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.wrongSizePackets") == "1");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.azimuthGaps") == "1");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.frames") == "1");
+        TS_ASSERT_DELTA(stod(hs.getValueForKey_MapOfStatus("test.rpm")), 600.0, 1.0);
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.status") == "ok");
+
+        //Only packets of the wrong size arrive
+        this_thread::sleep_for(chrono::milliseconds(250));
+        telemetry.packetReceived(string(100, 0));
+        hs = telemetry.getHealthStatus();
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.status").find("no valid packets for ") == 0);
+        TS_ASSERT(stoi(hs.getValueForKey_MapOfStatus("test.millisecondsSinceLastValidPacket")) >= 250);
+
+        //The sensor is silent without any frame being emitted
+        opendlv::core::system::proxy::VelodyneTelemetry silent("test", true);
+        this_thread::sleep_for(chrono::milliseconds(250));
+        hs = silent.getHealthStatus();
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.status").find("no packets for ") == 0);
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("test.frames") == "0");
+    }
+
    private:
     const uint32_t m_BUFFER_SIZE = 4000;
     const std::string m_NAME = "testVelodyne16SM"; //The name for the shared memory m_velodyneSharedMemory
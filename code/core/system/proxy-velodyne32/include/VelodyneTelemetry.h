@@ -0,0 +1,110 @@
+/**
+ * proxy-velodyne32 - Interface to HDL-32E.
+ * Copyright (C) 2018 Chalmers REVERE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef VELODYNETELEMETRY_H
+#define VELODYNETELEMETRY_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "odvdvehicle/generated/opendlv/system/HealthStatus.h"
+
+namespace opendlv {
+namespace core {
+namespace system {
+namespace proxy {
+
+/**
+ * This class keeps packet-loss and health counters of a Velodyne decoder.
+ *
+ * The counters are only written by the thread decoding the UDP packets and
+ * are atomic so that they can be read from any other thread. Azimuth gaps
+ * and the RPM are derived from the first block azimuth and the time stamp of
+ * consecutive packets; a gap is counted when a packet advances by more than
+ * 1.5 times the azimuth span of one packet. The time stamp is the one sent by
+ * the sensor (us past the hour) if available, else the time of arrival.
+ *
+ * The health status also reports how long no (valid) packet has arrived,
+ * so that it can be published when no frames are emitted anymore.
+ */
+class VelodyneTelemetry {
+   public:
+    /**
+     * Constructor.
+     *
+     * @param prefix Prefix of the keys in the published health status.
+     * @param hasSensorTimeStamp if the packets carry the sensor time stamp.
+     */
+    VelodyneTelemetry(const std::string &prefix, const bool &hasSensorTimeStamp);
+    VelodyneTelemetry(VelodyneTelemetry const &) = delete;
+    VelodyneTelemetry &operator=(VelodyneTelemetry const &) = delete;
+    virtual ~VelodyneTelemetry();
+
+    /**
+     * This method accounts for a received packet.
+     *
+     * @param payload Packet as received from the sensor.
+     * @return true if the packet has the expected size of 1206 bytes.
+     */
+    bool packetReceived(const std::string &payload);
+
+    /**
+     * This method accounts for a decoded packet.
+     *
+     * @param start Time point when the decoding started.
+     * @param droppedPoints Points discarded because the frame was full.
+     */
+    void packetDecoded(const std::chrono::steady_clock::time_point &start, const uint32_t &droppedPoints);
+
+    void frameEmitted();
+
+    /**
+     * @return Health status; can be called from any thread.
+     */
+    opendlv::system::HealthStatus getHealthStatus() const;
+
+   private:
+    std::string m_prefix;
+    bool m_hasSensorTimeStamp;
+    std::atomic< uint64_t > m_packets;
+    std::atomic< uint64_t > m_wrongSizePackets;
+    std::atomic< uint64_t > m_azimuthGaps;
+    std::atomic< uint64_t > m_droppedPoints;
+    std::atomic< uint64_t > m_frames;
+    std::atomic< uint64_t > m_decodedPackets;
+    std::atomic< uint64_t > m_decodeNanoseconds;
+    std::atomic< uint32_t > m_rpm;
+    std::atomic< int64_t > m_lastPacket; // Time of arrival in ns of the steady clock.
+    std::atomic< int64_t > m_lastValidPacket;
+
+    bool m_hasPreviousPacket;
+    float m_previousAzimuth; // First block azimuth of the previous packet in deg.
+    uint64_t m_previousTimeStamp; // Time stamp of the previous packet in us.
+    float m_revolutionAzimuth; // Azimuth progression since the last RPM estimate in deg.
+    uint64_t m_revolutionTime; // Time since the last RPM estimate in us.
+};
+}
+}
+}
+} // opendlv::core::system::proxy
+
+#endif /*VELODYNETELEMETRY_H*/
@@ -17,6 +17,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -25,6 +26,7 @@
 #include "ProxyVelodyne32.h"
 #include "opendavinci/odcore/base/KeyValueConfiguration.h"
 #include "opendavinci/odcore/data/Container.h"
+#include "opendavinci/odcore/data/TimeStamp.h"
 #include "opendavinci/odcore/io/conference/ContainerConference.h"
 #include "opendavinci/odcore/wrapper/SharedMemoryFactory.h"
 
@@ -52,7 +54,12 @@ ProxyVelodyne32::ProxyVelodyne32(const int32_t &argc, char **argv)
     , m_udpPort(0)
     , m_velodyneSharedMemory(NULL)
     , m_udpreceiver(NULL)
-    , m_velodyne32decoder(NULL) {}
+    , m_velodyne32decoder(NULL)
+    , m_telemetryPeriod(0)
+    , m_telemetryMutex()
+    , m_telemetryCondition()
+    , m_telemetryRunning(false)
+    , m_telemetryThread() {}
 
 ProxyVelodyne32::~ProxyVelodyne32() {}
 
@@ -101,7 +108,8 @@ void ProxyVelodyne32::setUp() {
     if (m_pointCloudOption == 0 || m_pointCloudOption == 2) {
         m_memoryName = getKeyValueConfiguration().getValue< string >("proxy-velodyne32.sharedMemory.name");
         m_memorySize = getKeyValueConfiguration().getValue< uint32_t >("proxy-velodyne32.sharedMemory.size");
-        m_velodyneSharedMemory = SharedMemoryFactory::createSharedMemory(m_memoryName, m_memorySize);
+        // The segment is extended by the trailer of the sequence lock.
+        m_velodyneSharedMemory = SharedMemoryFactory::createSharedMemory(m_memoryName, SeqLock(m_memorySize).getSegmentSize());
         if (m_pointCloudOption == 0) {
             m_velodyne32decoder = shared_ptr< Velodyne32Decoder >(new Velodyne32Decoder(m_velodyneSharedMemory, getConference(), getKeyValueConfiguration().getValue< string >("proxy-velodyne32.calibration"), false, m_SPCOption, m_CPCIntensityOption, m_numberOfBitsForIntensity, m_intensityPlacement, m_distanceEncoding));
         }
@@ -113,16 +121,55 @@ void ProxyVelodyne32::setUp() {
         m_velodyne32decoder = shared_ptr< Velodyne32Decoder >(new Velodyne32Decoder(getConference(), getKeyValueConfiguration().getValue< string >("proxy-velodyne32.calibration"), m_CPCIntensityOption, m_numberOfBitsForIntensity, m_intensityPlacement, m_distanceEncoding));
     }
     
+    // Packet-loss and health counters are published as HealthStatus; 0 disables them.
+    m_telemetryPeriod = 1000;
+    try {
+        m_telemetryPeriod = getKeyValueConfiguration().getValue< uint32_t >("proxy-velodyne32.telemetryPeriod");
+    }
+    catch(...) {
+        m_telemetryPeriod = 1000;
+    }
+
     m_udpreceiver->setStringListener(m_velodyne32decoder.get());
     // Start receiving bytes.
     m_udpreceiver->start();
+
+    // The health status is published independently of emitted frames so
+    // that a silent sensor is reported as well.
+    if (m_telemetryPeriod > 0) {
+        m_telemetryRunning = true;
+        m_telemetryThread = thread(&ProxyVelodyne32::publishTelemetry, this);
+    }
 }
 
 void ProxyVelodyne32::tearDown() {
+    {
+        lock_guard< mutex > l(m_telemetryMutex);
+        m_telemetryRunning = false;
+    }
+    m_telemetryCondition.notify_all();
+    if (m_telemetryThread.joinable()) {
+        m_telemetryThread.join();
+    }
+
     m_udpreceiver->stop();
     m_udpreceiver->setStringListener(NULL);
 }
 
+void ProxyVelodyne32::publishTelemetry() {
+    unique_lock< mutex > l(m_telemetryMutex);
+    chrono::steady_clock::time_point next = chrono::steady_clock::now();
+    while (true) {
+        next += chrono::milliseconds(m_telemetryPeriod);
+        if (m_telemetryCondition.wait_until(l, next, [this]() { return !m_telemetryRunning; })) {
+            return;
+        }
+        odcore::data::Container c(m_velodyne32decoder->getTelemetry());
+        c.setSampleTimeStamp(odcore::data::TimeStamp());
+        getConference().send(c);
+    }
+}
+
 void ProxyVelodyne32::nextContainer(odcore::data::Container &){}
 
 }
@@ -17,6 +17,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <fstream>
@@ -143,6 +144,7 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
     , m_currentAzimuth(0.0)
     , m_distance(0.0)
     , m_velodyneSharedMemory(m)
+    , m_seqLock(m_SIZE)
     , m_segment(NULL)
     , m_conference(c)
     , m_spc()
@@ -160,7 +162,8 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
     , m_isStartAzimuth(true)
     , m_sensorOrderIndex()
     , m_32SensorsNoIntensity()
-    , m_32SensorsWithIntensity() {
+    , m_32SensorsWithIntensity()
+    , m_telemetry("proxy-velodyne32", true) {
     //Initial setup of the shared point cloud (N.B. The size and width of the shared point cloud depends on the number of points of a frame, hence they are not set up in the constructor)
     m_spc.setName(m_velodyneSharedMemory->getName()); // Name of the shared memory segment with the data.
     m_spc.setHeight(1); // We have just a sequence of vectors.
@@ -172,6 +175,11 @@ odcore::io::conference::ContainerConference &c, const string &s, const bool &wit
         m_spc.setUserInfo(SharedPointCloud::POLAR_INTENSITY);
     }
 
+    //Readers synchronize with the sequence lock behind the payload if the shared memory has room for it
+    if (m_velodyneSharedMemory->isValid()) {
+        m_seqLock.initialize(static_cast< char * >(m_velodyneSharedMemory->getSharedMemory()), m_velodyneSharedMemory->getSize());
+    }
+
     //Create memory for temporary storage of point cloud data for each frame
     m_segment = (float *)malloc(m_SIZE);
     if (m_segment == NULL) {
@@ -197,6 +205,7 @@ Velodyne32Decoder::Velodyne32Decoder(odcore::io::conference::ContainerConference
     , m_currentAzimuth(0.0)
     , m_distance(0.0)
     , m_velodyneSharedMemory()
+    , m_seqLock(m_SIZE)
     , m_segment(NULL)
     , m_conference(c)
     , m_spc()
@@ -214,7 +223,8 @@ Velodyne32Decoder::Velodyne32Decoder(odcore::io::conference::ContainerConference
     , m_isStartAzimuth(true)
     , m_sensorOrderIndex()
     , m_32SensorsNoIntensity()
-    , m_32SensorsWithIntensity() {
+    , m_32SensorsWithIntensity()
+    , m_telemetry("proxy-velodyne32", true) {
     index32sensorIDs();
     setupIntensityMaskCPC(m_numberOfBitsForIntensity, m_intensityPlacement);
 }
@@ -263,7 +273,9 @@ void Velodyne32Decoder::sendPointCloud() {
     if (m_withSPC) {
         if (m_velodyneSharedMemory->isValid()) {
             Lock l(m_velodyneSharedMemory);
+            m_seqLock.beginWrite();
             memcpy(m_velodyneSharedMemory->getSharedMemory(), m_segment, m_SIZE);
+            m_seqLock.endWrite();
             //Set the size and width of the shared point cloud of the current frame
             m_spc.setSize(m_SIZE); // Size in raw bytes.
             m_spc.setWidth(m_pointIndexSPC); // Number of points.
@@ -295,11 +307,18 @@ void Velodyne32Decoder::sendPointCloud() {
         m_distanceStringStreamWithIntensityPart2.str("");
         m_distanceStringStreamWithIntensityPart3.str("");
     }
+    m_telemetry.frameEmitted();
+}
+
+opendlv::system::HealthStatus Velodyne32Decoder::getTelemetry() const {
+    return m_telemetry.getHealthStatus();
 }
 
 void Velodyne32Decoder::nextString(const string &payload) {
-    if (payload.length() == 1206) {
+    if (m_telemetry.packetReceived(payload)) {
         //Decode VLP-32 data
+        const chrono::steady_clock::time_point decodingStart = chrono::steady_clock::now();
+        uint32_t droppedPoints = 0; //points discarded as the current frame is full
         uint32_t position = 0; //position specifies the starting position to read from the 1206 bytes
 
         //The payload of a VLP-32 packet consists of 12 blocks with 100 bytes each. Decode each block separately.
@@ -360,6 +379,8 @@ void Velodyne32Decoder::nextString(const string &payload) {
                             m_pointIndexSPC++;
                             m_startID += m_NUMBER_OF_COMPONENTS_PER_POINT;
                         }   
+                    } else if (m_withSPC) {
+                        droppedPoints++;
                     }
                     
                     if (m_withCPC && m_pointIndexCPC < m_MAX_POINT_SIZE) {
@@ -431,15 +452,18 @@ void Velodyne32Decoder::nextString(const string &payload) {
 
                     if ((m_withCPC && m_pointIndexCPC >= m_MAX_POINT_SIZE) || (!m_withCPC && m_pointIndexSPC >= m_MAX_POINT_SIZE)) {
                         position += 3 * (31 - counter); //Discard the points of the current frame when the preallocated shared memory is full; move the position to be read in the 1206 bytes
+                        droppedPoints += 31 - counter;
                         cout << "More than 70000 points." << endl; 
                         break;
                     }
                 }
             } else {
                 position += 96; //32*3(bytes), skip one block
+                droppedPoints += 32;
             }
         }
         //Ignore the last 6 bytes: 4 bytes GPS time stamp, 2 blank bytes
+        m_telemetry.packetDecoded(decodingStart, droppedPoints);
     }
 }
 }
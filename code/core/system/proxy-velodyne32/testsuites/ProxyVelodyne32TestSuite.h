@@ -103,6 +103,10 @@ class packetToByte : public odcore::io::conference::ContainerListener {
         }
     }
 
+    opendlv::system::HealthStatus getTelemetry() const {
+        return m_velodyne32decoder.getTelemetry();
+    }
+
    private:
     MyContainerConference m_mcc;
     opendlv::core::system::proxy::Velodyne32Decoder m_velodyne32decoder;
@@ -165,6 +169,14 @@ class ProxyVelodyne32Test : public CxxTest::TestSuite {
         pcap.setContainerListener(NULL);
 
         cout << "File read complete." << endl;
+
+        //The sample recording has neither lost packets nor packets of a wrong size, and the sensor spins at 656 RPM
+        opendlv::system::HealthStatus hs = p2b.getTelemetry();
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne32.packets")) > 0);
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne32.wrongSizePackets") == "0");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne32.azimuthGaps") == "0");
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne32.frames")) >= 1);
+        TS_ASSERT_DELTA(stod(hs.getValueForKey_MapOfStatus("proxy-velodyne32.rpm")), 656.0, 5.0);
         delete[] buffer;
 
         uint32_t compare = 0; //Number of points matched between VeloView and our Velodyne decoder
@@ -20,7 +20,10 @@
 #ifndef PROXY_PROXYVELODYNE64_H
 #define PROXY_PROXYVELODYNE64_H
 
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
 #include "velodyne64Decoder.h"
@@ -58,6 +61,7 @@ class ProxyVelodyne64 : public odcore::base::module::DataTriggeredConferenceClie
    private:
     void setUp();
     void tearDown();
+    void publishTelemetry();
     
    private:
     string m_memoryName;    //Name of the shared memory
@@ -68,6 +72,12 @@ class ProxyVelodyne64 : public odcore::base::module::DataTriggeredConferenceClie
     std::shared_ptr< SharedMemory > m_velodyneSharedMemory;
     std::shared_ptr< odcore::io::udp::UDPReceiver > m_udpreceiver;
     std::shared_ptr< opendlv::core::system::proxy::Velodyne64Decoder > m_velodyne64decoder;
+
+    uint32_t m_telemetryPeriod; //Period in ms between two HealthStatus messages; 0: disabled
+    std::mutex m_telemetryMutex;
+    std::condition_variable m_telemetryCondition;
+    bool m_telemetryRunning;
+    std::thread m_telemetryThread;
 };
 }
 }
@@ -28,6 +28,10 @@
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
 #include <opendavinci/odcore/io/StringListener.h>
 #include "opendavinci/odcore/io/conference/ContainerConference.h"
+#include "odvdvehicle/generated/opendlv/system/HealthStatus.h"
+
+#include "SeqLock.h"
+#include "VelodyneTelemetry.h"
 
 namespace opendlv {
 namespace core {
@@ -62,6 +66,11 @@ class Velodyne64Decoder : public odcore::io::StringListener {
 
     virtual void nextString(const std::string &s);
 
+    /**
+     * @return Packet-loss and health counters; can be called from any thread.
+     */
+    opendlv::system::HealthStatus getTelemetry() const;
+
    private:
     float toRadian(float);
     void sendSharedPointCloud(const float &oldAzimuth, const float &newAzimuth);
@@ -77,6 +86,7 @@ class Velodyne64Decoder : public odcore::io::StringListener {
     bool m_upperBlock;
     float m_distance;
     std::shared_ptr< SharedMemory > m_velodyneSharedMemory; //shared memory for the shared point cloud
+    SeqLock m_seqLock; //sequence lock in the trailer of the shared memory
     float *m_segment;                                       //temporary memory for transferring data of each frame to the shared memory
     odcore::io::conference::ContainerConference &m_conference;
     odcore::data::SharedPointCloud m_spc;
@@ -86,6 +96,7 @@ class Velodyne64Decoder : public odcore::io::StringListener {
     std::array<float, 64> m_vertOffsetCorrection;
     std::array<float, 64> m_horizOffsetCorrection;
     string m_calibration;
+    VelodyneTelemetry m_telemetry; //packet-loss and health counters
 };
 }
 }
@@ -17,12 +17,14 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
 #include <memory>
 
 #include "opendavinci/odcore/base/KeyValueConfiguration.h"
 #include "opendavinci/odcore/data/Container.h"
+#include "opendavinci/odcore/data/TimeStamp.h"
 #include "opendavinci/odcore/io/conference/ContainerConference.h"
 #include "opendavinci/odcore/wrapper/SharedMemoryFactory.h"
 
@@ -43,14 +45,20 @@ ProxyVelodyne64::ProxyVelodyne64(const int &argc, char **argv)
     , m_udpPort(0)
     , m_velodyneSharedMemory(NULL)
     , m_udpreceiver(NULL)
-    , m_velodyne64decoder(NULL) {}
+    , m_velodyne64decoder(NULL)
+    , m_telemetryPeriod(0)
+    , m_telemetryMutex()
+    , m_telemetryCondition()
+    , m_telemetryRunning(false)
+    , m_telemetryThread() {}
 
 ProxyVelodyne64::~ProxyVelodyne64() {}
 
 void ProxyVelodyne64::setUp() {
     m_memoryName = getKeyValueConfiguration().getValue< string >("proxy-velodyne64.sharedMemory.name");
     m_memorySize = getKeyValueConfiguration().getValue< uint32_t >("proxy-velodyne64.sharedMemory.size");
-    m_velodyneSharedMemory = SharedMemoryFactory::createSharedMemory(m_memoryName, m_memorySize);
+    // The segment is extended by the trailer of the sequence lock.
+    m_velodyneSharedMemory = SharedMemoryFactory::createSharedMemory(m_memoryName, SeqLock(m_memorySize).getSegmentSize());
 
     m_udpReceiverIP = getKeyValueConfiguration().getValue< string >("proxy-velodyne64.udpReceiverIP");
     m_udpPort = getKeyValueConfiguration().getValue< uint32_t >("proxy-velodyne64.udpPort");
@@ -58,16 +66,55 @@ void ProxyVelodyne64::setUp() {
 
     m_velodyne64decoder = shared_ptr< Velodyne64Decoder >(new Velodyne64Decoder(m_velodyneSharedMemory, getConference(), getKeyValueConfiguration().getValue< string >("proxy-velodyne64.calibration")));
 
+    // Packet-loss and health counters are published as HealthStatus; 0 disables them.
+    m_telemetryPeriod = 1000;
+    try {
+        m_telemetryPeriod = getKeyValueConfiguration().getValue< uint32_t >("proxy-velodyne64.telemetryPeriod");
+    }
+    catch(...) {
+        m_telemetryPeriod = 1000;
+    }
+
     m_udpreceiver->setStringListener(m_velodyne64decoder.get());
     // Start receiving bytes.
     m_udpreceiver->start();
+
+    // The health status is published independently of emitted frames so
+    // that a silent sensor is reported as well.
+    if (m_telemetryPeriod > 0) {
+        m_telemetryRunning = true;
+        m_telemetryThread = thread(&ProxyVelodyne64::publishTelemetry, this);
+    }
 }
 
 void ProxyVelodyne64::tearDown() {
+    {
+        lock_guard< mutex > l(m_telemetryMutex);
+        m_telemetryRunning = false;
+    }
+    m_telemetryCondition.notify_all();
+    if (m_telemetryThread.joinable()) {
+        m_telemetryThread.join();
+    }
+
     m_udpreceiver->stop();
     m_udpreceiver->setStringListener(NULL);
 }
 
+void ProxyVelodyne64::publishTelemetry() {
+    unique_lock< mutex > l(m_telemetryMutex);
+    chrono::steady_clock::time_point next = chrono::steady_clock::now();
+    while (true) {
+        next += chrono::milliseconds(m_telemetryPeriod);
+        if (m_telemetryCondition.wait_until(l, next, [this]() { return !m_telemetryRunning; })) {
+            return;
+        }
+        odcore::data::Container c(m_velodyne64decoder->getTelemetry());
+        c.setSampleTimeStamp(odcore::data::TimeStamp());
+        getConference().send(c);
+    }
+}
+
 void ProxyVelodyne64::nextContainer(odcore::data::Container &){}
 
 }
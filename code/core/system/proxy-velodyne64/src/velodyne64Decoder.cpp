@@ -17,6 +17,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <chrono>
 #include <cmath>
 #include <iomanip>
 #include <cstring>
@@ -54,6 +55,7 @@ odcore::io::conference::ContainerConference &c, const string &s)
     , m_upperBlock(true)
     , m_distance(0.0)
     , m_velodyneSharedMemory(m)
+    , m_seqLock(m_SIZE)
     , m_segment(NULL)
     , m_conference(c)
     , m_spc()
@@ -62,7 +64,8 @@ odcore::io::conference::ContainerConference &c, const string &s)
     , m_distCorrection()
     , m_vertOffsetCorrection()
     , m_horizOffsetCorrection()
-    , m_calibration(s) {
+    , m_calibration(s)
+    , m_telemetry("proxy-velodyne64", false) {
     //Initial setup of the shared point cloud (N.B. The size and width of the shared point cloud depends on the number of points of a frame, hence they are not set up in the constructor)
     m_spc.setName(m_velodyneSharedMemory->getName()); // Name of the shared memory segment with the data.
     m_spc.setHeight(1); // We have just a sequence of vectors.
@@ -70,6 +73,11 @@ odcore::io::conference::ContainerConference &c, const string &s)
     m_spc.setComponentDataType(SharedPointCloud::FLOAT_T); // Data type per component.
     m_spc.setUserInfo(SharedPointCloud::XYZ_INTENSITY);
 
+    //Readers synchronize with the sequence lock behind the payload if the shared memory has room for it
+    if (m_velodyneSharedMemory->isValid()) {
+        m_seqLock.initialize(static_cast< char * >(m_velodyneSharedMemory->getSharedMemory()), m_velodyneSharedMemory->getSize());
+    }
+
     //Create memory for temporary storage of point cloud data for each frame
     m_segment = (float *)malloc(m_SIZE);
 
@@ -163,7 +171,9 @@ void Velodyne64Decoder::sendSharedPointCloud(const float &oldAzimuth, const floa
     if (newAzimuth < oldAzimuth) {
         if (m_velodyneSharedMemory->isValid()) {
             Lock l(m_velodyneSharedMemory);
+            m_seqLock.beginWrite();
             memcpy(m_velodyneSharedMemory->getSharedMemory(), m_segment, m_SIZE);
+            m_seqLock.endWrite();
             //Set the size and width of the shared point cloud of the current frame
             m_spc.setSize(m_SIZE); // Size in raw bytes.
             m_spc.setWidth(m_pointIndex);                                                      // Number of points.
@@ -172,12 +182,20 @@ void Velodyne64Decoder::sendSharedPointCloud(const float &oldAzimuth, const floa
         }
         m_pointIndex = 0;
         m_startID = 0;
+
+        m_telemetry.frameEmitted();
     }
 }
 
+opendlv::system::HealthStatus Velodyne64Decoder::getTelemetry() const {
+    return m_telemetry.getHealthStatus();
+}
+
 void Velodyne64Decoder::nextString(const string &payload) {
-    if (payload.length() == 1206) {
+    if (m_telemetry.packetReceived(payload)) {
         //Decode HDL-64E data
+        const chrono::steady_clock::time_point decodingStart = chrono::steady_clock::now();
+        uint32_t droppedPoints = 0; //points discarded as the current frame is full
         uint32_t position = 0; //position specifies the starting position to read from the 1206 bytes
 
         //The payload of a HDL-64E packet consists of 12 blocks with 100 bytes each. Decode each block separately.
@@ -241,13 +259,16 @@ void Velodyne64Decoder::nextString(const string &payload) {
 
                     if (m_pointIndex >= m_MAX_POINT_SIZE) {
                         position += 3 * (31 - counter); //Discard the points of the current frame when the preallocated shared memory is full; move the position to be read in the 1206 bytes
+                        droppedPoints += 31 - counter;
                         break;
                     }
                 }
             } else {
                 position += 96; //32*3
+                droppedPoints += 32;
             }
         }
+        m_telemetry.packetDecoded(decodingStart, droppedPoints);
     }
 }
 }
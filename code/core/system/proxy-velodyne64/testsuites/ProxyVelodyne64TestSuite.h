@@ -103,6 +103,10 @@ class packetToByte : public odcore::io::conference::ContainerListener {
         }
     }
 
+    opendlv::system::HealthStatus getTelemetry() const {
+        return m_velodyne64decoder.getTelemetry();
+    }
+
    private:
     MyContainerConference m_mcc;
     opendlv::core::system::proxy::Velodyne64Decoder m_velodyne64decoder;
@@ -165,6 +169,13 @@ class ProxyVelodyne64Test : public CxxTest::TestSuite {
         pcap.setContainerListener(NULL);
 
         cout << "File read complete." << endl;
+
+        //The sample recording has neither lost packets nor packets of a wrong size, and at least one frame is complete
+        opendlv::system::HealthStatus hs = p2b.getTelemetry();
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne64.packets")) > 0);
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne64.wrongSizePackets") == "0");
+        TS_ASSERT(hs.getValueForKey_MapOfStatus("proxy-velodyne64.azimuthGaps") == "0");
+        TS_ASSERT(stoul(hs.getValueForKey_MapOfStatus("proxy-velodyne64.frames")) >= 1);
         delete[] buffer;
 
         uint32_t compare = 0; //Number of points matched between VeloView and our Velodyne decoder
@@ -0,0 +1,89 @@
+/**
+ * camera-calibration - Tool to find the intrinsic calibration of a camera.
+ * Copyright (C) 2018 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_CAMERACALIBRATION_HPP_
+#define CORE_TOOL_CAMERACALIBRATION_HPP_
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
+#include <opendavinci/odcore/data/Container.h>
+
+#include "opencv2/core/core.hpp"
+
+#include "intrinsiccalibrator.hpp"
+#include "SharedImageReader.h"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This module finds the intrinsic calibration of a camera from a live or
+ * replayed SharedImage stream showing a chessboard in various poses.
+ *
+ * Once enough views are collected, the calibration runs on a worker thread
+ * so that the module keeps serving its conference. The camera matrix and
+ * distortion coefficients are saved in the cv::FileStorage format read by
+ * proxy-camera-axis, next to the undistortion maps in binary form.
+ */
+class CameraCalibration
+: public odcore::base::module::TimeTriggeredConferenceClientModule{
+ public:
+  CameraCalibration(int32_t const &, char **);
+  CameraCalibration(CameraCalibration const &) = delete;
+  CameraCalibration &operator=(CameraCalibration const &) = delete;
+  virtual ~CameraCalibration();
+
+  virtual void nextContainer(odcore::data::Container &);
+
+ private:
+  void setUp();
+  void tearDown();
+
+  odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
+  void Calibrate();
+  bool Save();
+
+  cv::Mat m_image;
+  SharedImageReader m_sharedImageReader;
+  std::unique_ptr<IntrinsicCalibrator> m_calibrator;
+  std::thread m_worker;
+  std::atomic<bool> m_calibrated;
+  bool m_failed;
+  cv::Mat m_cameraMatrix;
+  cv::Mat m_distortionCoefficients;
+  double m_error;
+
+  std::string m_cameraName;
+  std::string m_calibrationFileName;
+  std::string m_mapsFileName;
+
+  bool m_initialized;
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
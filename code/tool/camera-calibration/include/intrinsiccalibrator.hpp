@@ -0,0 +1,119 @@
+/**
+ * camera-calibration - Tool to find the intrinsic calibration of a camera.
+ * Copyright (C) 2018 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_INTRINSICCALIBRATOR_HPP_
+#define CORE_TOOL_INTRINSICCALIBRATOR_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "opencv2/core/core.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class finds the camera matrix and distortion coefficients of a
+ * camera from views of a chessboard.
+ *
+ * The inner corners of the chessboard are detected in each frame and
+ * refined to subpixel accuracy. A view is only kept if its corners moved by
+ * a minimum distance from the last kept view, so that a stream of frames of
+ * a still chessboard does not fill the calibration with the same pose.
+ */
+class IntrinsicCalibrator
+{
+ public:
+  /**
+   * Constructor.
+   *
+   * @param columns Inner corners per row of the chessboard.
+   * @param rows Inner corners per column of the chessboard.
+   * @param squareSize Size of a square in meters.
+   * @param views Number of views to collect.
+   * @param minimumMotion Mean distance in pixels that the corners need to move between kept views.
+   */
+  IntrinsicCalibrator(const uint32_t &columns, const uint32_t &rows, const double &squareSize, const uint32_t &views, const double &minimumMotion);
+  IntrinsicCalibrator(IntrinsicCalibrator const &) = delete;
+  IntrinsicCalibrator &operator=(IntrinsicCalibrator const &) = delete;
+  virtual ~IntrinsicCalibrator();
+
+  /**
+   * This method looks for the chessboard in a frame.
+   *
+   * @param image BGR or gray frame.
+   * @return true if the view was kept.
+   */
+  bool addView(const cv::Mat &image);
+
+  /**
+   * This method keeps the corners of a view detected elsewhere.
+   *
+   * @param corners Inner corners of the chessboard in row-major order.
+   * @param imageSize Size of the frame.
+   * @return true if the view was kept.
+   */
+  bool addCorners(const std::vector<cv::Point2f> &corners, const cv::Size &imageSize);
+
+  uint32_t getNumberOfViews() const;
+  bool isComplete() const;
+
+  /**
+   * This method runs the calibration over the kept views; it takes seconds
+   * for tens of views.
+   *
+   * @param cameraMatrix Camera matrix.
+   * @param distortionCoefficients Distortion coefficients (k1, k2, p1, p2, k3).
+   * @return Root mean square reprojection error in pixels.
+   */
+  double calibrate(cv::Mat &cameraMatrix, cv::Mat &distortionCoefficients) const;
+
+  cv::Size getImageSize() const;
+
+  /**
+   * This method saves a calibration in the format read by proxy-camera-axis.
+   *
+   * @param filename File such as <camera>-calibration.yml.
+   * @param cameraMatrix Camera matrix.
+   * @param distortionCoefficients Distortion coefficients.
+   * @param imageSize Size of the calibrated frames.
+   * @param error Root mean square reprojection error in pixels.
+   */
+  static void writeCalibration(const std::string &filename, const cv::Mat &cameraMatrix, const cv::Mat &distortionCoefficients, const cv::Size &imageSize, const double &error);
+
+ private:
+  cv::Size m_patternSize;
+  uint32_t m_views;
+  double m_minimumMotion;
+  std::vector<cv::Point3f> m_target; // Corners on the chessboard.
+  std::vector< std::vector<cv::Point2f> > m_corners; // Corners of the kept views.
+  std::vector<cv::Point2f> m_detected;
+  cv::Mat m_gray;
+  cv::Size m_imageSize;
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
@@ -0,0 +1,199 @@
+/**
+ * camera-calibration - Tool to find the intrinsic calibration of a camera.
+ * Copyright (C) 2018 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <iostream>
+#include <stdexcept>
+
+#include "opendavinci/GeneratedHeaders_OpenDaVINCI.h"
+#include "opendavinci/odcore/data/Container.h"
+#include "opendavinci/odcore/base/KeyValueConfiguration.h"
+
+#include "cameracalibration.hpp"
+#include "UndistortionMaps.h"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+CameraCalibration::CameraCalibration(int32_t const &a_argc, char **a_argv)
+    : odcore::base::module::TimeTriggeredConferenceClientModule(
+        a_argc, a_argv, "core-tool-camera-calibration")
+    , m_image()
+    , m_sharedImageReader()
+    , m_calibrator()
+    , m_worker()
+    , m_calibrated(false)
+    , m_failed(false)
+    , m_cameraMatrix()
+    , m_distortionCoefficients()
+    , m_error(0)
+    , m_cameraName()
+    , m_calibrationFileName()
+    , m_mapsFileName()
+    , m_initialized(false)
+{
+}
+
+CameraCalibration::~CameraCalibration()
+{
+}
+
+void CameraCalibration::setUp()
+{
+  odcore::base::KeyValueConfiguration kv = getKeyValueConfiguration();
+
+  m_cameraName = 
+      kv.getValue<std::string>("core-tool-camera-calibration.cameraname");
+  m_calibrationFileName = "./" + m_cameraName + "-calibration.yml";
+  try {
+    m_calibrationFileName = 
+        kv.getValue<std::string>("core-tool-camera-calibration.calibrationfile");
+  } catch (...) {
+  }
+  m_mapsFileName = "./" + m_cameraName + "-undistortion.maps";
+  try {
+    m_mapsFileName = 
+        kv.getValue<std::string>("core-tool-camera-calibration.mapsfile");
+  } catch (...) {
+  }
+
+  uint32_t views = 20;
+  double minimumMotion = 20;
+  try {
+    views = kv.getValue<uint32_t>("core-tool-camera-calibration.views");
+  } catch (...) {
+  }
+  try {
+    minimumMotion = 
+        kv.getValue<double>("core-tool-camera-calibration.minimummotion");
+  } catch (...) {
+  }
+  m_calibrator.reset(new IntrinsicCalibrator(
+      kv.getValue<uint32_t>("core-tool-camera-calibration.target.columns"),
+      kv.getValue<uint32_t>("core-tool-camera-calibration.target.rows"),
+      kv.getValue<double>("core-tool-camera-calibration.target.squaresize"),
+      views, minimumMotion));
+  m_initialized = true;
+}
+
+void CameraCalibration::tearDown()
+{
+  // The calibration cannot be interrupted.
+  if (m_worker.joinable()) {
+    m_worker.join();
+  }
+}
+
+void CameraCalibration::nextContainer(odcore::data::Container &a_c)
+{
+  if (!m_initialized || m_calibrator->isComplete()) {
+    return;
+  }
+  if (a_c.getDataType() == odcore::data::image::SharedImage::ID()) {
+    odcore::data::image::SharedImage mySharedImg =
+        a_c.getData<odcore::data::image::SharedImage>();
+    // Cameras with a ring of segments name them <name>.<slot>; derived
+    // images in <name>.<derived> are not slots.
+    const std::string name = mySharedImg.getName();
+    const bool isSlot = (name.size() > m_cameraName.size() + 1)
+        && (name.compare(0, m_cameraName.size() + 1, m_cameraName + ".") == 0)
+        && (name.find_first_not_of("0123456789", m_cameraName.size() + 1)
+        == std::string::npos);
+    if ((name.compare(m_cameraName) != 0) && !isSlot) {
+      return;
+    }
+    if (!m_sharedImageReader.attach(mySharedImg)) {
+      std::cout 
+          << "[" << getName() << "] Shared memory is not valid." 
+          << std::endl;
+      return;
+    }
+    if (!m_sharedImageReader.copyTo(m_image)) {
+      return;
+    }
+
+    if (m_calibrator->addView(m_image)) {
+      std::cout << "[" << getName() << "] Collected " 
+          << m_calibrator->getNumberOfViews() << " views of the chessboard." 
+          << std::endl;
+      if (m_calibrator->isComplete()) {
+        std::cout << "[" << getName() << "] Calibrating." << std::endl;
+        m_worker = std::thread(&CameraCalibration::Calibrate, this);
+      }
+    }
+  }
+}
+
+odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode 
+    CameraCalibration::body()
+{
+  while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
+      odcore::data::dmcp::ModuleStateMessage::RUNNING && !m_calibrated) {
+  }
+  if (!m_calibrated) {
+    return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
+  }
+  m_worker.join();
+  if (m_failed || !Save()) {
+    return odcore::data::dmcp::ModuleExitCodeMessage::SERIOUS_ERROR;
+  }
+  return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
+}
+
+void CameraCalibration::Calibrate()
+{
+  try {
+    m_error = m_calibrator->calibrate(m_cameraMatrix, m_distortionCoefficients);
+  } catch (cv::Exception &e) {
+    std::cerr << "[" << getName() << "] Calibration failed: " << e.what() 
+        << std::endl;
+    m_failed = true;
+  }
+  m_calibrated = true;
+}
+
+bool CameraCalibration::Save()
+{
+  std::cout << "[" << getName() << "] Calibration done with a reprojection error of " 
+      << m_error << " pixels." << std::endl 
+      << m_cameraMatrix << std::endl << m_distortionCoefficients << std::endl;
+  try {
+    IntrinsicCalibrator::writeCalibration(m_calibrationFileName, m_cameraMatrix,
+        m_distortionCoefficients, m_calibrator->getImageSize(), m_error);
+    std::cout << "[" << getName() << "] Saved calibration as " 
+        << m_calibrationFileName << std::endl;
+
+    cv::Mat map1;
+    cv::Mat map2;
+    UndistortionMaps::compute(m_cameraMatrix, m_distortionCoefficients,
+        m_calibrator->getImageSize(), map1, map2);
+    UndistortionMaps::write(m_mapsFileName, map1, map2);
+    std::cout << "[" << getName() << "] Saved undistortion maps as " 
+        << m_mapsFileName << std::endl;
+  } catch (std::invalid_argument &e) {
+    std::cerr << "[" << getName() << "] " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // tool
+} // core
+} // opendlv
@@ -0,0 +1,154 @@
+/**
+ * camera-calibration - Tool to find the intrinsic calibration of a camera.
+ * Copyright (C) 2018 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <cmath>
+#include <stdexcept>
+
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "intrinsiccalibrator.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+IntrinsicCalibrator::IntrinsicCalibrator(const uint32_t &a_columns,
+    const uint32_t &a_rows, const double &a_squareSize, const uint32_t &a_views,
+    const double &a_minimumMotion)
+    : m_patternSize(a_columns, a_rows)
+    , m_views(a_views)
+    , m_minimumMotion(a_minimumMotion)
+    , m_target()
+    , m_corners()
+    , m_detected()
+    , m_gray()
+    , m_imageSize()
+{
+  if ((a_columns < 3) || (a_rows < 2)) {
+    throw std::invalid_argument("Invalid chessboard! Use at least 3x2 inner corners");
+  }
+  if (!(a_squareSize > 0) || (a_views < 3)) {
+    throw std::invalid_argument("Invalid calibration! Use a positive square size and at least 3 views");
+  }
+  for (uint32_t row = 0; row < a_rows; row++) {
+    for (uint32_t col = 0; col < a_columns; col++) {
+      m_target.push_back(cv::Point3f(static_cast<float>(col * a_squareSize),
+          static_cast<float>(row * a_squareSize), 0));
+    }
+  }
+}
+
+IntrinsicCalibrator::~IntrinsicCalibrator()
+{
+}
+
+bool IntrinsicCalibrator::addView(const cv::Mat &a_image)
+{
+  if (isComplete() || a_image.empty()) {
+    return false;
+  }
+  if (a_image.channels() == 3) {
+    cv::cvtColor(a_image, m_gray, CV_BGR2GRAY);
+  } else {
+    m_gray = a_image;
+  }
+  if (!cv::findChessboardCorners(m_gray, m_patternSize, m_detected,
+      CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_NORMALIZE_IMAGE
+      | CV_CALIB_CB_FAST_CHECK)) {
+    return false;
+  }
+  cv::cornerSubPix(m_gray, m_detected, cv::Size(11, 11), cv::Size(-1, -1),
+      cv::TermCriteria(CV_TERMCRIT_EPS + CV_TERMCRIT_ITER, 30, 0.01));
+  return addCorners(m_detected, a_image.size());
+}
+
+bool IntrinsicCalibrator::addCorners(const std::vector<cv::Point2f> &a_corners,
+    const cv::Size &a_imageSize)
+{
+  if (isComplete() || (a_corners.size() != m_target.size())) {
+    return false;
+  }
+  if (m_corners.empty()) {
+    m_imageSize = a_imageSize;
+  } else if (a_imageSize != m_imageSize) {
+    return false;
+  } else {
+    const std::vector<cv::Point2f> &last = m_corners.back();
+    double motion = 0;
+    for (uint32_t i = 0; i < a_corners.size(); i++) {
+      motion += std::hypot(a_corners[i].x - last[i].x, a_corners[i].y - last[i].y);
+    }
+    if (motion < m_minimumMotion * a_corners.size()) {
+      return false;
+    }
+  }
+  m_corners.push_back(a_corners);
+  return true;
+}
+
+uint32_t IntrinsicCalibrator::getNumberOfViews() const
+{
+  return static_cast<uint32_t>(m_corners.size());
+}
+
+bool IntrinsicCalibrator::isComplete() const
+{
+  return (m_corners.size() >= m_views);
+}
+
+cv::Size IntrinsicCalibrator::getImageSize() const
+{
+  return m_imageSize;
+}
+
+double IntrinsicCalibrator::calibrate(cv::Mat &a_cameraMatrix,
+    cv::Mat &a_distortionCoefficients) const
+{
+  if (m_corners.size() < 3) {
+    throw std::invalid_argument("Too few views of the chessboard to calibrate");
+  }
+  const std::vector< std::vector<cv::Point3f> > target(m_corners.size(),
+      m_target);
+  std::vector<cv::Mat> rotations;
+  std::vector<cv::Mat> translations;
+  return cv::calibrateCamera(target, m_corners, m_imageSize, a_cameraMatrix,
+      a_distortionCoefficients, rotations, translations);
+}
+
+void IntrinsicCalibrator::writeCalibration(const std::string &a_filename,
+    const cv::Mat &a_cameraMatrix, const cv::Mat &a_distortionCoefficients,
+    const cv::Size &a_imageSize, const double &a_error)
+{
+  cv::FileStorage fileStorage(a_filename, cv::FileStorage::WRITE);
+  if (!fileStorage.isOpened()) {
+    throw std::invalid_argument("Could not open '" + a_filename + "'");
+  }
+  fileStorage << "image_width" << a_imageSize.width;
+  fileStorage << "image_height" << a_imageSize.height;
+  fileStorage << "camera_matrix" << a_cameraMatrix;
+  fileStorage << "distortion_coefficients" << a_distortionCoefficients;
+  fileStorage << "avg_reprojection_error" << a_error;
+  fileStorage.release();
+}
+
+} // tool
+} // core
+} // opendlv
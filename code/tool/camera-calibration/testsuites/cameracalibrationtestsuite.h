@@ -0,0 +1,167 @@
+/**
+ * camera-calibration - Tool to find the intrinsic calibration of a camera.
+ * Copyright (C) 2018 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_CAMERACALIBRATION_TESTSUITE_H
+#define CORE_TOOL_CAMERACALIBRATION_TESTSUITE_H
+
+#include "cxxtest/TestSuite.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "UndistortionMaps.h"
+
+// Include local header files.
+#include "../include/cameracalibration.hpp"
+#include "../include/intrinsiccalibrator.hpp"
+
+using namespace opendlv::core::tool;
+using opendlv::core::UndistortionMaps;
+
+class CameraCalibrationTest : public CxxTest::TestSuite {
+   public:
+    void setUp() {}
+
+    void tearDown() {}
+
+    void testApplication() {
+        TS_ASSERT(true);
+    }
+
+    void testIntrinsicCalibrator() {
+        TS_ASSERT_THROWS(IntrinsicCalibrator(2, 2, 0.025, 10, 20), std::invalid_argument);
+        TS_ASSERT_THROWS(IntrinsicCalibrator(9, 6, 0.025, 2, 20), std::invalid_argument);
+
+        const cv::Size imageSize(640, 480);
+        const cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) << 600, 0, 320, 0, 600, 240, 0, 0, 1);
+        const cv::Mat distortionCoefficients = (cv::Mat_<double>(1, 5) << -0.1, 0.02, 0, 0, 0);
+        std::vector<cv::Point3f> target;
+        for (uint32_t row = 0; row < 6; row++) {
+            for (uint32_t col = 0; col < 9; col++) {
+                target.push_back(cv::Point3f(col * 0.025f, row * 0.025f, 0));
+            }
+        }
+
+        IntrinsicCalibrator calibrator(9, 6, 0.025, 10, 20);
+        cv::Mat m;
+        cv::Mat d;
+        TS_ASSERT_THROWS(calibrator.calibrate(m, d), std::invalid_argument);
+
+        // Views of the chessboard tilted in turn around both axes.
+        for (uint32_t i = 0; i < 10; i++) {
+            const double angle = 0.1 + 0.05 * i;
+            const cv::Mat rotation = (cv::Mat_<double>(3, 1) << ((i % 2 == 0) ? angle : -angle), ((i % 3 == 0) ? -angle : angle), 0.05 * i);
+            const cv::Mat translation = (cv::Mat_<double>(3, 1) << -0.1, -0.06, 0.4 + 0.02 * i);
+            std::vector<cv::Point2f> corners;
+            cv::projectPoints(target, rotation, translation, cameraMatrix, distortionCoefficients, corners);
+
+            TS_ASSERT(!calibrator.isComplete());
+            TS_ASSERT(calibrator.addCorners(corners, imageSize));
+            // The same pose again adds nothing.
+            TS_ASSERT(!calibrator.addCorners(corners, imageSize));
+        }
+        TS_ASSERT(calibrator.isComplete());
+        TS_ASSERT_EQUALS(calibrator.getNumberOfViews(), 10u);
+
+        const double error = calibrator.calibrate(m, d);
+        TS_ASSERT(error < 0.01);
+        TS_ASSERT_DELTA(m.at<double>(0, 0), 600, 1);
+        TS_ASSERT_DELTA(m.at<double>(1, 1), 600, 1);
+        TS_ASSERT_DELTA(m.at<double>(0, 2), 320, 1);
+        TS_ASSERT_DELTA(m.at<double>(1, 2), 240, 1);
+        TS_ASSERT_DELTA(d.at<double>(0), -0.1, 0.01);
+    }
+
+    void testAddView() {
+        // 10x7 squares of 40 pixels, i.e., 9x6 inner corners.
+        cv::Mat image(480, 640, CV_8UC3, cv::Scalar(255, 255, 255));
+        for (int32_t row = 0; row < 7; row++) {
+            for (int32_t col = 0; col < 10; col++) {
+                if ((row + col) % 2 == 0) {
+                    cv::rectangle(image, cv::Rect(120 + 40 * col, 100 + 40 * row, 40, 40), cv::Scalar(0, 0, 0), CV_FILLED);
+                }
+            }
+        }
+        IntrinsicCalibrator calibrator(9, 6, 0.025, 10, 20);
+        TS_ASSERT(!calibrator.addView(cv::Mat(480, 640, CV_8UC3, cv::Scalar(255, 255, 255))));
+        TS_ASSERT(calibrator.addView(image));
+        TS_ASSERT(!calibrator.addView(image));
+        TS_ASSERT_EQUALS(calibrator.getNumberOfViews(), 1u);
+        TS_ASSERT(calibrator.getImageSize() == cv::Size(640, 480));
+    }
+
+    void testWriteCalibration() {
+        const std::string FILENAME = "camera-calibration-test-calibration.yml";
+        const cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) << 600, 0, 320, 0, 600, 240, 0, 0, 1);
+        const cv::Mat distortionCoefficients = (cv::Mat_<double>(1, 5) << -0.1, 0.02, 0, 0, 0);
+        IntrinsicCalibrator::writeCalibration(FILENAME, cameraMatrix, distortionCoefficients, cv::Size(640, 480), 0.2);
+
+        // The keys read by proxy-camera-axis.
+        cv::FileStorage fileStorage(FILENAME, cv::FileStorage::READ);
+        cv::Mat m;
+        cv::Mat d;
+        fileStorage["camera_matrix"] >> m;
+        fileStorage["distortion_coefficients"] >> d;
+        fileStorage.release();
+        TS_ASSERT(cv::norm(m, cameraMatrix) < 1e-9);
+        TS_ASSERT(cv::norm(d, distortionCoefficients) < 1e-9);
+        std::remove(FILENAME.c_str());
+
+        TS_ASSERT_THROWS(IntrinsicCalibrator::writeCalibration("/nonexistent/calibration.yml", cameraMatrix, distortionCoefficients, cv::Size(640, 480), 0.2), std::invalid_argument);
+    }
+
+    void testUndistortionMaps() {
+        const std::string FILENAME = "camera-calibration-test-undistortion.maps";
+        const cv::Mat cameraMatrix = (cv::Mat_<double>(3, 3) << 600, 0, 320, 0, 600, 240, 0, 0, 1);
+        const cv::Mat distortionCoefficients = (cv::Mat_<double>(1, 5) << -0.1, 0.02, 0, 0, 0);
+        cv::Mat map1;
+        cv::Mat map2;
+        UndistortionMaps::compute(cameraMatrix, distortionCoefficients, cv::Size(640, 480), map1, map2);
+        TS_ASSERT_EQUALS(map1.type(), CV_16SC2);
+        TS_ASSERT_EQUALS(map2.type(), CV_16UC1);
+
+        TS_ASSERT_THROWS(UndistortionMaps::read(FILENAME, map1, map2), std::invalid_argument);
+        UndistortionMaps::write(FILENAME, map1, map2);
+        cv::Mat read1;
+        cv::Mat read2;
+        UndistortionMaps::read(FILENAME, read1, read2);
+        TS_ASSERT(read1.size() == map1.size());
+        TS_ASSERT_EQUALS(read1.type(), map1.type());
+        TS_ASSERT_EQUALS(read2.type(), map2.type());
+        TS_ASSERT_EQUALS(cv::countNonZero(read1.reshape(1) != map1.reshape(1)), 0);
+        TS_ASSERT_EQUALS(cv::countNonZero(read2 != map2), 0);
+
+        // A truncated file is rejected.
+        {
+            std::ofstream file(FILENAME, std::ios::binary | std::ios::trunc);
+            file << "UNDIST01";
+        }
+        TS_ASSERT_THROWS(UndistortionMaps::read(FILENAME, read1, read2), std::invalid_argument);
+        std::remove(FILENAME.c_str());
+
+        TS_ASSERT_THROWS(UndistortionMaps::write(FILENAME, map1, cv::Mat()), std::invalid_argument);
+    }
+};
+
+#endif
@@ -20,16 +20,25 @@
 #ifndef CORE_TOOL_CAMERAPROJECTION_HPP_
 #define CORE_TOOL_CAMERAPROJECTION_HPP_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <opendavinci/odcore/wrapper/Eigen.h>
 
 #include <opendavinci/odcore/base/module/TimeTriggeredConferenceClientModule.h>
 #include <opendavinci/odcore/data/Container.h>
+#include <opendavinci/odcore/wrapper/SharedMemory.h>
 
 #include "opencv2/highgui/highgui.hpp"
 
+#include "groundtargetcalibrator.hpp"
+#include "inverseperspectivemapping.hpp"
+#include "pixelprojector.hpp"
+#include "SeqLock.h"
+#include "SharedImageReader.h"
+
 namespace opendlv {
 namespace core {
 namespace tool {
@@ -61,23 +70,63 @@ class CameraProjection
   void tearDown();
 
   odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
+  void Show();
   void Calibrate();
   void Config(std::vector<double>);
   void Save();
+  void SaveMatrix(Eigen::Matrix3d const &);
+  void HandOverMatrix(Eigen::Matrix3d const &);
+  void UpdateMatrix();
+  void AutoCalibrate();
   void Project();
   void ReadMatrix();
-  void Warp();
+  void Warp(odcore::data::TimeStamp const &);
+  void ProjectCoordinates(odcore::data::Container &);
 
   cv::Mat m_image;
+  bool m_gui;
+  std::mutex m_displayMutex;
+  cv::Mat m_displayImage; // Newest frame handed to the body for display.
+  bool m_hasDisplayImage;
+  cv::Mat m_shownImage;
+  SharedImageReader m_sharedImageReader;
   std::string m_inputStr;
   std::string m_outputStr;
   double m_recHeight;
   double m_recWidth;
   double m_recPosX;
   double m_recPosY;
-  Eigen::MatrixXd m_aMatrix;
-  Eigen::MatrixXd m_bMatrix;
-  Eigen::MatrixXd m_projectionMatrix;
+  Eigen::Matrix3d m_aMatrix;
+  Eigen::Matrix3d m_bMatrix;
+  // The matrix, projector and IPM are used by nextContainer only; the body
+  // hands new matrices over through m_newMatrix.
+  Eigen::Matrix3d m_projectionMatrix;
+  PixelProjector m_projector;
+  std::vector<float> m_groundCoordinates;
+  bool m_hasMatrix;
+  std::mutex m_matrixMutex;
+  Eigen::Matrix3d m_newMatrix;
+  bool m_hasNewMatrix;
+  PixelProjector m_clickProjector; // Projects mouse clicks in the body.
+
+  std::unique_ptr<GroundTargetCalibrator> m_calibrator;
+  std::atomic<bool> m_autoCalibrationDone;
+  bool m_autoCalibrationFailed;
+
+  bool m_warp;
+  std::string m_warpName;
+  double m_warpMinX;
+  double m_warpMaxX;
+  double m_warpMinY;
+  double m_warpMaxY;
+  double m_warpResolution;
+  uint32_t m_warpThreads;
+  std::unique_ptr<InversePerspectiveMapping> m_ipm;
+  int32_t m_ipmImageWidth;
+  int32_t m_ipmImageHeight;
+  std::shared_ptr<odcore::wrapper::SharedMemory> m_warpMemory;
+  std::unique_ptr<SeqLock> m_warpSeqLock;
+  uint32_t m_warpSize;
 
   std::string m_cameraName;
   std::string m_transformationMatrixFileName;
@@ -0,0 +1,105 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_GROUNDTARGETCALIBRATOR_HPP_
+#define CORE_TOOL_GROUNDTARGETCALIBRATOR_HPP_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include <opendavinci/odcore/wrapper/Eigen.h>
+
+#include "opencv2/core/core.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class finds the pixel-to-world homography of a camera from a
+ * chessboard lying on the ground, without manual clicks.
+ *
+ * The inner corners of the chessboard are detected in each frame and
+ * refined to subpixel accuracy. Of the two corners at the ends of the
+ * detected order, the one lower in the frame is taken as the first corner;
+ * it lies at the origin of the target in the world. Corners along a row of
+ * the chessboard step by the square size in the direction of the heading,
+ * and rows step to the left of it. The homography is solved with RANSAC
+ * over the corners of all collected frames.
+ */
+class GroundTargetCalibrator
+{
+ public:
+  /**
+   * Constructor.
+   *
+   * @param columns Inner corners per row of the chessboard.
+   * @param rows Inner corners per column of the chessboard.
+   * @param squareSize Size of a square in meters.
+   * @param originX World x of the first corner in meters.
+   * @param originY World y of the first corner in meters.
+   * @param heading Direction of the rows of the chessboard in radians from the x axis.
+   * @param frames Number of frames with the chessboard to collect.
+   * @param threshold Largest distance in meters of a corner to count as inlier.
+   */
+  GroundTargetCalibrator(const uint32_t &columns, const uint32_t &rows, const double &squareSize, const double &originX, const double &originY, const double &heading, const uint32_t &frames, const double &threshold);
+  GroundTargetCalibrator(GroundTargetCalibrator const &) = delete;
+  GroundTargetCalibrator &operator=(GroundTargetCalibrator const &) = delete;
+  virtual ~GroundTargetCalibrator();
+
+  /**
+   * This method looks for the chessboard in a frame.
+   *
+   * @param image BGR or gray frame.
+   * @return true if the chessboard was found.
+   */
+  bool addFrame(const cv::Mat &image);
+
+  uint32_t getNumberOfFrames() const;
+  bool isComplete() const;
+
+  /**
+   * This method solves the homography over the collected frames.
+   *
+   * @param pixelToWorld Pixel-to-world homography.
+   * @param meanError Mean distance in meters of the inlier corners to their target position.
+   * @param inliers Number of inlier corners.
+   * @return false if too few corners were collected or no homography was found.
+   */
+  bool calibrate(Eigen::Matrix3d &pixelToWorld, double &meanError, uint32_t &inliers) const;
+
+ private:
+  cv::Size m_patternSize;
+  uint32_t m_frames;
+  double m_threshold;
+  std::vector<cv::Point2f> m_target; // World position of each corner.
+  std::vector<cv::Point2f> m_pixels; // Corners of all collected frames.
+  std::vector<cv::Point2f> m_world;
+  std::vector<cv::Point2f> m_corners;
+  cv::Mat m_gray;
+  uint32_t m_collected;
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_INVERSEPERSPECTIVEMAPPING_HPP_
+#define CORE_TOOL_INVERSEPERSPECTIVEMAPPING_HPP_
+
+#include <stdint.h>
+
+#include <opendavinci/odcore/wrapper/Eigen.h>
+
+#include "opencv2/core/core.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class warps camera frames into a top-down metric grid on the ground
+ * (bird's-eye view) with the pixel-to-world homography found by
+ * camera-projection.
+ *
+ * The grid covers x from minX to maxX and y from minY to maxY in meters.
+ * Its rows run along x with maxX at the top, and its columns run along y
+ * with maxY at the left, i.e., x points up and y to the left in the grid.
+ * Each cell is sampled at its centre.
+ *
+ * The source pixel of every cell is computed once, and each frame is then
+ * warped in horizontal bands on several threads without allocation. Cells
+ * outside the frame or on the other side of the horizon are black.
+ */
+class InversePerspectiveMapping
+{
+ public:
+  /**
+   * Constructor.
+   *
+   * @param pixelToWorld Pixel-to-world homography.
+   * @param imageWidth Width of the camera frames.
+   * @param imageHeight Height of the camera frames.
+   * @param minX Near end of the grid in meters.
+   * @param maxX Far end of the grid in meters.
+   * @param minY Right end of the grid in meters.
+   * @param maxY Left end of the grid in meters.
+   * @param resolution Size of a cell in meters.
+   * @param threads Number of bands warped in parallel.
+   */
+  InversePerspectiveMapping(const Eigen::Matrix3d &pixelToWorld, const uint32_t &imageWidth, const uint32_t &imageHeight, const double &minX, const double &maxX, const double &minY, const double &maxY, const double &resolution, const uint32_t &threads);
+  InversePerspectiveMapping(InversePerspectiveMapping const &) = delete;
+  InversePerspectiveMapping &operator=(InversePerspectiveMapping const &) = delete;
+  virtual ~InversePerspectiveMapping();
+
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
+
+  /**
+   * This method warps a frame.
+   *
+   * @param image Camera frame of the size given to the constructor.
+   * @param grid Grid of the same type as the frame; it is only allocated if its size or type differ.
+   * @return false if the frame does not have the expected size.
+   */
+  bool warp(const cv::Mat &image, cv::Mat &grid) const;
+
+ private:
+  uint32_t m_imageWidth;
+  uint32_t m_imageHeight;
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_threads;
+  cv::Mat m_map; // Fixed-point source pixel of each cell.
+  cv::Mat m_interpolation; // Interpolation weights of each cell.
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
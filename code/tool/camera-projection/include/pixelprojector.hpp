@@ -0,0 +1,109 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_PIXELPROJECTOR_HPP_
+#define CORE_TOOL_PIXELPROJECTOR_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <opendavinci/odcore/wrapper/Eigen.h>
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class projects pixel coordinates of a camera to coordinates on the
+ * ground with the pixel-to-world homography found by camera-projection.
+ *
+ * Batches of points are projected four at a time with SSE, including the
+ * homogeneous division. Points at the horizon of the camera, where the
+ * homogeneous coordinate vanishes, are projected to NaN.
+ */
+class PixelProjector
+{
+ public:
+  PixelProjector();
+  PixelProjector(const Eigen::Matrix3d &pixelToWorld);
+  virtual ~PixelProjector();
+
+  /**
+   * This method reads a homography saved by camera-projection, i.e., nine
+   * numbers in row-major order.
+   *
+   * @param filename File such as <camera>-pixel2world-matrix.csv.
+   * @return Pixel-to-world homography.
+   */
+  static Eigen::Matrix3d readMatrix(const std::string &filename);
+
+  /**
+   * This method saves a homography in the format read by readMatrix.
+   *
+   * @param filename File such as <camera>-pixel2world-matrix.csv.
+   * @param pixelToWorld Pixel-to-world homography.
+   */
+  static void writeMatrix(const std::string &filename, const Eigen::Matrix3d &pixelToWorld);
+
+  void setMatrix(const Eigen::Matrix3d &pixelToWorld);
+  Eigen::Matrix3d getMatrix() const;
+
+  /**
+   * This method projects one point.
+   *
+   * @param x Column of the pixel.
+   * @param y Row of the pixel.
+   * @param worldX Projected x in meters.
+   * @param worldY Projected y in meters.
+   * @return false if the point is at the horizon.
+   */
+  bool project(const double &x, const double &y, double &worldX, double &worldY) const;
+
+  /**
+   * This method projects a batch of points.
+   *
+   * @param pixels Pairs of column and row.
+   * @param count Number of points.
+   * @param world Pairs of projected x and y in meters, may be pixels.
+   * @return Number of points that are not at the horizon.
+   */
+  uint32_t project(const float *pixels, const uint32_t &count, float *world) const;
+
+  /**
+   * This method projects all pixels of a frame.
+   *
+   * @param width Width of the frame.
+   * @param height Height of the frame.
+   * @param table Pairs of projected x and y in meters for each pixel in row-major order.
+   */
+  void createLookUpTable(const uint32_t &width, const uint32_t &height, std::vector<float> &table) const;
+
+ private:
+  Eigen::Matrix3d m_pixelToWorld;
+  float m_h[9]; // Homography in row-major order for the batches.
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
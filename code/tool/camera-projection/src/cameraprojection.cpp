@@ -17,8 +17,12 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <endian.h>
+
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <stdexcept>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -26,12 +30,16 @@
 #include "opendavinci/GeneratedHeaders_OpenDaVINCI.h"
 #include "opendavinci/odcore/data/Container.h"
 #include "opendavinci/odcore/base/KeyValueConfiguration.h"
+#include "opendavinci/odcore/base/Lock.h"
 #include "opendavinci/odcore/wrapper/SharedMemoryFactory.h"
 #include "opendavinci/odcore/wrapper/SharedMemory.h"
 
 #include "opendavinci/odcore/strings/StringToolbox.h"
+#include "odvdvehicle/generated/opendlv/logic/perception/GroundCoordinates.h"
+#include "odvdvehicle/generated/opendlv/logic/perception/ImageCoordinates.h"
 
 #include "cameraprojection.hpp"
+#include "SeqLock.h"
 
 namespace opendlv {
 namespace core {
@@ -58,14 +66,15 @@ void LogMouseClicks(int32_t a_event, int32_t a_x, int32_t a_y, int32_t,
 void ProjectMouseClicks(int32_t a_event, int32_t a_x, int32_t a_y, int32_t,
     void* a_userdata)
 {
-  Eigen::Vector3d v;
-  Eigen::MatrixXd* m = (Eigen::MatrixXd*) a_userdata;
+  PixelProjector* projector = (PixelProjector*) a_userdata;
   
   if(a_event == cv::EVENT_LBUTTONDOWN){
-    v << a_x, a_y, 1;
-    v = *m * v;
-    v = v / v(2);
-    std::cout << v << std::endl;
+    double x, y;
+    if (projector->project(a_x, a_y, x, y)) {
+      std::cout << x << std::endl << y << std::endl;
+    } else {
+      std::cout << "(" << a_x << ", " << a_y << ") is at the horizon." << std::endl;
+    }
   } 
 }
 
@@ -86,6 +95,12 @@ CameraProjection::CameraProjection(int32_t const &a_argc, char **a_argv)
     : odcore::base::module::TimeTriggeredConferenceClientModule(
         a_argc, a_argv, "core-tool-camera-projection")
     , m_image()
+    , m_gui(true)
+    , m_displayMutex()
+    , m_displayImage()
+    , m_hasDisplayImage(false)
+    , m_shownImage()
+    , m_sharedImageReader()
     , m_inputStr()
     , m_outputStr()
     , m_recHeight()
@@ -95,15 +110,39 @@ CameraProjection::CameraProjection(int32_t const &a_argc, char **a_argv)
     , m_aMatrix()
     , m_bMatrix()
     , m_projectionMatrix()
+    , m_projector()
+    , m_groundCoordinates()
+    , m_hasMatrix(false)
+    , m_matrixMutex()
+    , m_newMatrix()
+    , m_hasNewMatrix(false)
+    , m_clickProjector()
+    , m_calibrator()
+    , m_autoCalibrationDone(false)
+    , m_autoCalibrationFailed(false)
+    , m_warp(false)
+    , m_warpName()
+    , m_warpMinX()
+    , m_warpMaxX()
+    , m_warpMinY()
+    , m_warpMaxY()
+    , m_warpResolution()
+    , m_warpThreads(4)
+    , m_ipm()
+    , m_ipmImageWidth(0)
+    , m_ipmImageHeight(0)
+    , m_warpMemory()
+    , m_warpSeqLock()
+    , m_warpSize(0)
     , m_cameraName()
     , m_transformationMatrixFileName()
     , m_initialized(false)
     , m_debug()
 {
-  m_aMatrix = Eigen::MatrixXd(3,3);
-  m_bMatrix = Eigen::MatrixXd(3,3);
-  m_projectionMatrix = Eigen::MatrixXd(3,3);
-
+  m_aMatrix = Eigen::Matrix3d::Identity();
+  m_bMatrix = Eigen::Matrix3d::Identity();
+  m_projectionMatrix = Eigen::Matrix3d::Identity();
+  m_newMatrix = Eigen::Matrix3d::Identity();
 }
 
 CameraProjection::~CameraProjection()
@@ -119,7 +158,85 @@ void CameraProjection::setUp()
   m_debug = (kv.getValue<int32_t>("core-tool-camera-projection.debug") == 0);
   m_transformationMatrixFileName = 
       "./" + m_cameraName + "-pixel2world-matrix.csv";
-  cv::namedWindow("Calibration", 1 );
+  // Project image coordinates with a saved matrix right away.
+  try {
+    m_projectionMatrix = PixelProjector::readMatrix(m_transformationMatrixFileName);
+    m_projector.setMatrix(m_projectionMatrix);
+    m_clickProjector.setMatrix(m_projectionMatrix);
+    m_hasMatrix = true;
+    std::cout << "[" << getName() << "] Read matrix from " 
+        << m_transformationMatrixFileName << std::endl;
+  } catch (std::invalid_argument &) {
+  }
+
+  // Bird's-eye view of the frames in a grid on the ground.
+  try {
+    m_warp = (kv.getValue<int32_t>("core-tool-camera-projection.warp") == 1);
+  } catch (...) {
+  }
+  if (m_warp) {
+    m_warpName = m_cameraName + "-ipm";
+    try {
+      m_warpName = kv.getValue<std::string>("core-tool-camera-projection.warp.name");
+    } catch (...) {
+    }
+    m_warpMinX = kv.getValue<double>("core-tool-camera-projection.warp.minx");
+    m_warpMaxX = kv.getValue<double>("core-tool-camera-projection.warp.maxx");
+    m_warpMinY = kv.getValue<double>("core-tool-camera-projection.warp.miny");
+    m_warpMaxY = kv.getValue<double>("core-tool-camera-projection.warp.maxy");
+    m_warpResolution = kv.getValue<double>("core-tool-camera-projection.warp.resolution");
+    try {
+      m_warpThreads = kv.getValue<uint32_t>("core-tool-camera-projection.warp.threads");
+    } catch (...) {
+    }
+    if (!(m_warpResolution > 0) || !(m_warpMaxX > m_warpMinX) 
+        || !(m_warpMaxY > m_warpMinY)) {
+      throw std::invalid_argument("Invalid warp grid! Use a positive resolution and min < max");
+    }
+  }
+
+  // Without the GUI, the tool only projects and warps with the saved matrix.
+  try {
+    m_gui = (kv.getValue<int32_t>("core-tool-camera-projection.gui") == 1);
+  } catch (...) {
+  }
+
+  // Calibrate from a chessboard on the ground without user interaction.
+  bool autoCalibrate = false;
+  try {
+    autoCalibrate = (kv.getValue<int32_t>("core-tool-camera-projection.autocalibrate") == 1);
+  } catch (...) {
+  }
+  if (autoCalibrate) {
+    double originX = 0;
+    double originY = 0;
+    double heading = 0;
+    uint32_t frames = 20;
+    double threshold = 0.05;
+    try {
+      originX = kv.getValue<double>("core-tool-camera-projection.target.originx");
+      originY = kv.getValue<double>("core-tool-camera-projection.target.originy");
+      heading = kv.getValue<double>("core-tool-camera-projection.target.heading");
+    } catch (...) {
+    }
+    try {
+      frames = kv.getValue<uint32_t>("core-tool-camera-projection.calibration.frames");
+    } catch (...) {
+    }
+    try {
+      threshold = kv.getValue<double>("core-tool-camera-projection.calibration.threshold");
+    } catch (...) {
+    }
+    m_calibrator.reset(new GroundTargetCalibrator(
+        kv.getValue<uint32_t>("core-tool-camera-projection.target.columns"),
+        kv.getValue<uint32_t>("core-tool-camera-projection.target.rows"),
+        kv.getValue<double>("core-tool-camera-projection.target.squaresize"),
+        originX, originY, heading, frames, threshold));
+    m_gui = false;
+  }
+  if (m_gui) {
+    cv::namedWindow("Calibration", 1 );
+  }
   m_initialized = true;
 }
 
@@ -133,56 +250,60 @@ void CameraProjection::nextContainer(odcore::data::Container &a_c)
   if (!m_initialized) {
     return;
   }
+  UpdateMatrix();
+  if (a_c.getDataType() == opendlv::logic::perception::ImageCoordinates::ID()) {
+    ProjectCoordinates(a_c);
+    return;
+  }
   if (a_c.getDataType() == odcore::data::image::SharedImage::ID()) {
     odcore::data::image::SharedImage mySharedImg =
         a_c.getData<odcore::data::image::SharedImage>();
-    if (mySharedImg.getName().compare(m_cameraName) != 0) {
+    // Cameras with a ring of segments name them <name>.<slot>; derived
+    // images in <name>.<derived> are not slots.
+    const std::string name = mySharedImg.getName();
+    const bool isSlot = (name.size() > m_cameraName.size() + 1)
+        && (name.compare(0, m_cameraName.size() + 1, m_cameraName + ".") == 0)
+        && (name.find_first_not_of("0123456789", m_cameraName.size() + 1)
+        == std::string::npos);
+    if ((name.compare(m_cameraName) != 0) && !isSlot) {
       std::cout << "[" << getName() << "] Received shared image from: " 
           << mySharedImg.getName() << ", was expecting: " << m_cameraName 
           << std::endl;
       return;
     }
-    std::shared_ptr<odcore::wrapper::SharedMemory> sharedMem(
-        odcore::wrapper::SharedMemoryFactory::attachToSharedMemory(
-            mySharedImg.getName()));
-    const uint32_t nrChannels = mySharedImg.getBytesPerPixel();
-    const uint32_t imgWidth = mySharedImg.getWidth();
-    const uint32_t imgHeight = mySharedImg.getHeight();
-
-    IplImage* myIplImage;
-    
-    myIplImage = cvCreateImage(cvSize(imgWidth, imgHeight), IPL_DEPTH_8U,
-        nrChannels);
-    cv::Mat image(myIplImage);
-    m_image = image;
-
-    if(!sharedMem->isValid()){
+    // The shared memory stays attached between frames.
+    if (!m_sharedImageReader.attach(mySharedImg)) {
       std::cout 
           << "[" << getName() << "] Shared memory is not valid." 
           << std::endl;
       return;
     }
+    // The frame is only allocated when its geometry changes.
+    if (!m_sharedImageReader.copyTo(m_image)) {
+      return;
+    }
+
+    if (m_calibrator.get() != nullptr) {
+      if (!m_autoCalibrationDone && m_calibrator->addFrame(m_image)) {
+        std::cout << "[" << getName() << "] Found chessboard in " 
+            << m_calibrator->getNumberOfFrames() << " frames." << std::endl;
+        if (m_calibrator->isComplete()) {
+          AutoCalibrate();
+        }
+      }
+      return;
+    }
+
+    Warp(a_c.getSampleTimeStamp());
 
-    sharedMem->lock();
-    memcpy(m_image.data, sharedMem->getSharedMemory(), 
-        imgWidth*imgHeight*nrChannels);
-    sharedMem->unlock();
-
-    putText(m_image, "Rectangle width: " + std::to_string(m_recWidth),
-        cvPoint(30, 30), 1, 0.8, cvScalar(0, 0, 254), 1, CV_AA);
-    putText(m_image, "Rectangle height: " + std::to_string(m_recHeight),
-        cvPoint(30, 40), 1, 0.8, cvScalar(0, 0, 254), 1, CV_AA);
-    putText(m_image, "Position (x,y): (" + std::to_string(m_recPosX) + "," 
-        + std::to_string(m_recPosY) + ")" , cvPoint(30, 50), 1, 0.8,
-        cvScalar(0, 0, 254), 1, CV_AA);
-    putText(m_image, m_outputStr , cvPoint(30,60), 1, 0.8,
-        cvScalar(0, 0, 254), 1, CV_AA);
-    putText(m_image, "Input string: " + m_inputStr , cvPoint(30, 70), 1, 0.8,
-        cvScalar(0, 0, 254), 1, CV_AA);
-
-    cv::imshow("Calibration", m_image);
-
-    cvReleaseImage(&myIplImage);
+    // The body shows the frame; one is only copied once the last is shown.
+    if (m_gui) {
+      std::unique_lock<std::mutex> l(m_displayMutex, std::try_to_lock);
+      if (l.owns_lock() && !m_hasDisplayImage) {
+        m_image.copyTo(m_displayImage);
+        m_hasDisplayImage = true;
+      }
+    }
     return;
   }
 }
@@ -190,9 +311,26 @@ void CameraProjection::nextContainer(odcore::data::Container &a_c)
 odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode 
     CameraProjection::body()
 {
+  if (m_calibrator.get() != nullptr) {
+    while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
+        odcore::data::dmcp::ModuleStateMessage::RUNNING 
+        && !m_autoCalibrationDone) {
+    }
+    return m_autoCalibrationFailed 
+        ? odcore::data::dmcp::ModuleExitCodeMessage::SERIOUS_ERROR
+        : odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
+  }
+  if (!m_gui) {
+    while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
+        odcore::data::dmcp::ModuleStateMessage::RUNNING) {
+    }
+    return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
+  }
+
   bool menuMode = 1;
   while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
   odcore::data::dmcp::ModuleStateMessage::RUNNING){
+    Show();
     char key = (char) cv::waitKey(1);
 
     if (menuMode) {
@@ -261,24 +399,172 @@ odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode
 }
 
 
-void CameraProjection::ReadMatrix()
+void CameraProjection::Show()
 {
-  Eigen::MatrixXd m(3,3);
-  std::ifstream indata(m_transformationMatrixFileName, std::ifstream::in);
-  if (indata.is_open()) {
-    for (uint8_t i = 0; i < 3; ++i) {
-      for (uint8_t j = 0; j < 3; ++j) {
-        double item;
-        indata >> item;
-        m(i,j) = item;
-      }
+  {
+    std::lock_guard<std::mutex> l(m_displayMutex);
+    if (!m_hasDisplayImage) {
+      return;
     }
-    std::cout << "[" << getName() << "] Read matrix: " << m << std::endl;
+    // The buffer of the shown frame is reused for the next one.
+    cv::swap(m_displayImage, m_shownImage);
+    m_hasDisplayImage = false;
   }
-  else {
-    std::cout << "[" << getName() << "] File not found." << std::endl;
+
+  putText(m_shownImage, "Rectangle width: " + std::to_string(m_recWidth),
+      cvPoint(30, 30), 1, 0.8, cvScalar(0, 0, 254), 1, CV_AA);
+  putText(m_shownImage, "Rectangle height: " + std::to_string(m_recHeight),
+      cvPoint(30, 40), 1, 0.8, cvScalar(0, 0, 254), 1, CV_AA);
+  putText(m_shownImage, "Position (x,y): (" + std::to_string(m_recPosX) + "," 
+      + std::to_string(m_recPosY) + ")" , cvPoint(30, 50), 1, 0.8,
+      cvScalar(0, 0, 254), 1, CV_AA);
+  putText(m_shownImage, m_outputStr , cvPoint(30,60), 1, 0.8,
+      cvScalar(0, 0, 254), 1, CV_AA);
+  putText(m_shownImage, "Input string: " + m_inputStr , cvPoint(30, 70), 1,
+      0.8, cvScalar(0, 0, 254), 1, CV_AA);
+
+  cv::imshow("Calibration", m_shownImage);
+}
+
+void CameraProjection::Warp(odcore::data::TimeStamp const &a_sampleTimeStamp)
+{
+  if (!m_warp || !m_hasMatrix) {
+    return;
   }
-  indata.close();
+  // The remap table is computed once per matrix and frame size.
+  if ((m_ipm.get() == nullptr) || (m_ipmImageWidth != m_image.cols)
+      || (m_ipmImageHeight != m_image.rows)) {
+    m_ipm.reset(new InversePerspectiveMapping(m_projectionMatrix, m_image.cols,
+        m_image.rows, m_warpMinX, m_warpMaxX, m_warpMinY, m_warpMaxY,
+        m_warpResolution, m_warpThreads));
+    m_ipmImageWidth = m_image.cols;
+    m_ipmImageHeight = m_image.rows;
+    std::cout << "[" << getName() << "] Warping into " << m_warpName << " of "
+        << m_ipm->getWidth() << "x" << m_ipm->getHeight() << " cells." 
+        << std::endl;
+  }
+
+  const uint32_t size = m_ipm->getWidth() * m_ipm->getHeight()
+      * m_image.channels();
+  if (m_warpMemory.get() == nullptr) {
+    // The segment is extended by the trailer of the sequence lock.
+    m_warpSize = size;
+    m_warpSeqLock.reset(new SeqLock(size));
+    m_warpMemory = odcore::wrapper::SharedMemoryFactory::createSharedMemory(
+        m_warpName, m_warpSeqLock->getSegmentSize());
+    if (m_warpMemory->isValid()) {
+      m_warpSeqLock->initialize(
+          static_cast<char*>(m_warpMemory->getSharedMemory()),
+          m_warpMemory->getSize());
+    }
+  }
+  if (!m_warpMemory->isValid() || (size > m_warpSize)) {
+    std::cerr << "[" << getName() << "] Cannot warp into " << m_warpName 
+        << "." << std::endl;
+    return;
+  }
+
+  // The grid wraps the shared memory, so the frame is warped in place.
+  cv::Mat grid(m_ipm->getHeight(), m_ipm->getWidth(), m_image.type(),
+      m_warpMemory->getSharedMemory());
+  bool warped = false;
+  {
+    odcore::base::Lock l(m_warpMemory);
+    m_warpSeqLock->beginWrite();
+    warped = m_ipm->warp(m_image, grid);
+    m_warpSeqLock->endWrite();
+  }
+  if (!warped) {
+    return;
+  }
+
+  odcore::data::image::SharedImage warpedImage;
+  warpedImage.setName(m_warpName);
+  warpedImage.setWidth(m_ipm->getWidth());
+  warpedImage.setHeight(m_ipm->getHeight());
+  warpedImage.setBytesPerPixel(m_image.channels());
+  warpedImage.setSize(size);
+  odcore::data::Container c(warpedImage);
+  c.setSampleTimeStamp(a_sampleTimeStamp);
+  getConference().send(c);
+}
+
+void CameraProjection::ProjectCoordinates(odcore::data::Container &a_c)
+{
+  opendlv::logic::perception::ImageCoordinates imageCoordinates =
+      a_c.getData<opendlv::logic::perception::ImageCoordinates>();
+  if (imageCoordinates.getName() != m_cameraName) {
+    return;
+  }
+  const std::string coordinates = imageCoordinates.getCoordinates();
+  const uint32_t numberOfPoints = imageCoordinates.getNumberOfPoints();
+  if (coordinates.size() != numberOfPoints * 2 * sizeof(float)) {
+    std::cerr << "[" << getName() << "] Expected " << numberOfPoints
+        << " points, received " << coordinates.size() << " bytes." << std::endl;
+    return;
+  }
+
+  // The buffers are kept between frames; projecting in place saves one.
+  // Both messages carry little-endian floats, whatever the host.
+  m_groundCoordinates.resize(2 * numberOfPoints);
+  for (uint32_t i = 0; i < m_groundCoordinates.size(); i++) {
+    uint32_t bits;
+    memcpy(&bits, coordinates.data() + i * sizeof(bits), sizeof(bits));
+    bits = le32toh(bits);
+    memcpy(&m_groundCoordinates[i], &bits, sizeof(bits));
+  }
+  m_projector.project(m_groundCoordinates.data(), numberOfPoints,
+      m_groundCoordinates.data());
+  for (uint32_t i = 0; i < m_groundCoordinates.size(); i++) {
+    uint32_t bits;
+    memcpy(&bits, &m_groundCoordinates[i], sizeof(bits));
+    bits = htole32(bits);
+    memcpy(&m_groundCoordinates[i], &bits, sizeof(bits));
+  }
+
+  opendlv::logic::perception::GroundCoordinates groundCoordinates;
+  groundCoordinates.setName(m_cameraName);
+  groundCoordinates.setNumberOfPoints(numberOfPoints);
+  groundCoordinates.setCoordinates(std::string(
+      reinterpret_cast<const char*>(m_groundCoordinates.data()),
+      m_groundCoordinates.size() * sizeof(float)));
+  odcore::data::Container c(groundCoordinates);
+  c.setSampleTimeStamp(a_c.getSampleTimeStamp());
+  getConference().send(c);
+}
+
+void CameraProjection::ReadMatrix()
+{
+  try {
+    const Eigen::Matrix3d matrix =
+        PixelProjector::readMatrix(m_transformationMatrixFileName);
+    m_clickProjector.setMatrix(matrix);
+    HandOverMatrix(matrix);
+    std::cout << "[" << getName() << "] Read matrix: " << matrix << std::endl;
+  } catch (std::invalid_argument &e) {
+    std::cout << "[" << getName() << "] " << e.what() << std::endl;
+  }
+}
+
+void CameraProjection::HandOverMatrix(Eigen::Matrix3d const &a_matrix)
+{
+  std::lock_guard<std::mutex> l(m_matrixMutex);
+  m_newMatrix = a_matrix;
+  m_hasNewMatrix = true;
+}
+
+void CameraProjection::UpdateMatrix()
+{
+  // The IPM is rebuilt here, so it is never replaced while warping.
+  std::lock_guard<std::mutex> l(m_matrixMutex);
+  if (!m_hasNewMatrix) {
+    return;
+  }
+  m_projectionMatrix = m_newMatrix;
+  m_projector.setMatrix(m_projectionMatrix);
+  m_hasMatrix = true;
+  m_ipm.reset();
+  m_hasNewMatrix = false;
 }
 
 void CameraProjection::Config(std::vector<double> a_param)
@@ -294,7 +580,8 @@ void CameraProjection::Config(std::vector<double> a_param)
   m_recPosX = a_param.at(2);
   m_recPosY = a_param.at(3);
 
-  Eigen::MatrixXd q(3,3), w(3,1);
+  Eigen::Matrix3d q;
+  Eigen::Vector3d w;
   q <<  m_recPosX, m_recPosX, m_recPosX+m_recHeight,
         m_recPosY + m_recWidth, m_recPosY, m_recPosY,
         1,1,1;
@@ -320,7 +607,8 @@ void CameraProjection::Calibrate()
   cv::waitKey(0);
   cv::setMouseCallback(mode, NULL, NULL);
   if (mouseClick.iterator > 3) {
-    Eigen::MatrixXd q(3,3), w(3,1);
+    Eigen::Matrix3d q;
+  Eigen::Vector3d w;
     q << mouseClick.points(0,0),mouseClick.points(0,1),mouseClick.points(0,2),
         mouseClick.points(1,0),mouseClick.points(1,1),mouseClick.points(1,2),
         1,1,1;
@@ -337,32 +625,50 @@ void CameraProjection::Calibrate()
   }
 }
 
-void CameraProjection::Save()
+void CameraProjection::AutoCalibrate()
 {
-  m_projectionMatrix =  m_aMatrix * m_bMatrix.inverse();
+  Eigen::Matrix3d pixelToWorld;
+  double meanError = 0;
+  uint32_t inliers = 0;
+  if (m_calibrator->calibrate(pixelToWorld, meanError, inliers)) {
+    std::cout << "[" << getName() << "] Calibration done with " << inliers 
+        << " inlier corners, mean error " << meanError << " m." << std::endl;
+    SaveMatrix(pixelToWorld);
+  } else {
+    std::cerr << "[" << getName() << "] Calibration failed, no homography fits the chessboard." 
+        << std::endl;
+    m_autoCalibrationFailed = true;
+  }
+  m_autoCalibrationDone = true;
+}
 
-  std::cout << m_projectionMatrix << std::endl;
-  const static Eigen::IOFormat saveFormat(Eigen::StreamPrecision,
-      Eigen::DontAlignCols, " ", " ", "", "", "", "");
-  
+void CameraProjection::Save()
+{
+  const Eigen::Matrix3d matrix = m_aMatrix * m_bMatrix.inverse();
+  m_clickProjector.setMatrix(matrix);
+  SaveMatrix(matrix);
+}
 
-  std::ofstream file(m_transformationMatrixFileName);
-  if (file.is_open()) {
-    file << m_projectionMatrix.format(saveFormat);
+void CameraProjection::SaveMatrix(Eigen::Matrix3d const &a_matrix)
+{
+  HandOverMatrix(a_matrix);
+
+  std::cout << a_matrix << std::endl;
+  try {
+    PixelProjector::writeMatrix(m_transformationMatrixFileName, a_matrix);
+    std::cout << "[" << getName() << "] Saved matrix as " 
+        << m_transformationMatrixFileName 
+        << std::endl;
+  } catch (std::invalid_argument &e) {
+    std::cerr << "[" << getName() << "] " << e.what() << std::endl;
   }
-  file.flush();
-  file.close();
-  std::cout << "[" << getName() << "] Saved matrix as " 
-      << m_transformationMatrixFileName 
-      << std::endl;
-
 }
 
 
 void CameraProjection::Project()
 {
   std::string mode("Calibration");
-  cv::setMouseCallback(mode, ProjectMouseClicks, (void *) &m_projectionMatrix);
+  cv::setMouseCallback(mode, ProjectMouseClicks, (void *) &m_clickProjector);
   cv::waitKey(0);
   cv::setMouseCallback(mode, NULL, NULL);
   std::cout << "Exit point projection" << std::endl;
@@ -0,0 +1,152 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "opencv2/calib3d/calib3d.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "groundtargetcalibrator.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+GroundTargetCalibrator::GroundTargetCalibrator(const uint32_t &a_columns,
+    const uint32_t &a_rows, const double &a_squareSize, const double &a_originX,
+    const double &a_originY, const double &a_heading, const uint32_t &a_frames,
+    const double &a_threshold)
+    : m_patternSize(a_columns, a_rows)
+    , m_frames(a_frames)
+    , m_threshold(a_threshold)
+    , m_target()
+    , m_pixels()
+    , m_world()
+    , m_corners()
+    , m_gray()
+    , m_collected(0)
+{
+  if ((a_columns < 3) || (a_rows < 2) || (a_columns == a_rows)) {
+    throw std::invalid_argument("Invalid chessboard! Use at least 3x2 inner corners and different numbers of columns and rows");
+  }
+  if (!(a_squareSize > 0) || !(a_threshold > 0) || (a_frames == 0)) {
+    throw std::invalid_argument("Invalid calibration! Use a positive square size, threshold, and number of frames");
+  }
+  const double alongX = std::cos(a_heading) * a_squareSize;
+  const double alongY = std::sin(a_heading) * a_squareSize;
+  for (uint32_t row = 0; row < a_rows; row++) {
+    for (uint32_t col = 0; col < a_columns; col++) {
+      // Rows step to the left of the heading.
+      m_target.push_back(cv::Point2f(
+          static_cast<float>(a_originX + col * alongX - row * alongY),
+          static_cast<float>(a_originY + col * alongY + row * alongX)));
+    }
+  }
+}
+
+GroundTargetCalibrator::~GroundTargetCalibrator()
+{
+}
+
+bool GroundTargetCalibrator::addFrame(const cv::Mat &a_image)
+{
+  if (isComplete() || a_image.empty()) {
+    return false;
+  }
+  if (a_image.channels() == 3) {
+    cv::cvtColor(a_image, m_gray, CV_BGR2GRAY);
+  } else {
+    m_gray = a_image;
+  }
+  if (!cv::findChessboardCorners(m_gray, m_patternSize, m_corners,
+      CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_NORMALIZE_IMAGE
+      | CV_CALIB_CB_FAST_CHECK)) {
+    return false;
+  }
+  cv::cornerSubPix(m_gray, m_corners, cv::Size(5, 5), cv::Size(-1, -1),
+      cv::TermCriteria(CV_TERMCRIT_EPS + CV_TERMCRIT_ITER, 30, 0.01));
+  // Seen from above, rows step to the left of the columns, i.e., the cross
+  // product of the steps is negative in the image whose y axis points down.
+  const uint32_t columns = static_cast<uint32_t>(m_patternSize.width);
+  const cv::Point2f alongRow = m_corners[1] - m_corners[0];
+  const cv::Point2f alongColumn = m_corners[columns] - m_corners[0];
+  if (alongRow.x * alongColumn.y - alongRow.y * alongColumn.x > 0) {
+    for (uint32_t i = 0; i < m_corners.size(); i += columns) {
+      std::reverse(m_corners.begin() + i, m_corners.begin() + i + columns);
+    }
+  }
+  // The detected order may start at either end of the chessboard.
+  if (m_corners.front().y < m_corners.back().y) {
+    std::reverse(m_corners.begin(), m_corners.end());
+  }
+  m_pixels.insert(m_pixels.end(), m_corners.begin(), m_corners.end());
+  m_world.insert(m_world.end(), m_target.begin(), m_target.end());
+  m_collected++;
+  return true;
+}
+
+uint32_t GroundTargetCalibrator::getNumberOfFrames() const
+{
+  return m_collected;
+}
+
+bool GroundTargetCalibrator::isComplete() const
+{
+  return (m_collected >= m_frames);
+}
+
+bool GroundTargetCalibrator::calibrate(Eigen::Matrix3d &a_pixelToWorld,
+    double &a_meanError, uint32_t &a_inliers) const
+{
+  if (m_pixels.size() < 4) {
+    return false;
+  }
+  cv::Mat mask;
+  const cv::Mat h = cv::findHomography(m_pixels, m_world, CV_RANSAC,
+      m_threshold, mask);
+  if (h.empty()) {
+    return false;
+  }
+  for (uint8_t i = 0; i < 3; ++i) {
+    for (uint8_t j = 0; j < 3; ++j) {
+      a_pixelToWorld(i, j) = h.at<double>(i, j);
+    }
+  }
+
+  double sum = 0;
+  a_inliers = 0;
+  for (uint32_t i = 0; i < m_pixels.size(); i++) {
+    if (mask.at<uint8_t>(i) == 0) {
+      continue;
+    }
+    const Eigen::Vector3d v = a_pixelToWorld
+        * Eigen::Vector3d(m_pixels[i].x, m_pixels[i].y, 1);
+    sum += std::hypot(v(0) / v(2) - m_world[i].x, v(1) / v(2) - m_world[i].y);
+    a_inliers++;
+  }
+  a_meanError = (a_inliers > 0) ? sum / a_inliers : 0;
+  return (a_inliers >= 4);
+}
+
+} // tool
+} // core
+} // opendlv
@@ -0,0 +1,149 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <cmath>
+#include <stdexcept>
+
+#include "opencv2/imgproc/imgproc.hpp"
+
+#include "inverseperspectivemapping.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+namespace {
+/**
+ * This class warps a band of rows of the grid.
+ */
+class WarpBand : public cv::ParallelLoopBody
+{
+ public:
+  WarpBand(const cv::Mat &a_image, cv::Mat &a_grid, const cv::Mat &a_map, const cv::Mat &a_interpolation, const uint32_t &a_bands)
+      : m_image(a_image)
+      , m_grid(a_grid)
+      , m_map(a_map)
+      , m_interpolation(a_interpolation)
+      , m_bands(a_bands)
+  {
+  }
+
+  virtual void operator()(const cv::Range &a_range) const
+  {
+    const int32_t first = a_range.start * m_grid.rows / m_bands;
+    const int32_t end = a_range.end * m_grid.rows / m_bands;
+    // The band of the grid is a view, so remap writes into the grid.
+    cv::Mat band = m_grid.rowRange(first, end);
+    cv::remap(m_image, band, m_map.rowRange(first, end),
+        m_interpolation.rowRange(first, end), cv::INTER_LINEAR,
+        cv::BORDER_CONSTANT, cv::Scalar());
+  }
+
+ private:
+  WarpBand(WarpBand const &) = delete;
+  WarpBand &operator=(WarpBand const &) = delete;
+
+  const cv::Mat &m_image;
+  cv::Mat &m_grid;
+  const cv::Mat &m_map;
+  const cv::Mat &m_interpolation;
+  int32_t m_bands;
+};
+}
+
+InversePerspectiveMapping::InversePerspectiveMapping(
+    const Eigen::Matrix3d &a_pixelToWorld, const uint32_t &a_imageWidth,
+    const uint32_t &a_imageHeight, const double &a_minX, const double &a_maxX,
+    const double &a_minY, const double &a_maxY, const double &a_resolution,
+    const uint32_t &a_threads)
+    : m_imageWidth(a_imageWidth)
+    , m_imageHeight(a_imageHeight)
+    , m_width(0)
+    , m_height(0)
+    , m_threads((a_threads > 0) ? a_threads : 1)
+    , m_map()
+    , m_interpolation()
+{
+  if (!(a_resolution > 0) || !(a_maxX > a_minX) || !(a_maxY > a_minY)) {
+    throw std::invalid_argument("Invalid grid! Use a positive resolution and min < max");
+  }
+  if ((a_imageWidth == 0) || (a_imageHeight == 0)) {
+    throw std::invalid_argument("Invalid frame size");
+  }
+  m_width = static_cast<uint32_t>(std::ceil((a_maxY - a_minY) / a_resolution));
+  m_height = static_cast<uint32_t>(std::ceil((a_maxX - a_minX) / a_resolution));
+
+  // Ground points in front of the camera have the sign of the homogeneous
+  // coordinate of the bottom centre of the frame.
+  const double bottom = a_pixelToWorld.row(2).dot(Eigen::Vector3d(
+      0.5 * a_imageWidth, a_imageHeight - 1.0, 1.0));
+  const Eigen::Matrix3d worldToPixel = a_pixelToWorld.inverse();
+
+  cv::Mat mapX(m_height, m_width, CV_32FC1);
+  cv::Mat mapY(m_height, m_width, CV_32FC1);
+  for (uint32_t row = 0; row < m_height; row++) {
+    float *x = mapX.ptr<float>(row);
+    float *y = mapY.ptr<float>(row);
+    const double worldX = a_maxX - (row + 0.5) * a_resolution;
+    for (uint32_t col = 0; col < m_width; col++) {
+      const double worldY = a_maxY - (col + 0.5) * a_resolution;
+      const Eigen::Vector3d pixel = worldToPixel * Eigen::Vector3d(worldX, worldY, 1.0);
+      // The pixel projects back with the reciprocal homogeneous coordinate.
+      if (pixel(2) * bottom > 0) {
+        x[col] = static_cast<float>(pixel(0) / pixel(2));
+        y[col] = static_cast<float>(pixel(1) / pixel(2));
+      } else {
+        x[col] = y[col] = -2.0f;
+      }
+    }
+  }
+  // Fixed-point maps are remapped faster than floating-point ones.
+  cv::convertMaps(mapX, mapY, m_map, m_interpolation, CV_16SC2);
+}
+
+InversePerspectiveMapping::~InversePerspectiveMapping()
+{
+}
+
+uint32_t InversePerspectiveMapping::getWidth() const
+{
+  return m_width;
+}
+
+uint32_t InversePerspectiveMapping::getHeight() const
+{
+  return m_height;
+}
+
+bool InversePerspectiveMapping::warp(const cv::Mat &a_image, cv::Mat &a_grid) const
+{
+  if ((static_cast<uint32_t>(a_image.cols) != m_imageWidth)
+      || (static_cast<uint32_t>(a_image.rows) != m_imageHeight)) {
+    return false;
+  }
+  a_grid.create(m_height, m_width, a_image.type());
+  cv::parallel_for_(cv::Range(0, m_threads),
+      WarpBand(a_image, a_grid, m_map, m_interpolation, m_threads));
+  return true;
+}
+
+} // tool
+} // core
+} // opendlv
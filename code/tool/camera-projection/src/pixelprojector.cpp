@@ -0,0 +1,187 @@
+/**
+ * camera-projection - Tool to find projection matrix of camera.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+#include "pixelprojector.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+namespace {
+// Homogeneous coordinates closer to 0 are at the horizon.
+const float HORIZON = 1e-9f;
+}
+
+PixelProjector::PixelProjector()
+    : m_pixelToWorld()
+    , m_h()
+{
+  setMatrix(Eigen::Matrix3d::Identity());
+}
+
+PixelProjector::PixelProjector(const Eigen::Matrix3d &a_pixelToWorld)
+    : m_pixelToWorld()
+    , m_h()
+{
+  setMatrix(a_pixelToWorld);
+}
+
+PixelProjector::~PixelProjector()
+{
+}
+
+Eigen::Matrix3d PixelProjector::readMatrix(const std::string &a_filename)
+{
+  std::ifstream file(a_filename);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Could not open '" + a_filename + "'");
+  }
+  Eigen::Matrix3d m;
+  for (uint8_t i = 0; i < 3; ++i) {
+    for (uint8_t j = 0; j < 3; ++j) {
+      if (!(file >> m(i, j))) {
+        throw std::invalid_argument("Expected nine numbers in '" + a_filename + "'");
+      }
+    }
+  }
+  return m;
+}
+
+void PixelProjector::writeMatrix(const std::string &a_filename,
+    const Eigen::Matrix3d &a_pixelToWorld)
+{
+  const static Eigen::IOFormat saveFormat(Eigen::FullPrecision,
+      Eigen::DontAlignCols, " ", " ", "", "", "", "");
+  std::ofstream file(a_filename);
+  if (!file.is_open()) {
+    throw std::invalid_argument("Could not open '" + a_filename + "'");
+  }
+  file << a_pixelToWorld.format(saveFormat);
+}
+
+void PixelProjector::setMatrix(const Eigen::Matrix3d &a_pixelToWorld)
+{
+  m_pixelToWorld = a_pixelToWorld;
+  for (uint8_t i = 0; i < 3; ++i) {
+    for (uint8_t j = 0; j < 3; ++j) {
+      m_h[3 * i + j] = static_cast<float>(a_pixelToWorld(i, j));
+    }
+  }
+}
+
+Eigen::Matrix3d PixelProjector::getMatrix() const
+{
+  return m_pixelToWorld;
+}
+
+bool PixelProjector::project(const double &a_x, const double &a_y, double &a_worldX, double &a_worldY) const
+{
+  const Eigen::Vector3d v = m_pixelToWorld * Eigen::Vector3d(a_x, a_y, 1);
+  if (std::fabs(v(2)) < HORIZON) {
+    a_worldX = a_worldY = std::numeric_limits<double>::quiet_NaN();
+    return false;
+  }
+  a_worldX = v(0) / v(2);
+  a_worldY = v(1) / v(2);
+  return true;
+}
+
+uint32_t PixelProjector::project(const float *a_pixels, const uint32_t &a_count, float *a_world) const
+{
+  uint32_t valid = 0;
+  uint32_t i = 0;
+#if defined(__SSE2__)
+  const __m128 H0 = _mm_set1_ps(m_h[0]);
+  const __m128 H1 = _mm_set1_ps(m_h[1]);
+  const __m128 H2 = _mm_set1_ps(m_h[2]);
+  const __m128 H3 = _mm_set1_ps(m_h[3]);
+  const __m128 H4 = _mm_set1_ps(m_h[4]);
+  const __m128 H5 = _mm_set1_ps(m_h[5]);
+  const __m128 H6 = _mm_set1_ps(m_h[6]);
+  const __m128 H7 = _mm_set1_ps(m_h[7]);
+  const __m128 H8 = _mm_set1_ps(m_h[8]);
+  const __m128 NOT_A_NUMBER = _mm_set1_ps(std::numeric_limits<float>::quiet_NaN());
+  const __m128 ABSOLUTE = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  const __m128 LIMIT = _mm_set1_ps(HORIZON);
+  for (; i + 4 <= a_count; i += 4) {
+    // Deinterleave four pairs into columns and rows.
+    const __m128 first = _mm_loadu_ps(a_pixels + 2 * i);
+    const __m128 second = _mm_loadu_ps(a_pixels + 2 * i + 4);
+    const __m128 x = _mm_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 y = _mm_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1));
+
+    const __m128 u = _mm_add_ps(_mm_add_ps(_mm_mul_ps(H0, x), _mm_mul_ps(H1, y)), H2);
+    const __m128 v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(H3, x), _mm_mul_ps(H4, y)), H5);
+    const __m128 w = _mm_add_ps(_mm_add_ps(_mm_mul_ps(H6, x), _mm_mul_ps(H7, y)), H8);
+    const __m128 mask = _mm_cmpge_ps(_mm_and_ps(w, ABSOLUTE), LIMIT);
+    const __m128 reciprocal = _mm_div_ps(_mm_set1_ps(1.0f), w);
+    const __m128 worldX = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(u, reciprocal)), _mm_andnot_ps(mask, NOT_A_NUMBER));
+    const __m128 worldY = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(v, reciprocal)), _mm_andnot_ps(mask, NOT_A_NUMBER));
+
+    _mm_storeu_ps(a_world + 2 * i, _mm_unpacklo_ps(worldX, worldY));
+    _mm_storeu_ps(a_world + 2 * i + 4, _mm_unpackhi_ps(worldX, worldY));
+    const int32_t bits = _mm_movemask_ps(mask);
+    valid += (bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) + ((bits >> 3) & 1);
+  }
+#endif
+  for (; i < a_count; i++) {
+    const float x = a_pixels[2 * i];
+    const float y = a_pixels[2 * i + 1];
+    const float w = m_h[6] * x + m_h[7] * y + m_h[8];
+    if (std::fabs(w) < HORIZON) {
+      a_world[2 * i] = a_world[2 * i + 1] = std::numeric_limits<float>::quiet_NaN();
+      continue;
+    }
+    const float reciprocal = 1.0f / w;
+    const float worldX = (m_h[0] * x + m_h[1] * y + m_h[2]) * reciprocal;
+    const float worldY = (m_h[3] * x + m_h[4] * y + m_h[5]) * reciprocal;
+    a_world[2 * i] = worldX;
+    a_world[2 * i + 1] = worldY;
+    valid++;
+  }
+  return valid;
+}
+
+void PixelProjector::createLookUpTable(const uint32_t &a_width, const uint32_t &a_height, std::vector<float> &a_table) const
+{
+  a_table.resize(2 * a_width * a_height);
+  for (uint32_t row = 0; row < a_height; row++) {
+    float *pixels = a_table.data() + 2 * a_width * row;
+    for (uint32_t col = 0; col < a_width; col++) {
+      pixels[2 * col] = static_cast<float>(col);
+      pixels[2 * col + 1] = static_cast<float>(row);
+    }
+    // Projecting in place needs no second buffer.
+    project(pixels, a_width, pixels);
+  }
+}
+
+} // tool
+} // core
+} // opendlv
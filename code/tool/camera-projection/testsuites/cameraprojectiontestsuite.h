@@ -22,8 +22,28 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
+
 // Include local header files.
 #include "../include/cameraprojection.hpp"
+#include "../include/groundtargetcalibrator.hpp"
+#include "../include/inverseperspectivemapping.hpp"
+#include "../include/pixelprojector.hpp"
+#include "SeqLock.h"
+#include "SharedImageReader.h"
+
+using namespace opendlv::core::tool;
+using opendlv::core::SeqLock;
+using opendlv::core::SharedImageReader;
 
 class ProxySickTest : public CxxTest::TestSuite {
    public:
@@ -34,6 +54,260 @@ class ProxySickTest : public CxxTest::TestSuite {
     void testApplication() {
         TS_ASSERT(true);
     }
+
+    void testPixelProjector() {
+        Eigen::Matrix3d h;
+        h << 0.01, -0.002, 3.0,
+             0.0005, -0.03, 20.0,
+             0.0001, 0.004, -1.2;
+        PixelProjector projector(h);
+
+        // Odd count to cover the scalar tail of the batches.
+        const uint32_t COUNT = 10007;
+        std::vector<float> pixels;
+        for (uint32_t i = 0; i < COUNT; i++) {
+            pixels.push_back(static_cast<float>(i % 1280));
+            pixels.push_back(static_cast<float>((i * 7) % 720));
+        }
+        std::vector<float> world(2 * COUNT);
+        TS_ASSERT(projector.project(pixels.data(), COUNT, world.data()) == COUNT);
+        for (uint32_t i = 0; i < COUNT; i++) {
+            double x = 0;
+            double y = 0;
+            TS_ASSERT(projector.project(pixels[2 * i], pixels[2 * i + 1], x, y));
+            const Eigen::Vector3d v = h * Eigen::Vector3d(pixels[2 * i], pixels[2 * i + 1], 1);
+            TS_ASSERT_DELTA(x, v(0) / v(2), 1e-9);
+            TS_ASSERT_DELTA(world[2 * i], x, 1e-2 * std::max(1.0, std::fabs(x)));
+            TS_ASSERT_DELTA(world[2 * i + 1], y, 1e-2 * std::max(1.0, std::fabs(y)));
+        }
+
+        // Points at the horizon, where 0.0001 * x + 0.004 * y = 1.2.
+        float horizon[] = {0, 300, 4000, 200, 0, 300, 4000, 200, 0, 300};
+        TS_ASSERT(projector.project(horizon, 5, horizon) == 0);
+        for (uint32_t i = 0; i < 10; i++) {
+            TS_ASSERT(std::isnan(horizon[i]));
+        }
+
+        // The look-up table matches the single projections.
+        std::vector<float> table;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        projector.createLookUpTable(1280, 720, table);
+        const int64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::endl << "Look-up table of 1280x720 pixels in " << duration << " us" << std::endl;
+        TS_ASSERT(table.size() == 2 * 1280 * 720);
+        double x = 0;
+        double y = 0;
+        projector.project(100, 200, x, y);
+        TS_ASSERT_DELTA(table[2 * (200 * 1280 + 100)], x, 1e-3);
+        TS_ASSERT_DELTA(table[2 * (200 * 1280 + 100) + 1], y, 1e-3);
+    }
+
+    void testInversePerspectiveMapping() {
+        // A camera looking straight down: x = 5 - 0.05 * row, y = 5 - 0.05 * column.
+        Eigen::Matrix3d h;
+        h << 0, -0.05, 5,
+             -0.05, 0, 5,
+             0, 0, 1;
+        TS_ASSERT_THROWS(InversePerspectiveMapping(h, 200, 100, 0, 5, -5, 5, 0, 1), std::invalid_argument);
+        TS_ASSERT_THROWS(InversePerspectiveMapping(h, 200, 100, 5, 0, -5, 5, 0.05, 1), std::invalid_argument);
+
+        // The grid reaches 1 m behind the frame.
+        InversePerspectiveMapping ipm(h, 200, 100, -1, 5, -5, 5, 0.05, 3);
+        TS_ASSERT(ipm.getWidth() == 200);
+        TS_ASSERT(ipm.getHeight() == 120);
+
+        cv::Mat image(100, 200, CV_8UC1);
+        for (int32_t row = 0; row < image.rows; row++) {
+            for (int32_t col = 0; col < image.cols; col++) {
+                image.at<uint8_t>(row, col) = static_cast<uint8_t>(col);
+            }
+        }
+        cv::Mat grid(120, 200, CV_8UC1);
+        const uint8_t *data = grid.data;
+        TS_ASSERT(ipm.warp(image, grid));
+        TS_ASSERT(grid.data == data);
+        for (int32_t col = 0; col < 199; col++) {
+            TS_ASSERT_DELTA(grid.at<uint8_t>(50, col), col, 1);
+        }
+        // Cells outside the frame are black.
+        for (int32_t col = 0; col < 200; col++) {
+            TS_ASSERT(grid.at<uint8_t>(110, col) == 0);
+        }
+
+        cv::Mat small(50, 100, CV_8UC1);
+        TS_ASSERT(!ipm.warp(small, grid));
+
+        // Timing of a frame of a forward looking camera.
+        Eigen::Matrix3d forward;
+        forward << 0.0001, -0.03, 21.0,
+                   -0.02, 0.0001, 12.8,
+                   0.0, -0.004, 2.9;
+        InversePerspectiveMapping warp(forward, 1280, 720, 0, 40, -10, 10, 0.05, 4);
+        cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(50, 100, 150));
+        cv::Mat topDown;
+        warp.warp(frame, topDown);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < 10; i++) {
+            warp.warp(frame, topDown);
+        }
+        const int64_t duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        std::cout << std::endl << "Warp of 1280x720 into " << warp.getWidth() << "x" << warp.getHeight() << " in " << duration / 10 << " us" << std::endl;
+    }
+
+    void testSharedImageReader() {
+        const uint32_t WIDTH = 640;
+        const uint32_t HEIGHT = 480;
+        const uint32_t SIZE = WIDTH * HEIGHT * 3;
+        SeqLock seqLock(SIZE);
+        std::shared_ptr<odcore::wrapper::SharedMemory> sharedMemory(
+            odcore::wrapper::SharedMemoryFactory::createSharedMemory("camera-projection-test", seqLock.getSegmentSize()));
+        TS_ASSERT(sharedMemory->isValid());
+        TS_ASSERT(seqLock.initialize(static_cast<char *>(sharedMemory->getSharedMemory()), sharedMemory->getSize()));
+        seqLock.beginWrite();
+        memset(sharedMemory->getSharedMemory(), 42, SIZE);
+        seqLock.endWrite();
+
+        odcore::data::image::SharedImage si;
+        si.setName("camera-projection-test");
+        si.setWidth(WIDTH);
+        si.setHeight(HEIGHT);
+        si.setBytesPerPixel(3);
+        si.setSize(SIZE);
+
+        SharedImageReader reader;
+        TS_ASSERT(reader.getView().empty());
+        TS_ASSERT(!reader.beginRead());
+
+        // Per-frame overhead of attaching and allocating for every frame.
+        const uint32_t FRAMES = 1000;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            std::shared_ptr<odcore::wrapper::SharedMemory> attached(
+                odcore::wrapper::SharedMemoryFactory::attachToSharedMemory(si.getName()));
+            cv::Mat image(HEIGHT, WIDTH, CV_8UC3);
+            SeqLock perFrame(SIZE);
+            perFrame.attach(static_cast<char *>(attached->getSharedMemory()), attached->getSize());
+            perFrame.read(reinterpret_cast<char *>(image.data), SIZE);
+        }
+        const int64_t perFrame = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        // Cached attachment with a copy.
+        cv::Mat image;
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            TS_ASSERT(reader.attach(si));
+            TS_ASSERT(reader.copyTo(image));
+        }
+        const int64_t cached = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        TS_ASSERT(image.at<cv::Vec3b>(100, 100)[0] == 42);
+
+        // Cached attachment reading in place.
+        uint64_t sum = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < FRAMES; i++) {
+            TS_ASSERT(reader.attach(si));
+            TS_ASSERT(reader.beginRead());
+            sum += reader.getView().at<cv::Vec3b>(i % HEIGHT, i % WIDTH)[1];
+            TS_ASSERT(reader.endRead());
+        }
+        const int64_t inPlace = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+        TS_ASSERT(sum == 42 * FRAMES);
+        std::cout << std::endl << "Per frame of 640x480: attaching and copying " << perFrame / FRAMES
+                  << " us, copying " << cached / FRAMES << " us, reading in place " << inPlace / FRAMES << " us" << std::endl;
+        TS_ASSERT(reader.getNumberOfAttachments() == 1);
+        TS_ASSERT(reader.getView().data == reinterpret_cast<uint8_t *>(sharedMemory->getSharedMemory()));
+
+        // A frame changed by the writer while reading in place is detected.
+        TS_ASSERT(reader.beginRead());
+        seqLock.beginWrite();
+        seqLock.endWrite();
+        TS_ASSERT(!reader.endRead());
+
+        // Another geometry attaches again.
+        si.setWidth(320);
+        si.setSize(320 * HEIGHT * 3);
+        TS_ASSERT(reader.attach(si));
+        TS_ASSERT(reader.getNumberOfAttachments() == 2);
+        TS_ASSERT(reader.getView().cols == 320);
+
+        // Unknown shared memory is not valid.
+        odcore::data::image::SharedImage missing(si);
+        missing.setName("camera-projection-test-missing");
+        TS_ASSERT(!reader.attach(missing));
+        TS_ASSERT(!reader.copyTo(image));
+        TS_ASSERT(reader.attach(si));
+        TS_ASSERT(reader.getNumberOfAttachments() == 3);
+    }
+
+    void testGroundTargetCalibrator() {
+        using namespace opendlv::core::tool;
+        TS_ASSERT_THROWS(GroundTargetCalibrator(4, 4, 0.1, 0, 0, 0, 1, 0.01), std::invalid_argument);
+        TS_ASSERT_THROWS(GroundTargetCalibrator(6, 4, 0, 0, 0, 0, 1, 0.01), std::invalid_argument);
+
+        // 7x5 squares of 40 pixels, i.e., 6x4 inner corners from (200, 180) to (400, 300).
+        cv::Mat image(480, 640, CV_8UC3, cv::Scalar(255, 255, 255));
+        for (int32_t row = 0; row < 5; row++) {
+            for (int32_t col = 0; col < 7; col++) {
+                if ((row + col) % 2 == 0) {
+                    cv::rectangle(image, cv::Rect(160 + 40 * col, 140 + 40 * row, 40, 40), cv::Scalar(0, 0, 0), CV_FILLED);
+                }
+            }
+        }
+
+        GroundTargetCalibrator calibrator(6, 4, 0.1, 5.0, 1.0, 0, 3, 0.01);
+        Eigen::Matrix3d m;
+        double meanError = 0;
+        uint32_t inliers = 0;
+        TS_ASSERT(!calibrator.calibrate(m, meanError, inliers));
+        TS_ASSERT(!calibrator.addFrame(cv::Mat(480, 640, CV_8UC3, cv::Scalar(255, 255, 255))));
+        for (uint32_t i = 0; i < 3; i++) {
+            TS_ASSERT(!calibrator.isComplete());
+            TS_ASSERT(calibrator.addFrame(image));
+        }
+        TS_ASSERT(calibrator.isComplete());
+        TS_ASSERT(!calibrator.addFrame(image));
+        TS_ASSERT_EQUALS(calibrator.getNumberOfFrames(), 3u);
+
+        TS_ASSERT(calibrator.calibrate(m, meanError, inliers));
+        TS_ASSERT_EQUALS(inliers, 3u * 24u);
+        TS_ASSERT(meanError < 0.01);
+
+        // The bottom corner on either side is the origin of the target.
+        PixelProjector projector(m);
+        double left[2], right[2], top[2];
+        TS_ASSERT(projector.project(200, 300, left[0], left[1]));
+        TS_ASSERT(projector.project(400, 300, right[0], right[1]));
+        TS_ASSERT(projector.project(200, 180, top[0], top[1]));
+        const double originDistance = std::min(std::hypot(left[0] - 5.0, left[1] - 1.0), std::hypot(right[0] - 5.0, right[1] - 1.0));
+        TS_ASSERT(originDistance < 0.01);
+        TS_ASSERT_DELTA(std::hypot(left[0] - right[0], left[1] - right[1]), 0.5, 0.01);
+        TS_ASSERT_DELTA(std::hypot(top[0] - left[0], top[1] - left[1]), 0.3, 0.01);
+        TS_ASSERT_DELTA(std::hypot(top[0] - right[0], top[1] - right[1]), std::sqrt(0.34), 0.01);
+    }
+
+    void testReadMatrix() {
+        const std::string FILENAME = "camera-projection-test-pixel2world-matrix.csv";
+        TS_ASSERT_THROWS(PixelProjector::readMatrix(FILENAME), std::invalid_argument);
+        {
+            std::ofstream file(FILENAME);
+            file << "1 2 3 4 5 6 7 8 9";
+        }
+        const Eigen::Matrix3d m = PixelProjector::readMatrix(FILENAME);
+        TS_ASSERT(m(0, 1) == 2);
+        TS_ASSERT(m(2, 2) == 9);
+        {
+            Eigen::Matrix3d w;
+            w << 1e-5, -2.5, 3, 4, 5, 6, 7, 8, 0.123456789012;
+            PixelProjector::writeMatrix(FILENAME, w);
+            TS_ASSERT(PixelProjector::readMatrix(FILENAME).isApprox(w, 1e-12));
+        }
+        {
+            std::ofstream file(FILENAME);
+            file << "1 2 3 4 5 6 7 8";
+        }
+        TS_ASSERT_THROWS(PixelProjector::readMatrix(FILENAME), std::invalid_argument);
+        std::remove(FILENAME.c_str());
+    }
 };
 
 #endif
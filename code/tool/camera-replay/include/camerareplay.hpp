@@ -20,6 +20,7 @@
 #ifndef CORE_TOOL_CAMERAREPLAY_HPP_
 #define CORE_TOOL_CAMERAREPLAY_HPP_
 
+#include <chrono>
 #include <map>
 #include <memory>
 // #include <opendavinci/odcore/wrapper/Eigen.h>
@@ -31,6 +32,8 @@
 // #include "opencv2/imgproc/imgproc.hpp"
 // #include "opencv2/highgui/highgui.hpp"
 
+#include "frameindex.hpp"
+#include "replayclock.hpp"
 #include "videocapture.hpp"
 
 namespace opendlv {
@@ -51,8 +54,17 @@ class CameraReplay
 
   odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode body();
 
+  void replayByTicks();
+  void replayByTimeStamps();
+  void send(const odcore::data::image::SharedImage &si, const odcore::data::TimeStamp &sampleTimeStamp);
+  void warnIfLate(const uint64_t &lateFrames);
+
  private:
   std::unique_ptr<VideoCapture> m_videoCapture;
+  std::unique_ptr<ReplayClock> m_replayClock; // Set when pacing by time stamps.
+  uint32_t m_captureCounter;
+  uint64_t m_lateFrames;
+  std::chrono::steady_clock::time_point m_lastWarning;
 };
 
 } // tools
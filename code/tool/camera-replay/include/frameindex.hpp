@@ -0,0 +1,99 @@
+/**
+ * camera-replay - Tool to replay a video file as camera feed.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_FRAMEINDEX_HPP_
+#define CORE_TOOL_FRAMEINDEX_HPP_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class holds the presentation time stamps of all frames of a video
+ * file to map between times and frame numbers for seeking.
+ *
+ * The index is built by demuxing the file once and cached next to it as a
+ * text file: a header line, a line with the size and modification time of
+ * the video file to detect a stale index, and one presentation time stamp
+ * per frame and line in microseconds. If the file does not provide
+ * increasing presentation time stamps, they are derived from the frame
+ * rate.
+ */
+class FrameIndex
+{
+ public:
+  FrameIndex();
+  FrameIndex(FrameIndex const &) = delete;
+  FrameIndex &operator=(FrameIndex const &) = delete;
+  virtual ~FrameIndex();
+
+  /**
+   * @param videoFile Video file.
+   * @return Name of the cached index of the video file.
+   */
+  static std::string getIndexFilename(const std::string &videoFile);
+
+  /**
+   * This method loads the cached index of a video file.
+   *
+   * @param videoFile Video file.
+   * @return true if the index exists and matches the video file.
+   */
+  bool load(const std::string &videoFile);
+
+  /**
+   * This method builds the index of a video file and caches it.
+   *
+   * @param videoFile Video file.
+   * @return true if the video file could be read.
+   */
+  bool build(const std::string &videoFile);
+
+  uint32_t getNumberOfFrames() const;
+
+  /**
+   * @param number Number of the frame, starting at 0.
+   * @return Presentation time stamp of the frame in microseconds.
+   */
+  int64_t getPresentationTimeStamp(const uint32_t &number) const;
+
+  /**
+   * @param presentationTimeStamp Time in the file in microseconds.
+   * @return Number of the first frame at or after the time, or the number of frames.
+   */
+  uint32_t findFrame(const int64_t &presentationTimeStamp) const;
+
+ private:
+  static bool getFileStatus(const std::string &videoFile, std::string &status);
+
+ private:
+  std::vector<int64_t> m_presentationTimeStamps;
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
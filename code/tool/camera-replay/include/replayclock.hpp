@@ -0,0 +1,99 @@
+/**
+ * camera-replay - Tool to replay a video file as camera feed.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#ifndef CORE_TOOL_REPLAYCLOCK_HPP_
+#define CORE_TOOL_REPLAYCLOCK_HPP_
+
+#include <stdint.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+/**
+ * This class maps the frames of a video file to their original capture time
+ * and to the time at which they are due during the replay.
+ *
+ * The capture time of a frame is read from a sidecar file if given, else it
+ * is the presentation time stamp of the frame in the container added to a
+ * start time. The sidecar file has one capture time per frame and line, in
+ * microseconds since the epoch; empty lines and lines starting with '#' are
+ * ignored. Frames beyond the end of the sidecar file are placed by their
+ * presentation time stamp after the first entry.
+ *
+ * The first frame is due when it is first asked for; later frames are due
+ * at the difference of their capture times divided by the speed. A speed of
+ * 0 replays as fast as possible.
+ */
+class ReplayClock
+{
+ public:
+  /**
+   * Constructor.
+   *
+   * @param speed Replay speed relative to real time, 0 for as fast as possible.
+   * @param startTime Capture time of a presentation time stamp of 0 in microseconds since the epoch.
+   * @param timeStampFile Sidecar file with the capture times, empty for none.
+   */
+  ReplayClock(const double &speed, const int64_t &startTime, const std::string &timeStampFile);
+  ReplayClock(ReplayClock const &) = delete;
+  ReplayClock &operator=(ReplayClock const &) = delete;
+  virtual ~ReplayClock();
+
+  /**
+   * @param number Number of the frame in the file, starting at 0.
+   * @param presentationTimeStamp Presentation time stamp of the frame in microseconds.
+   * @return Capture time of the frame in microseconds since the epoch.
+   */
+  int64_t getCaptureTime(const uint64_t &number, const int64_t &presentationTimeStamp) const;
+
+  /**
+   * @param captureTime Capture time of a frame in microseconds since the epoch.
+   * @return Time at which the frame is due.
+   */
+  std::chrono::steady_clock::time_point getDueTime(const int64_t &captureTime);
+
+  /**
+   * This method makes the next frame due when it is first asked for.
+   */
+  void restart();
+
+  bool isAsFastAsPossible() const;
+  uint32_t getNumberOfTimeStamps() const;
+
+ private:
+  double m_speed;
+  int64_t m_startTime;
+  std::vector<int64_t> m_timeStamps; // Capture times from the sidecar file.
+
+  bool m_anchored;
+  std::chrono::steady_clock::time_point m_anchorDueTime;
+  int64_t m_anchorCaptureTime;
+};
+
+} // tools
+} // core
+} // opendlv
+
+#endif
@@ -23,8 +23,14 @@
 
 #include <stdint.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
 
 
 #include <opencv2/core/core.hpp>
@@ -33,42 +39,130 @@
 #include <opendavinci/GeneratedHeaders_OpenDaVINCI.h>
 #include <opendavinci/odcore/wrapper/SharedMemory.h>
 
+#include "FrameViewer.h"
+#include "SeqLock.h"
+
 
 namespace opendlv {
 namespace core {
 namespace tool {
 
+/**
+ * This class replays a video file into a shared memory segment.
+ *
+ * Frames are decoded on a background thread into a bounded queue ahead of
+ * the playback, so that a slow frame does not delay the publishing loop;
+ * capture() only copies the next decoded frame into the shared memory. A
+ * call that finds the queue empty before the end of the file counts as
+ * late, i.e., decoding fell behind real time.
+ *
+ * The shared frames are BGR of the geometry of the stream or of a requested
+ * one. Frames of another size or with 1 or 4 channels are resized and
+ * converted directly into the shared memory; each such geometry is reported
+ * once, and frames of other pixel formats are dropped.
+ *
+ * Each frame keeps its number in the file and its presentation time stamp.
+ * If the container does not provide increasing presentation time stamps,
+ * they are derived from the frame rate.
+ *
+ * A segment of the file can be replayed, optionally in a loop. Seeking to
+ * its first frame lets the decoder start at the preceding keyframe instead
+ * of decoding the file from the beginning.
+ */
 class VideoCapture
 {
  public:
-  VideoCapture(const std::string &sourcename, const std::string &filename, const uint32_t &width, const uint32_t &height, const bool &debug);
+  /**
+   * Frames of the file to replay.
+   */
+  struct Segment {
+    Segment();
+
+    uint32_t firstFrame;
+    uint32_t endFrame; // Exclusive, 0 for the end of the file.
+    bool loop;
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param sourcename Name of the shared memory segment.
+   * @param filename Video file.
+   * @param width Width of the shared frames, 0 for the width of the stream.
+   * @param height Height of the shared frames, 0 for the height of the stream.
+   * @param debug Show the frames on a separate thread.
+   * @param prefetch Number of frames decoded ahead, at least 1.
+   * @param segment Frames to replay.
+   */
+  VideoCapture(const std::string &sourcename, const std::string &filename, const uint32_t &width, const uint32_t &height, const bool &debug, const uint32_t &prefetch, const Segment &segment = Segment());
   VideoCapture(VideoCapture const &) = delete;
   VideoCapture &operator=(VideoCapture const &) = delete;
   virtual ~VideoCapture();
 
-  odcore::data::image::SharedImage capture();
+  /**
+   * This method copies the next decoded frame into the shared memory.
+   *
+   * @param si Meta information about the image.
+   * @param number Number of the frame in the file, starting at 0.
+   * @param presentationTimeStamp Presentation time stamp of the frame in microseconds.
+   * @return true if there was a decoded frame.
+   */
+  bool capture(odcore::data::image::SharedImage &si, uint64_t &number, int64_t &presentationTimeStamp);
+
+  /**
+   * This method returns the next decoded frame's number and presentation
+   * time stamp without capturing it. It does not count late frames.
+   *
+   * @param number Number of the frame in the file, starting at 0.
+   * @param presentationTimeStamp Presentation time stamp of the frame in microseconds.
+   * @return true if there was a decoded frame.
+   */
+  bool peek(uint64_t &number, int64_t &presentationTimeStamp);
+
+  /**
+   * @return true if all frames of the file were captured.
+   */
+  bool isAtEnd();
+
+  uint64_t getDecodedFrames() const;
+  uint64_t getLateFrames() const;
+  uint64_t getMismatchedFrames() const;
+  uint64_t getRejectedFrames() const;
+  uint32_t getWidth() const;
+  uint32_t getHeight() const;
 
  private:
   /**
   * This method is responsible to copy the image from the
-  * specific camera driver to the shared memory.
+  * specific camera driver to the shared memory, resizing it and
+  * converting its channels to BGR if needed.
   *
   * @param dest Pointer where to copy the data.
-  * @param size Number of bytes to copy.
+  * @param size Size of the destination in bytes.
   * @return true if the data was successfully copied.
   */
   virtual bool copyImageTo(char *dest, const uint32_t &size);
   virtual bool isValid() const;
-  virtual bool captureFrame();
+
+  void decode();
+
+  void reportGeometry(const std::string &action);
 
   const std::string getSourcename() const;
-  uint32_t getWidth() const;
-  uint32_t getHeight() const;
   uint32_t getSize() const;
 
  private:
+  struct Frame {
+    Frame(const cv::Mat &a_image, const uint64_t &a_number, const int64_t &a_presentationTimeStamp);
+
+    cv::Mat image;
+    uint64_t number;
+    int64_t presentationTimeStamp; // Microseconds.
+  };
+
   odcore::data::image::SharedImage m_sharedImage;
   std::shared_ptr<odcore::wrapper::SharedMemory> m_sharedMemory;
+  std::unique_ptr<SeqLock> m_seqLock;
 
   std::string m_sourcename;
   std::string m_filename;
@@ -76,9 +170,27 @@ class VideoCapture
   uint32_t m_height;
   uint32_t m_size;
 
-  std::unique_ptr<cv::VideoCapture> m_capture;
-  cv::Mat m_image;
-  bool m_debug;
+  std::unique_ptr<cv::VideoCapture> m_capture; // Used by the decoding thread only.
+  bool m_opened;
+  cv::Mat m_image; // Frame being copied.
+  cv::Mat m_converted; // Intermediate frame of the smaller of conversion and resizing.
+  std::string m_reportedGeometry;
+  std::unique_ptr<FrameViewer> m_viewer; // Only set when debugging.
+
+  Segment m_segment;
+  uint32_t m_capacity;
+  std::mutex m_mutex;
+  std::condition_variable m_condition;
+  std::deque<Frame> m_frames; // Decoded frames in playback order.
+  std::vector<cv::Mat> m_recycled; // Buffers of copied frames to decode into.
+  bool m_running;
+  bool m_endOfStream;
+  std::thread m_decoder;
+
+  std::atomic<uint64_t> m_decoded;
+  std::atomic<uint64_t> m_late;
+  std::atomic<uint64_t> m_mismatched;
+  std::atomic<uint64_t> m_rejected;
 };
 
 } // tools
@@ -18,9 +18,12 @@
  */
 
 #include <ctype.h>
+#include <chrono>
 #include <cstring>
 #include <iostream>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -39,6 +42,10 @@ CameraReplay::CameraReplay(int32_t const &a_argc, char **a_argv)
     : odcore::base::module::TimeTriggeredConferenceClientModule(
       a_argc, a_argv, "core-tool-camera-replay")
     , m_videoCapture()
+    , m_replayClock()
+    , m_captureCounter(0)
+    , m_lateFrames(0)
+    , m_lastWarning()
 {
 }
 
@@ -51,11 +58,99 @@ void CameraReplay::setUp()
   auto kv = getKeyValueConfiguration();
   const std::string SOURCENAME = kv.getValue<std::string>("core-tool-camera-replay.sourcename");
   const std::string FILEPATH = kv.getValue<std::string>("core-tool-camera-replay.filepath");
-  const uint32_t WIDTH = kv.getValue< uint32_t >("core-tool-camera-replay.width");
-  const uint32_t HEIGHT = kv.getValue< uint32_t >("core-tool-camera-replay.height");
+  // Geometry of the shared frames; 0 uses the geometry of the stream.
+  uint32_t WIDTH = 0;
+  uint32_t HEIGHT = 0;
+  try {
+    WIDTH = kv.getValue< uint32_t >("core-tool-camera-replay.width");
+    HEIGHT = kv.getValue< uint32_t >("core-tool-camera-replay.height");
+  } catch (...) {
+  }
   const bool DEBUG = kv.getValue< bool >("core-tool-camera-replay.debug");
+  // Number of frames decoded ahead of the playback.
+  uint32_t PREFETCH = 8;
+  try {
+    PREFETCH = kv.getValue< uint32_t >("core-tool-camera-replay.prefetch");
+  } catch (...) {
+  }
+
+  // Either one frame per module tick ("ticks") or paced by the time stamps
+  // in the file ("timestamps").
+  std::string PACING = "ticks";
+  try {
+    PACING = kv.getValue<std::string>("core-tool-camera-replay.pacing");
+  } catch (...) {
+  }
+  if (PACING == "timestamps") {
+    // Speed relative to real time; 0 replays as fast as possible.
+    double SPEED = 1.0;
+    try {
+      SPEED = kv.getValue<double>("core-tool-camera-replay.speed");
+    } catch (...) {
+    }
+    // Capture times from a sidecar file, one per frame in microseconds.
+    std::string TIMESTAMPS;
+    try {
+      TIMESTAMPS = kv.getValue<std::string>("core-tool-camera-replay.timestamps");
+    } catch (...) {
+    }
+    // Capture time of the start of the file in microseconds since the epoch.
+    int64_t STARTTIME = odcore::data::TimeStamp().toMicroseconds();
+    try {
+      STARTTIME = kv.getValue<int64_t>("core-tool-camera-replay.starttime");
+    } catch (...) {
+    }
+    m_replayClock = std::unique_ptr<ReplayClock>(new ReplayClock(SPEED, STARTTIME, TIMESTAMPS));
+    if (!TIMESTAMPS.empty()) {
+      std::cout << "[" << getName() << "] Read " << m_replayClock->getNumberOfTimeStamps() << " time stamps from '" << TIMESTAMPS << "'." << std::endl;
+    }
+  } else if (PACING != "ticks") {
+    throw std::invalid_argument("Invalid pacing '" + PACING + "'! Use ticks or timestamps");
+  }
+
+  // Segment to replay, by frame or by time in seconds into the file.
+  VideoCapture::Segment segment;
+  try {
+    segment.firstFrame = kv.getValue<uint32_t>("core-tool-camera-replay.segment.startframe");
+  } catch (...) {
+  }
+  try {
+    segment.endFrame = kv.getValue<uint32_t>("core-tool-camera-replay.segment.endframe");
+  } catch (...) {
+  }
+  try {
+    segment.loop = kv.getValue<bool>("core-tool-camera-replay.segment.loop");
+  } catch (...) {
+  }
+  double STARTTIME = -1;
+  double ENDTIME = -1;
+  try {
+    STARTTIME = kv.getValue<double>("core-tool-camera-replay.segment.starttime");
+  } catch (...) {
+  }
+  try {
+    ENDTIME = kv.getValue<double>("core-tool-camera-replay.segment.endtime");
+  } catch (...) {
+  }
+  if ((STARTTIME >= 0) || (ENDTIME >= 0)) {
+    FrameIndex index;
+    if (!index.load(FILEPATH)) {
+      std::cout << "[" << getName() << "] Building the frame index of '" << FILEPATH << "'." << std::endl;
+      if (!index.build(FILEPATH)) {
+        throw std::invalid_argument("Could not index '" + FILEPATH + "' to seek by time");
+      }
+    }
+    if (STARTTIME >= 0) {
+      segment.firstFrame = index.findFrame(static_cast<int64_t>(STARTTIME * 1000000.0));
+    }
+    if (ENDTIME >= 0) {
+      segment.endFrame = index.findFrame(static_cast<int64_t>(ENDTIME * 1000000.0));
+    }
+    std::cout << "[" << getName() << "] Replaying frames " << segment.firstFrame << " to " << segment.endFrame
+              << " of " << index.getNumberOfFrames() << "." << std::endl;
+  }
 
-  m_videoCapture = std::unique_ptr<VideoCapture>(new VideoCapture(SOURCENAME, FILEPATH, WIDTH, HEIGHT, DEBUG));
+  m_videoCapture = std::unique_ptr<VideoCapture>(new VideoCapture(SOURCENAME, FILEPATH, WIDTH, HEIGHT, DEBUG, PREFETCH, segment));
   if (m_videoCapture.get() == NULL) {
     std::cerr << "[" << getName() << "] No valid video file defined." << std::endl;
   }
@@ -67,25 +162,122 @@ void CameraReplay::tearDown()
 
 
 odcore::data::dmcp::ModuleExitCodeMessage::ModuleExitCode CameraReplay::body(){
-  uint32_t captureCounter = 0;
+  m_captureCounter = 0;
+  m_lateFrames = 0;
+  m_lastWarning = std::chrono::steady_clock::now();
+  if (m_replayClock.get() != NULL) {
+    replayByTimeStamps();
+  } else {
+    replayByTicks();
+  }
+  std::cout << "[" << getName() << "] Captured " << m_captureCounter << " frames." << std::endl;
+  if (m_videoCapture.get() != NULL) {
+    std::cout << "[" << getName() << "] Decoded " << m_videoCapture->getDecodedFrames() << " frames, "
+              << m_videoCapture->getLateFrames() << " times no frame was ready in time." << std::endl;
+    if ((m_videoCapture->getMismatchedFrames() > 0) || (m_videoCapture->getRejectedFrames() > 0)) {
+      std::cout << "[" << getName() << "] Converted " << m_videoCapture->getMismatchedFrames() << " frames to "
+                << m_videoCapture->getWidth() << "x" << m_videoCapture->getHeight() << " BGR, dropped "
+                << m_videoCapture->getRejectedFrames() << " frames of unsupported pixel formats." << std::endl;
+    }
+  }
+  return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
+}
+
+void CameraReplay::replayByTicks()
+{
   while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
   odcore::data::dmcp::ModuleStateMessage::RUNNING){
-    if (m_videoCapture.get() != NULL) {
-      // Capture frame.
-      odcore::data::image::SharedImage si = m_videoCapture->capture();
+    odcore::data::image::SharedImage si;
+    uint64_t number = 0;
+    int64_t presentationTimeStamp = 0;
+    // Copy the next decoded frame.
+    if ((m_videoCapture.get() != NULL) && m_videoCapture->capture(si, number, presentationTimeStamp)) {
       odcore::data::TimeStamp now;
+      send(si, now);
+    }
+    if (m_videoCapture.get() != NULL) {
+      warnIfLate(m_videoCapture->getLateFrames());
+    }
+  }
+}
 
-      // Create container with meta-information about captured frame.
-      odcore::data::Container c(si);
-      c.setSampleTimeStamp(now);
+void CameraReplay::replayByTimeStamps()
+{
+  // Frames due within a time slice are sent at their due time during it.
+  const std::chrono::microseconds PERIOD(static_cast<int64_t>(1000000.0 / getFrequency()));
+  uint64_t behindFrames = 0;
+  uint64_t previousNumber = 0;
+  while (getModuleStateAndWaitForRemainingTimeInTimeslice() ==
+  odcore::data::dmcp::ModuleStateMessage::RUNNING){
+    if ((m_videoCapture.get() == NULL) || m_videoCapture->isAtEnd()) {
+      break;
+    }
+    const std::chrono::steady_clock::time_point endOfSlice = std::chrono::steady_clock::now() + PERIOD;
+    uint64_t number = 0;
+    int64_t presentationTimeStamp = 0;
+    while (true) {
+      if (!m_videoCapture->peek(number, presentationTimeStamp)) {
+        // Wait for the decoder rather than for the next time slice.
+        if (m_replayClock->isAsFastAsPossible() && (std::chrono::steady_clock::now() < endOfSlice) && !m_videoCapture->isAtEnd()) {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          continue;
+        }
+        break;
+      }
+      // A looping segment starts over in real time.
+      if (number < previousNumber) {
+        m_replayClock->restart();
+      }
+      previousNumber = number;
+      const int64_t captureTime = m_replayClock->getCaptureTime(number, presentationTimeStamp);
+      const std::chrono::steady_clock::time_point dueTime = m_replayClock->getDueTime(captureTime);
+      const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+      if (m_replayClock->isAsFastAsPossible() ? (now >= endOfSlice) : (dueTime >= endOfSlice)) {
+        break;
+      }
+      if (dueTime > now) {
+        std::this_thread::sleep_until(dueTime);
+      } else if (now - dueTime > PERIOD) {
+        behindFrames++;
+      }
 
-      // Share container for recording.
-      getConference().send(c);
-      captureCounter++;
+      odcore::data::image::SharedImage si;
+      if (m_videoCapture->capture(si, number, presentationTimeStamp)) {
+        // Stamp the container with the original capture time.
+        const odcore::data::TimeStamp sampleTimeStamp(static_cast<int32_t>(captureTime / 1000000), static_cast<int32_t>(captureTime % 1000000));
+        send(si, sampleTimeStamp);
+      }
     }
+    warnIfLate(behindFrames);
+  }
+  if ((m_videoCapture.get() != NULL) && m_videoCapture->isAtEnd()) {
+    std::cout << "[" << getName() << "] Reached the end of the file." << std::endl;
+  }
+  if (behindFrames > 0) {
+    std::cout << "[" << getName() << "] " << behindFrames << " frames were sent more than one time slice after their time." << std::endl;
+  }
+}
+
+void CameraReplay::send(const odcore::data::image::SharedImage &si, const odcore::data::TimeStamp &sampleTimeStamp)
+{
+  // Create container with meta-information about captured frame.
+  odcore::data::Container c(si);
+  c.setSampleTimeStamp(sampleTimeStamp);
+
+  // Share container for recording.
+  getConference().send(c);
+  m_captureCounter++;
+}
+
+void CameraReplay::warnIfLate(const uint64_t &lateFrames)
+{
+  // Warn at most once per second.
+  if ((lateFrames > m_lateFrames)
+      && (std::chrono::steady_clock::now() - m_lastWarning >= std::chrono::seconds(1))) {
+    m_lastWarning = std::chrono::steady_clock::now();
+    m_lateFrames = lateFrames;
+    std::cerr << "[" << getName() << "] Replay is behind real time; " << lateFrames << " frames were late." << std::endl;
   }
-  std::cout << "[" << getName() << "] Captured " << captureCounter << " frames." << std::endl;
-  return odcore::data::dmcp::ModuleExitCodeMessage::OKAY;
 }
 
 } // tool
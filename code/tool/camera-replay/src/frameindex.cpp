@@ -0,0 +1,135 @@
+/**
+ * camera-replay - Tool to replay a video file as camera feed.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <opencv2/highgui/highgui.hpp>
+
+#include "frameindex.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+namespace {
+const std::string HEADER = "# camera-replay frame index 1";
+}
+
+FrameIndex::FrameIndex()
+  : m_presentationTimeStamps()
+{
+}
+
+FrameIndex::~FrameIndex()
+{
+}
+
+std::string FrameIndex::getIndexFilename(const std::string &videoFile) {
+  return videoFile + ".index";
+}
+
+bool FrameIndex::getFileStatus(const std::string &videoFile, std::string &status) {
+  struct stat s;
+  if (0 != ::stat(videoFile.c_str(), &s)) {
+    return false;
+  }
+  std::stringstream sstr;
+  sstr << s.st_size << " " << s.st_mtime;
+  status = sstr.str();
+  return true;
+}
+
+bool FrameIndex::load(const std::string &videoFile) {
+  m_presentationTimeStamps.clear();
+  std::string status;
+  if (!getFileStatus(videoFile, status)) {
+    return false;
+  }
+  std::ifstream in(getIndexFilename(videoFile).c_str());
+  std::string header;
+  std::string indexedStatus;
+  if (!std::getline(in, header) || (header != HEADER) || !std::getline(in, indexedStatus) || (indexedStatus != status)) {
+    return false;
+  }
+  int64_t presentationTimeStamp = 0;
+  while (in >> presentationTimeStamp) {
+    m_presentationTimeStamps.push_back(presentationTimeStamp);
+  }
+  if (!in.eof()) {
+    m_presentationTimeStamps.clear();
+    return false;
+  }
+  return true;
+}
+
+bool FrameIndex::build(const std::string &videoFile) {
+  m_presentationTimeStamps.clear();
+  std::string status;
+  cv::VideoCapture capture(videoFile);
+  if (!getFileStatus(videoFile, status) || !capture.isOpened()) {
+    return false;
+  }
+
+  // grab() demuxes a frame without converting it.
+  bool increasing = true;
+  while (capture.grab()) {
+    const int64_t presentationTimeStamp = static_cast<int64_t>(std::llround(capture.get(CV_CAP_PROP_POS_MSEC) * 1000.0));
+    increasing = increasing && (m_presentationTimeStamps.empty() || (presentationTimeStamp > m_presentationTimeStamps.back()));
+    m_presentationTimeStamps.push_back(presentationTimeStamp);
+  }
+  const double FPS = capture.get(CV_CAP_PROP_FPS);
+  if (!increasing && (FPS > 0)) {
+    for (uint32_t i = 0; i < m_presentationTimeStamps.size(); i++) {
+      m_presentationTimeStamps[i] = static_cast<int64_t>(std::llround(i * 1000000.0 / FPS));
+    }
+  }
+
+  std::ofstream out(getIndexFilename(videoFile).c_str());
+  out << HEADER << std::endl << status << std::endl;
+  for (uint32_t i = 0; i < m_presentationTimeStamps.size(); i++) {
+    out << m_presentationTimeStamps[i] << std::endl;
+  }
+  if (!out.good()) {
+    std::cerr << "[tools-camerareplay] Could not cache the frame index in '" << getIndexFilename(videoFile) << "'." << std::endl;
+  }
+  return true;
+}
+
+uint32_t FrameIndex::getNumberOfFrames() const {
+  return static_cast<uint32_t>(m_presentationTimeStamps.size());
+}
+
+int64_t FrameIndex::getPresentationTimeStamp(const uint32_t &number) const {
+  return m_presentationTimeStamps.at(number);
+}
+
+uint32_t FrameIndex::findFrame(const int64_t &presentationTimeStamp) const {
+  return static_cast<uint32_t>(std::lower_bound(m_presentationTimeStamps.begin(), m_presentationTimeStamps.end(), presentationTimeStamp) - m_presentationTimeStamps.begin());
+}
+
+} // tool
+} // core
+} // opendlv
@@ -0,0 +1,109 @@
+/**
+ * camera-replay - Tool to replay a video file as camera feed.
+ * Copyright (C) 2016 Chalmers Revere
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "replayclock.hpp"
+
+namespace opendlv {
+namespace core {
+namespace tool {
+
+
+ReplayClock::ReplayClock(const double &speed, const int64_t &startTime, const std::string &timeStampFile)
+  : m_speed(speed)
+  , m_startTime(startTime)
+  , m_timeStamps()
+  , m_anchored(false)
+  , m_anchorDueTime()
+  , m_anchorCaptureTime(0)
+{
+  if (!(speed >= 0)) {
+    throw std::invalid_argument("Replay speed must not be negative");
+  }
+  if (!timeStampFile.empty()) {
+    std::ifstream in(timeStampFile.c_str());
+    if (!in.good()) {
+      throw std::invalid_argument("Could not open time stamp file '" + timeStampFile + "'");
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+      std::stringstream sstr(line);
+      std::string token;
+      if (!(sstr >> token) || (token[0] == '#')) {
+        continue;
+      }
+      std::stringstream value(token);
+      int64_t timeStamp = 0;
+      if (!(value >> timeStamp) || !value.eof()) {
+        throw std::invalid_argument("Invalid time stamp '" + token + "' in '" + timeStampFile + "'");
+      }
+      m_timeStamps.push_back(timeStamp);
+    }
+  }
+}
+
+ReplayClock::~ReplayClock()
+{
+}
+
+int64_t ReplayClock::getCaptureTime(const uint64_t &number, const int64_t &presentationTimeStamp) const {
+  if (number < m_timeStamps.size()) {
+    return m_timeStamps[number];
+  }
+  if (!m_timeStamps.empty()) {
+    return m_timeStamps.front() + presentationTimeStamp;
+  }
+  return m_startTime + presentationTimeStamp;
+}
+
+std::chrono::steady_clock::time_point ReplayClock::getDueTime(const int64_t &captureTime) {
+  if (!m_anchored) {
+    m_anchored = true;
+    m_anchorDueTime = std::chrono::steady_clock::now();
+    m_anchorCaptureTime = captureTime;
+  }
+  if (isAsFastAsPossible()) {
+    return m_anchorDueTime;
+  }
+  // Frames that are out of order are due immediately.
+  const double offset = std::max(0.0, static_cast<double>(captureTime - m_anchorCaptureTime) / m_speed);
+  return m_anchorDueTime + std::chrono::microseconds(static_cast<int64_t>(std::llround(offset)));
+}
+
+void ReplayClock::restart() {
+  m_anchored = false;
+}
+
+bool ReplayClock::isAsFastAsPossible() const {
+  return (m_speed <= 0);
+}
+
+uint32_t ReplayClock::getNumberOfTimeStamps() const {
+  return static_cast<uint32_t>(m_timeStamps.size());
+}
+
+} // tool
+} // core
+} // opendlv
@@ -17,9 +17,14 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  */
 
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
 
 
+#include <opencv2/imgproc/imgproc.hpp>
 #include <opendavinci/odcore/base/Lock.h>
 #include <opendavinci/odcore/wrapper/SharedMemoryFactory.h>
 
@@ -29,43 +34,114 @@ namespace opendlv {
 namespace core {
 namespace tool {
 
+namespace {
+// Showing more frames per second adds nothing but copies.
+const uint32_t VIEWER_FREQUENCY = 10;
+}
+
+VideoCapture::Frame::Frame(const cv::Mat &a_image, const uint64_t &a_number, const int64_t &a_presentationTimeStamp)
+  : image(a_image)
+  , number(a_number)
+  , presentationTimeStamp(a_presentationTimeStamp)
+{
+}
 
-VideoCapture::VideoCapture(const std::string &sourcename, const std::string &filepath, const uint32_t &width, const uint32_t &height, const bool &debug)
+VideoCapture::Segment::Segment()
+  : firstFrame(0)
+  , endFrame(0)
+  , loop(false)
+{
+}
+
+VideoCapture::VideoCapture(const std::string &sourcename, const std::string &filepath, const uint32_t &width, const uint32_t &height, const bool &debug, const uint32_t &prefetch, const Segment &segment)
   : m_sharedImage()
   , m_sharedMemory()
+  , m_seqLock()
   , m_sourcename(sourcename)
   , m_filename(filepath)
   , m_width(width)
   , m_height(height)
   , m_size(0)
   , m_capture(nullptr)
+  , m_opened(false)
   , m_image()
-  , m_debug(debug)
+  , m_converted()
+  , m_reportedGeometry()
+  , m_viewer()
+  , m_segment(segment)
+  , m_capacity(prefetch)
+  , m_mutex()
+  , m_condition()
+  , m_frames()
+  , m_recycled()
+  , m_running(true)
+  , m_endOfStream(false)
+  , m_decoder()
+  , m_decoded(0)
+  , m_late(0)
+  , m_mismatched(0)
+  , m_rejected(0)
 {
+  if (prefetch == 0) {
+    throw std::invalid_argument("At least one frame must be decoded ahead");
+  }
+  if ((segment.endFrame > 0) && (segment.endFrame <= segment.firstFrame)) {
+    throw std::invalid_argument("The segment to replay is empty");
+  }
+  if (debug) {
+    m_viewer.reset(new FrameViewer("[Video feed]", VIEWER_FREQUENCY));
+  }
 
-  const uint8_t BPP = 3;
-  m_size = width * height * BPP;
+  m_capture.reset(new cv::VideoCapture(filepath));
+  m_opened = m_capture->isOpened();
+  if (m_opened) {
+    // The geometry of the stream is used unless another one is requested.
+    const uint32_t STREAM_WIDTH = static_cast<uint32_t>(m_capture->get(CV_CAP_PROP_FRAME_WIDTH));
+    const uint32_t STREAM_HEIGHT = static_cast<uint32_t>(m_capture->get(CV_CAP_PROP_FRAME_HEIGHT));
+    m_width = (width > 0) ? width : STREAM_WIDTH;
+    m_height = (height > 0) ? height : STREAM_HEIGHT;
+    std::cout << "[tools-camerareplay] Successfully opened '"<< filepath << "' (" << STREAM_WIDTH << "x" << STREAM_HEIGHT << ")." << std::endl;
+    if ((m_width != STREAM_WIDTH) || (m_height != STREAM_HEIGHT)) {
+      std::cout << "[tools-camerareplay] Resizing frames to " << m_width << "x" << m_height << "." << std::endl;
+    }
+  } else {
+    std::cerr << "[tools-camerareplay] Could not open file: '" << filepath << "'" << std::endl;
+  }
 
-  m_sharedMemory = odcore::wrapper::SharedMemoryFactory::createSharedMemory(sourcename, m_size);
+  // Frames are shared as BGR.
+  const uint8_t BPP = 3;
+  m_size = m_width * m_height * BPP;
+  if (m_size > 0) {
+    // The segment is extended by the trailer of the sequence lock.
+    m_seqLock.reset(new SeqLock(m_size));
+    m_sharedMemory = odcore::wrapper::SharedMemoryFactory::createSharedMemory(sourcename, m_seqLock->getSegmentSize());
+    if (m_sharedMemory.get() && m_sharedMemory->isValid()) {
+      m_seqLock->initialize(static_cast<char*>(m_sharedMemory->getSharedMemory()), m_sharedMemory->getSize());
+    }
+  }
   m_sharedImage.setName(sourcename);
   m_sharedImage.setSize(m_size);
-  m_sharedImage.setWidth(width);
-  m_sharedImage.setHeight(height);
-  //Is the BPP really 3?, isn't it channels per pixels?
+  m_sharedImage.setWidth(m_width);
+  m_sharedImage.setHeight(m_height);
   m_sharedImage.setBytesPerPixel(BPP);
 
-  m_capture.reset(new cv::VideoCapture(filepath));
-  if (m_capture->isOpened()) {
-    m_capture->set(CV_CAP_PROP_FRAME_WIDTH, width);
-    m_capture->set(CV_CAP_PROP_FRAME_HEIGHT, height);
-    std::cout << "[tools-camerareplay] Successfully opened '"<< filepath << "'." << std::endl;
-  } else {
-    std::cerr << "[tools-camerareplay] Could not open file: '" << filepath << "'" << std::endl;
+  if (m_opened) {
+    // One buffer per queued frame, one being decoded, and one being copied.
+    m_recycled.resize(m_capacity + 2);
+    m_decoder = std::thread(&VideoCapture::decode, this);
   }
 }
 
 VideoCapture::~VideoCapture()
 {
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_running = false;
+  }
+  m_condition.notify_all();
+  if (m_decoder.joinable()) {
+    m_decoder.join();
+  }
   if (m_capture != nullptr) {
     m_capture->release();
     m_capture = nullptr;
@@ -90,41 +166,182 @@ uint32_t VideoCapture::getSize() const {
 }
 
 bool VideoCapture::isValid() const {
-  return ((m_capture != nullptr) && m_capture->isOpened());
+  return m_opened;
 }
 
-odcore::data::image::SharedImage VideoCapture::capture() {
-  if (isValid()) {
-    if (captureFrame()) {
-      if (m_sharedMemory.get() && m_sharedMemory->isValid()) {
-        odcore::base::Lock l(m_sharedMemory);
-        copyImageTo(static_cast<char*>(m_sharedMemory->getSharedMemory()), m_size);
+uint64_t VideoCapture::getDecodedFrames() const {
+  return m_decoded.load(std::memory_order_relaxed);
+}
+
+uint64_t VideoCapture::getLateFrames() const {
+  return m_late.load(std::memory_order_relaxed);
+}
+
+bool VideoCapture::isAtEnd() {
+  std::lock_guard<std::mutex> l(m_mutex);
+  return (!m_opened || (m_endOfStream && m_frames.empty()));
+}
+
+void VideoCapture::decode() {
+  const double FPS = m_capture->get(CV_CAP_PROP_FPS);
+  bool hasPresentationTimeStamps = true;
+  int64_t previousPresentationTimeStamp = -1;
+  uint64_t number = m_segment.firstFrame;
+  if (number > 0) {
+    m_capture->set(CV_CAP_PROP_POS_FRAMES, number);
+  }
+  cv::Mat image;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> l(m_mutex);
+      while (m_running && (m_frames.size() >= m_capacity)) {
+        m_condition.wait(l);
+      }
+      if (!m_running) {
+        return;
+      }
+      if (image.empty() && !m_recycled.empty()) {
+        image = m_recycled.back();
+        m_recycled.pop_back();
+      }
+    }
+
+    // Decoding into a recycled buffer of the same size does not allocate.
+    const bool endOfSegment = (m_segment.endFrame > 0) && (number >= m_segment.endFrame);
+    if (endOfSegment || !m_capture->read(image)) {
+      // Restart a segment that had at least one frame.
+      if (m_segment.loop && (number > m_segment.firstFrame)) {
+        m_capture->set(CV_CAP_PROP_POS_FRAMES, m_segment.firstFrame);
+        number = m_segment.firstFrame;
+        previousPresentationTimeStamp = -1;
+        continue;
       }
+      std::lock_guard<std::mutex> l(m_mutex);
+      m_endOfStream = true;
+      return;
+    }
+    int64_t presentationTimeStamp = static_cast<int64_t>(std::llround(m_capture->get(CV_CAP_PROP_POS_MSEC) * 1000.0));
+    if (hasPresentationTimeStamps && (presentationTimeStamp <= previousPresentationTimeStamp) && (FPS > 0)) {
+      std::cerr << "[tools-camerareplay] '" << m_filename << "' has no increasing time stamps; using " << FPS << " frames per second." << std::endl;
+      hasPresentationTimeStamps = false;
     }
+    if (!hasPresentationTimeStamps) {
+      presentationTimeStamp = static_cast<int64_t>(std::llround(number * 1000000.0 / FPS));
+    }
+    previousPresentationTimeStamp = presentationTimeStamp;
+
+    std::lock_guard<std::mutex> l(m_mutex);
+    m_frames.push_back(Frame(image, number++, presentationTimeStamp));
+    image = cv::Mat();
+    m_decoded.fetch_add(1, std::memory_order_relaxed);
   }
-  return m_sharedImage;
 }
 
-bool VideoCapture::captureFrame() {
+bool VideoCapture::peek(uint64_t &number, int64_t &presentationTimeStamp) {
+  std::lock_guard<std::mutex> l(m_mutex);
+  if (m_frames.empty()) {
+    return false;
+  }
+  number = m_frames.front().number;
+  presentationTimeStamp = m_frames.front().presentationTimeStamp;
+  return true;
+}
+
+bool VideoCapture::capture(odcore::data::image::SharedImage &si, uint64_t &number, int64_t &presentationTimeStamp) {
+  si = m_sharedImage;
+  if (!isValid()) {
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> l(m_mutex);
+    if (m_frames.empty()) {
+      if (!m_endOfStream) {
+        m_late.fetch_add(1, std::memory_order_relaxed);
+      }
+      return false;
+    }
+    m_recycled.push_back(m_image);
+    m_image = m_frames.front().image;
+    number = m_frames.front().number;
+    presentationTimeStamp = m_frames.front().presentationTimeStamp;
+    m_frames.pop_front();
+  }
+  m_condition.notify_one();
+
   bool retVal = false;
-  if (m_capture != nullptr && m_capture->read(m_image)) {
-    retVal = true;
+  if (m_sharedMemory.get() && m_sharedMemory->isValid()) {
+    odcore::base::Lock l(m_sharedMemory);
+    m_seqLock->beginWrite();
+    retVal = copyImageTo(static_cast<char*>(m_sharedMemory->getSharedMemory()), m_size);
+    m_seqLock->endWrite();
   }
   return retVal;
 }
 
 
 bool VideoCapture::copyImageTo(char *dest, const uint32_t &size) {
-  bool retVal = false;
-  if ((dest != NULL) && (size > 0)) {
-    ::memcpy(dest, m_image.data, size);
-    if (m_debug) {
-      cv::imshow("[Video feed]", m_image);
-      cv::waitKey(10);
+  if ((dest == NULL) || (size == 0) || (size < m_width * m_height * 3) || m_image.empty()) {
+    return false;
+  }
+  const int32_t CHANNELS = m_image.channels();
+  if ((m_image.depth() != CV_8U) || ((CHANNELS != 1) && (CHANNELS != 3) && (CHANNELS != 4))) {
+    reportGeometry("has an unsupported pixel format; dropping it");
+    m_rejected.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  // The frame is written directly into the shared memory; the functions
+  // below do not reallocate a destination of the right size and type, and
+  // they follow the row stride of the decoded frame.
+  cv::Mat out(m_height, m_width, CV_8UC3, dest);
+  const bool SAME_SIZE = (static_cast<uint32_t>(m_image.cols) == m_width) && (static_cast<uint32_t>(m_image.rows) == m_height);
+  if (SAME_SIZE && (CHANNELS == 3)) {
+    m_image.copyTo(out);
+  } else {
+    reportGeometry("is converted");
+    m_mismatched.fetch_add(1, std::memory_order_relaxed);
+    const int32_t CODE = (CHANNELS == 1) ? CV_GRAY2BGR : CV_BGRA2BGR;
+    if (SAME_SIZE) {
+      cv::cvtColor(m_image, out, CODE);
+    } else {
+      const bool SHRINK = (static_cast<uint32_t>(m_image.cols) >= m_width) && (static_cast<uint32_t>(m_image.rows) >= m_height);
+      const int32_t INTERPOLATION = SHRINK ? cv::INTER_AREA : cv::INTER_LINEAR;
+      if (CHANNELS == 3) {
+        cv::resize(m_image, out, out.size(), 0, 0, INTERPOLATION);
+      } else if (m_image.total() > out.total()) {
+        // Convert the fewer pixels of the resized frame.
+        cv::resize(m_image, m_converted, out.size(), 0, 0, INTERPOLATION);
+        cv::cvtColor(m_converted, out, CODE);
+      } else {
+        cv::cvtColor(m_image, m_converted, CODE);
+        cv::resize(m_converted, out, out.size(), 0, 0, INTERPOLATION);
+      }
     }
-    retVal = true;
   }
-  return retVal;
+  if (m_viewer.get() != nullptr) {
+    m_viewer->offer(out);
+  }
+  return true;
+}
+
+void VideoCapture::reportGeometry(const std::string &action) {
+  std::stringstream sstr;
+  sstr << m_image.cols << "x" << m_image.rows << "x" << m_image.channels() << " depth " << m_image.depth();
+  // Report each geometry once.
+  if (sstr.str() != m_reportedGeometry) {
+    m_reportedGeometry = sstr.str();
+    std::cerr << "[tools-camerareplay] Frame of '" << m_filename << "' is " << m_image.cols << "x" << m_image.rows
+              << " with " << m_image.channels() << " channels and depth " << m_image.depth() << " instead of "
+              << m_width << "x" << m_height << " BGR and " << action << "." << std::endl;
+  }
+}
+
+uint64_t VideoCapture::getMismatchedFrames() const {
+  return m_mismatched.load(std::memory_order_relaxed);
+}
+
+uint64_t VideoCapture::getRejectedFrames() const {
+  return m_rejected.load(std::memory_order_relaxed);
 }
 
 } // tool
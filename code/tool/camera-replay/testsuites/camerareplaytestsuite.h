@@ -22,8 +22,38 @@
 
 #include "cxxtest/TestSuite.h"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
 // Include local header files.
 #include "../include/camerareplay.hpp"
+#include "../include/frameindex.hpp"
+#include "../include/replayclock.hpp"
+#include "../include/videocapture.hpp"
+
+using namespace opendlv::core::tool;
+
+/**
+ * This function writes a short MJPEG video.
+ */
+inline bool writeTestVideo(const std::string &filename, const uint32_t &frames) {
+  cv::VideoWriter writer(filename, CV_FOURCC('M', 'J', 'P', 'G'), 25, cv::Size(64, 48));
+  if (!writer.isOpened()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < frames; i++) {
+    cv::Mat frame(48, 64, CV_8UC3, cv::Scalar(i * 10, 100, 200));
+    writer << frame;
+  }
+  return true;
+}
 
 class ProxySickTest : public CxxTest::TestSuite {
    public:
@@ -34,6 +64,205 @@ class ProxySickTest : public CxxTest::TestSuite {
     void testApplication() {
         TS_ASSERT(true);
     }
+
+    void testPrefetch() {
+        const std::string FILENAME = "camera-replay-test.avi";
+        if (!writeTestVideo(FILENAME, 20)) {
+            TS_SKIP("No MJPEG video encoder available");
+            return;
+        }
+        TS_ASSERT_THROWS(VideoCapture("camera-replay-test", FILENAME, 64, 48, false, 0), std::invalid_argument);
+
+        VideoCapture videoCapture("camera-replay-test", FILENAME, 64, 48, false, 4);
+        odcore::data::image::SharedImage si;
+        uint32_t frames = 0;
+        uint64_t number = 0;
+        int64_t presentationTimeStamp = 0;
+        int64_t previousPresentationTimeStamp = -1;
+        for (uint32_t i = 0; (i < 1000) && !videoCapture.isAtEnd(); i++) {
+            uint64_t nextNumber = 0;
+            int64_t nextPresentationTimeStamp = 0;
+            const bool ready = videoCapture.peek(nextNumber, nextPresentationTimeStamp);
+            if (videoCapture.capture(si, number, presentationTimeStamp)) {
+                TS_ASSERT(ready);
+                TS_ASSERT(number == frames);
+                TS_ASSERT(nextNumber == number);
+                TS_ASSERT(nextPresentationTimeStamp == presentationTimeStamp);
+                TS_ASSERT(presentationTimeStamp > previousPresentationTimeStamp);
+                previousPresentationTimeStamp = presentationTimeStamp;
+                frames++;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        TS_ASSERT(frames == 20);
+        TS_ASSERT(videoCapture.getDecodedFrames() == 20);
+        TS_ASSERT(si.getName() == "camera-replay-test");
+        // 25 frames per second.
+        TS_ASSERT_DELTA(presentationTimeStamp, 19 * 40000, 1000);
+        // Nothing is late after the end of the file.
+        const uint64_t lateFrames = videoCapture.getLateFrames();
+        TS_ASSERT(!videoCapture.capture(si, number, presentationTimeStamp));
+        TS_ASSERT(videoCapture.getLateFrames() == lateFrames);
+        std::remove(FILENAME.c_str());
+
+        VideoCapture missing("camera-replay-test", "missing.avi", 64, 48, false, 4);
+        TS_ASSERT(!missing.capture(si, number, presentationTimeStamp));
+        TS_ASSERT(missing.isAtEnd());
+    }
+
+    void testSegment() {
+        const std::string FILENAME = "camera-replay-segment.avi";
+        if (!writeTestVideo(FILENAME, 20)) {
+            TS_SKIP("No MJPEG video encoder available");
+            return;
+        }
+        VideoCapture::Segment empty;
+        empty.firstFrame = 5;
+        empty.endFrame = 5;
+        TS_ASSERT_THROWS(VideoCapture("camera-replay-test", FILENAME, 64, 48, false, 4, empty), std::invalid_argument);
+
+        // Frames 5 to 7, twice.
+        VideoCapture::Segment segment;
+        segment.firstFrame = 5;
+        segment.endFrame = 8;
+        segment.loop = true;
+        VideoCapture videoCapture("camera-replay-test", FILENAME, 64, 48, false, 4, segment);
+        odcore::data::image::SharedImage si;
+        std::vector<uint64_t> numbers;
+        for (uint32_t i = 0; (i < 1000) && (numbers.size() < 6); i++) {
+            uint64_t number = 0;
+            int64_t presentationTimeStamp = 0;
+            if (videoCapture.capture(si, number, presentationTimeStamp)) {
+                numbers.push_back(number);
+                TS_ASSERT_DELTA(presentationTimeStamp, static_cast<int64_t>(number * 40000), 1000);
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+        const uint64_t EXPECTED[] = {5, 6, 7, 5, 6, 7};
+        TS_ASSERT(numbers == std::vector<uint64_t>(EXPECTED, EXPECTED + 6));
+        TS_ASSERT(!videoCapture.isAtEnd());
+        std::remove(FILENAME.c_str());
+    }
+
+    void testGeometry() {
+        const std::string FILENAME = "camera-replay-geometry.avi";
+        if (!writeTestVideo(FILENAME, 4)) {
+            TS_SKIP("No MJPEG video encoder available");
+            return;
+        }
+        odcore::data::image::SharedImage si;
+        uint64_t number = 0;
+        int64_t presentationTimeStamp = 0;
+
+        // The geometry of the stream is used by default.
+        {
+            VideoCapture videoCapture("camera-replay-test", FILENAME, 0, 0, false, 4);
+            TS_ASSERT(videoCapture.getWidth() == 64);
+            TS_ASSERT(videoCapture.getHeight() == 48);
+            for (uint32_t i = 0; (i < 1000) && !videoCapture.capture(si, number, presentationTimeStamp); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            TS_ASSERT(si.getWidth() == 64);
+            TS_ASSERT(si.getHeight() == 48);
+            TS_ASSERT(si.getSize() == 64 * 48 * 3);
+            TS_ASSERT(videoCapture.getMismatchedFrames() == 0);
+        }
+
+        // Other geometries are resized into the shared memory.
+        {
+            VideoCapture videoCapture("camera-replay-test", FILENAME, 32, 24, false, 4);
+            bool captured = false;
+            for (uint32_t i = 0; (i < 1000) && !(captured = videoCapture.capture(si, number, presentationTimeStamp)); i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            TS_ASSERT(captured);
+            TS_ASSERT(si.getSize() == 32 * 24 * 3);
+            TS_ASSERT(videoCapture.getMismatchedFrames() == 1);
+            TS_ASSERT(videoCapture.getRejectedFrames() == 0);
+        }
+        std::remove(FILENAME.c_str());
+    }
+
+    void testFrameIndex() {
+        const std::string FILENAME = "camera-replay-index.avi";
+        if (!writeTestVideo(FILENAME, 20)) {
+            TS_SKIP("No MJPEG video encoder available");
+            return;
+        }
+        std::remove(FrameIndex::getIndexFilename(FILENAME).c_str());
+
+        FrameIndex index;
+        TS_ASSERT(!index.load(FILENAME));
+        TS_ASSERT(index.build(FILENAME));
+        TS_ASSERT(index.getNumberOfFrames() == 20);
+        TS_ASSERT_DELTA(index.getPresentationTimeStamp(10), 400000, 1000);
+        TS_ASSERT(index.findFrame(0) == 0);
+        TS_ASSERT(index.findFrame(390000) == 10);
+        TS_ASSERT(index.findFrame(10000000) == 20);
+
+        // The cached index is used on the next open.
+        FrameIndex cached;
+        TS_ASSERT(cached.load(FILENAME));
+        TS_ASSERT(cached.getNumberOfFrames() == 20);
+        TS_ASSERT(cached.getPresentationTimeStamp(19) == index.getPresentationTimeStamp(19));
+
+        // A changed video file invalidates the index.
+        TS_ASSERT(writeTestVideo(FILENAME, 10));
+        FrameIndex stale;
+        TS_ASSERT(!stale.load(FILENAME));
+
+        FrameIndex missing;
+        TS_ASSERT(!missing.build("missing.avi"));
+
+        std::remove(FrameIndex::getIndexFilename(FILENAME).c_str());
+        std::remove(FILENAME.c_str());
+    }
+
+    void testReplayClock() {
+        TS_ASSERT_THROWS(ReplayClock(-1, 0, ""), std::invalid_argument);
+        TS_ASSERT_THROWS(ReplayClock(1, 0, "missing.txt"), std::invalid_argument);
+
+        // Capture times from the presentation time stamps.
+        ReplayClock clock(2, 1000000000, "");
+        TS_ASSERT(!clock.isAsFastAsPossible());
+        TS_ASSERT(clock.getCaptureTime(0, 0) == 1000000000);
+        TS_ASSERT(clock.getCaptureTime(1, 40000) == 1000040000);
+
+        // Twice as fast as real time.
+        const std::chrono::steady_clock::time_point first = clock.getDueTime(1000000000);
+        TS_ASSERT(clock.getDueTime(1000040000) - first == std::chrono::microseconds(20000));
+        TS_ASSERT(clock.getDueTime(999000000) == first);
+
+        ReplayClock fastest(0, 0, "");
+        TS_ASSERT(fastest.isAsFastAsPossible());
+        TS_ASSERT(fastest.getDueTime(0) == fastest.getDueTime(1000000));
+
+        // Capture times from a sidecar file.
+        const std::string FILENAME = "camera-replay-timestamps.txt";
+        {
+            std::ofstream out(FILENAME.c_str());
+            out << "# Capture times" << std::endl
+                << "1500000000000000" << std::endl
+                << std::endl
+                << "1500000000033000" << std::endl;
+        }
+        ReplayClock sidecar(1, 0, FILENAME);
+        TS_ASSERT(sidecar.getNumberOfTimeStamps() == 2);
+        TS_ASSERT(sidecar.getCaptureTime(0, 0) == 1500000000000000);
+        TS_ASSERT(sidecar.getCaptureTime(1, 40000) == 1500000000033000);
+        // Frames beyond the sidecar file are placed by their presentation time stamp.
+        TS_ASSERT(sidecar.getCaptureTime(2, 80000) == 1500000000080000);
+
+        {
+            std::ofstream out(FILENAME.c_str());
+            out << "1500000000000000" << std::endl
+                << "15000000000x" << std::endl;
+        }
+        TS_ASSERT_THROWS(ReplayClock(1, 0, FILENAME), std::invalid_argument);
+        std::remove(FILENAME.c_str());
+    }
 };
 
 #endif